@@ -0,0 +1,71 @@
+/**
+ * Libhexapod
+ * Hexapod Batch Benchmarks
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <math.h>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/batch.h"
+
+// Fill SoA target arrays with a spread of reachable leg positions
+static void fill_targets(struct hexapod_s* hexy, int count,
+                         std::vector<float>& x, std::vector<float>& y, std::vector<float>& z)
+{
+    x.resize(count); y.resize(count); z.resize(count);
+    for (int i = 0; i < count; i++) {
+        x[i] = hexy->config.offset_a + hexy->config.len_bc + hexy->config.len_ab / 2 * sinf(i * 0.1f);
+        y[i] = hexy->config.length / 4 * cosf(i * 0.07f);
+        z[i] = -hexy->config.len_bc / 4 * sinf(i * 0.13f);
+    }
+}
+
+static void BM_leg_ik3_scalar(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    int count = state.range(0);
+    std::vector<float> x, y, z;
+    fill_targets(&hexy, count, x, y, z);
+    std::vector<float> alpha(count), beta(count), theta(count);
+
+    for (auto _ : state) {
+        for (int i = 0; i < count; i++) {
+            struct hpod_vector3_s pos = {x[i], y[i], z[i]};
+            HPOD_leg_ik3(&hexy, &pos, &alpha[i], &beta[i], &theta[i]);
+        }
+        benchmark::DoNotOptimize(alpha.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_leg_ik3_scalar)->Arg(6)->Arg(6 * 1024);
+
+static void BM_leg_ik3_batch(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    int count = state.range(0);
+    std::vector<float> x, y, z;
+    fill_targets(&hexy, count, x, y, z);
+    std::vector<float> alpha(count), beta(count), theta(count);
+    std::vector<uint8_t> valid(count);
+
+    for (auto _ : state) {
+        HPOD_leg_ik3_batch(&hexy, count, x.data(), y.data(), z.data(),
+                           alpha.data(), beta.data(), theta.data(), valid.data());
+        benchmark::DoNotOptimize(alpha.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_leg_ik3_batch)->Arg(6)->Arg(6 * 1024);
+
@@ -0,0 +1,233 @@
+/**
+ * Libhexapod
+ * Hexapod Core Benchmarks
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#else
+#define BENCH_CYCLES() 0
+#endif
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+#include "hexapod/jacobian.h"
+#include "hexapod/servo.h"
+#include "hexapod/pipeline.h"
+
+static void BM_output_mix(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    float outputs[6][3];
+    float phase = -1.0;
+
+    uint64_t start = BENCH_CYCLES();
+    for (auto _ : state) {
+        HPOD_output_mix(&hexy, &gait, &movement, phase, outputs);
+        benchmark::DoNotOptimize(outputs);
+
+        phase += 0.01f;
+        if (phase > 1.0f) {
+            phase = -1.0f;
+        }
+    }
+    uint64_t cycles = BENCH_CYCLES() - start;
+
+    // TSC cycles per call, zero where no cycle counter is available
+    state.counters["cycles"] = (double) cycles / state.iterations();
+#ifdef HPOD_FLOAT_ONLY
+    state.SetLabel("float-only");
+#endif
+}
+BENCHMARK(BM_output_mix);
+
+
+// Hand stitched gait -> body transform -> IK -> servo chain, as callers did before HPOD_pipeline
+static void BM_pipeline_manual(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    struct hpod_servo_s servo;
+    HPOD_init(&hexy, &config);
+    HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_body_pose_s pose = {{0.0f, 0.0f, 10.0f}, 0.05f, -0.05f, 0.0f};
+    struct hpod_body_transform_s transform;
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    float angles[6][3];
+    int out[6][3];
+    float phase = -1.0;
+
+    for (auto _ : state) {
+        struct hpod_vector3_s feet[6];
+        for (int i = 0; i < 6; i++) {
+            HPOD_gait_calc_leg(&hexy, &gait, &movement, HPOD_gait_pattern_phase(&gait.pattern, phase, i), i, &feet[i]);
+        }
+        HPOD_body_pose_init(&transform, &pose);
+        HPOD_body_pose_apply(&hexy, &transform, feet, feet);
+        for (int i = 0; i < 6; i++) {
+            HPOD_leg_ik3(&hexy, &feet[i], &angles[i][0], &angles[i][1], &angles[i][2]);
+        }
+        HPOD_servo_mix(&servo, hexy.legs, angles, out);
+        benchmark::DoNotOptimize(out);
+
+        phase += 0.01f;
+        if (phase > 1.0f) {
+            phase = -1.0f;
+        }
+    }
+}
+BENCHMARK(BM_pipeline_manual);
+
+static void BM_pipeline(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    struct hpod_servo_s servo;
+    HPOD_init(&hexy, &config);
+    HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_body_pose_s pose = {{0.0f, 0.0f, 10.0f}, 0.05f, -0.05f, 0.0f};
+    struct hpod_body_transform_s transform;
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    struct hpod_pipeline_scratch_s scratch;
+    int out[6][3];
+    float phase = -1.0;
+
+    HPOD_body_pose_init(&transform, &pose);
+
+    for (auto _ : state) {
+        HPOD_pipeline(&hexy, &gait, &servo, &transform, &movement, phase, &scratch, out);
+        benchmark::DoNotOptimize(out);
+
+        phase += 0.01f;
+        if (phase > 1.0f) {
+            phase = -1.0f;
+        }
+    }
+}
+BENCHMARK(BM_pipeline);
+
+static void BM_leg_ik3(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_vector3_s pos = {hexy.config.offset_a + hexy.config.len_bc, -20.0f, -30.0f};
+    float alpha, beta, theta;
+
+    for (auto _ : state) {
+        HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta);
+        benchmark::DoNotOptimize(alpha);
+        pos.y += 0.01f;
+        if (pos.y > 20.0f) {
+            pos.y = -20.0f;
+        }
+    }
+}
+BENCHMARK(BM_leg_ik3);
+
+static void BM_leg_ik3_velocity(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_vector3_s velocity = {0.0f, 10.0f, 0.0f};
+    float alpha = 0.1f, beta = 1.8f, theta = -0.2f;
+    float d_alpha, d_beta, d_theta;
+
+    for (auto _ : state) {
+        HPOD_leg_ik3_velocity(&hexy, alpha, beta, theta, &velocity, HPOD_JACOBIAN_DEFAULT_DAMPING,
+                              &d_alpha, &d_beta, &d_theta);
+        benchmark::DoNotOptimize(d_alpha);
+        theta += d_theta * 0.001f;
+        if (theta > 0.2f) {
+            theta = -0.2f;
+        }
+    }
+}
+BENCHMARK(BM_leg_ik3_velocity);
+
+#define GAIT_TICKS      1000
+
+// Foot targets for one gait period at 1kHz with a 1s period
+// With worst set, every second target is rotated by 90 degrees so warm starts cannot converge
+static void fill_gait_targets(struct hexapod_s* hexy, int worst, struct hpod_vector3_s targets[GAIT_TICKS])
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.0f, 1.0f, 0.0f};
+
+    for (int i = 0; i < GAIT_TICKS; i++) {
+        HPOD_gait_calc(hexy, &gait, &movement, -1.0f + 2.0f * i / GAIT_TICKS, &targets[i]);
+        if (worst && (i % 2)) {
+            float x = targets[i].x;
+            targets[i].x = -targets[i].y;
+            targets[i].y = x;
+        }
+    }
+}
+
+static void BM_leg_ik3_gait(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_vector3_s targets[GAIT_TICKS];
+    fill_gait_targets(&hexy, 0, targets);
+    float alpha, beta, theta;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_leg_ik3(&hexy, &targets[i], &alpha, &beta, &theta);
+        benchmark::DoNotOptimize(alpha);
+        i = (i + 1) % GAIT_TICKS;
+    }
+}
+BENCHMARK(BM_leg_ik3_gait);
+
+// Warm started IK along a gait trajectory
+// Arg(0) tracks the gait, Arg(1) alternates distant targets to force the worst case path
+static void BM_leg_ik3_warm(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_ik_context_s ctx;
+    HPOD_ik_context_init(&ctx, HPOD_IK_DEFAULT_ITERATIONS, HPOD_IK_DEFAULT_TOLERANCE);
+
+    struct hpod_vector3_s targets[GAIT_TICKS];
+    fill_gait_targets(&hexy, state.range(0), targets);
+    float alpha, beta, theta;
+    uint64_t iterations = 0;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_leg_ik3_warm(&hexy, &ctx, &targets[i], &alpha, &beta, &theta);
+        benchmark::DoNotOptimize(alpha);
+        iterations += ctx.iterations;
+        i = (i + 1) % GAIT_TICKS;
+    }
+
+    state.counters["newton_steps"] = (double) iterations / state.iterations();
+    state.counters["fallback_rate"] = (double) ctx.fallbacks / ctx.solves;
+}
+BENCHMARK(BM_leg_ik3_warm)->Arg(0)->Arg(1);
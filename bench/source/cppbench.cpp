@@ -0,0 +1,110 @@
+/**
+ * Libhexapod
+ * Hexapod C++ API Benchmarks
+ * Each C++ benchmark has a C counterpart over the same inputs, for comparison.
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/hexapod.hpp"
+
+#define CPP_BENCH_STEP      0.0137f
+
+static void BM_c_leg_ik3(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_vector3_s target = {150.0f, -50.0f, -90.0f};
+    float alpha, beta, theta;
+
+    for (auto _ : state) {
+        HPOD_leg_ik3(&hexy, &target, &alpha, &beta, &theta);
+        benchmark::DoNotOptimize(alpha);
+        benchmark::DoNotOptimize(beta);
+        benchmark::DoNotOptimize(theta);
+
+        target.y += 1.0f;
+        if (target.y > 50.0f) {
+            target.y = -50.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_c_leg_ik3);
+
+template <typename T>
+static void BM_cpp_leg_ik3(benchmark::State& state)
+{
+    hpod::Hexapod<T> hexy;
+    hpod::Vec3<T> target = {T(150.0f), T(-50.0f), T(-90.0f)};
+
+    for (auto _ : state) {
+        auto angles = hexy.ik(target);
+        benchmark::DoNotOptimize(angles);
+
+        target.y = target.y + T(1.0f);
+        if (target.y > T(50.0f)) {
+            target.y = T(-50.0f);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_cpp_leg_ik3, float);
+BENCHMARK_TEMPLATE(BM_cpp_leg_ik3, double);
+BENCHMARK_TEMPLATE(BM_cpp_leg_ik3, hpod::Q16);
+
+static void BM_c_output_mix(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.5};
+    float outputs[6][3];
+    float phase = -1.0f;
+
+    for (auto _ : state) {
+        HPOD_output_mix(&hexy, &gait, &movement, phase, outputs);
+        benchmark::DoNotOptimize(outputs);
+
+        phase += CPP_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_c_output_mix);
+
+template <typename T>
+static void BM_cpp_output(benchmark::State& state)
+{
+    struct hpod_gait_s c_gait = HPOD_DEFAULT_GAIT;
+    hpod::Hexapod<T> hexy;
+    hpod::Gait<T> gait = hpod::Gait<T>::from(c_gait);
+    hpod::Vec3<T> movement = {T(0.5f), T(1.0f), T(0.5f)};
+    T phase = T(-1.0f);
+
+    for (auto _ : state) {
+        auto outputs = hexy.output(gait, movement, phase);
+        benchmark::DoNotOptimize(outputs);
+
+        phase = phase + T(CPP_BENCH_STEP);
+        if (phase >= T(1.0f)) {
+            phase = phase - T(2.0f);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK_TEMPLATE(BM_cpp_output, float);
+BENCHMARK_TEMPLATE(BM_cpp_output, double);
+BENCHMARK_TEMPLATE(BM_cpp_output, hpod::Q16);
@@ -0,0 +1,193 @@
+/**
+ * Libhexapod
+ * Hexapod Fixed Point Benchmarks
+ * Compares the fixed point backend with the floating point implementation
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <math.h>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/servo.h"
+#include "hexapod/fixed.h"
+
+#define TARGET_COUNT    1024
+
+// Fill a set of reachable leg positions
+static void fill_targets(struct hexapod_s* hexy, std::vector<struct hpod_vector3_s>& pos)
+{
+    pos.resize(TARGET_COUNT);
+    for (int i = 0; i < TARGET_COUNT; i++) {
+        pos[i].x = hexy->config.offset_a + hexy->config.len_bc + hexy->config.len_ab / 2 * sinf(i * 0.1f);
+        pos[i].y = hexy->config.length / 4 * cosf(i * 0.07f);
+        pos[i].z = -hexy->config.len_bc / 4 * sinf(i * 0.13f);
+    }
+}
+
+static void fill_fx_targets(std::vector<struct hpod_vector3_s>& pos, std::vector<struct hpod_fx_vector3_s>& fx_pos)
+{
+    fx_pos.resize(pos.size());
+    for (size_t i = 0; i < pos.size(); i++) {
+        fx_pos[i].x = HPOD_Q16_FROM_FLOAT(pos[i].x);
+        fx_pos[i].y = HPOD_Q16_FROM_FLOAT(pos[i].y);
+        fx_pos[i].z = HPOD_Q16_FROM_FLOAT(pos[i].z);
+    }
+}
+
+static void BM_leg_ik3_float(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    std::vector<struct hpod_vector3_s> pos;
+    fill_targets(&hexy, pos);
+    float alpha, beta, theta;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            HPOD_leg_ik3(&hexy, &pos[i], &alpha, &beta, &theta);
+            benchmark::DoNotOptimize(alpha);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_leg_ik3_float);
+
+static void BM_leg_ik3_fixed(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    struct hpod_fx_s fx;
+    HPOD_init(&hexy, &config);
+    HPOD_fx_init(&fx, &config);
+
+    std::vector<struct hpod_vector3_s> pos;
+    std::vector<struct hpod_fx_vector3_s> fx_pos;
+    fill_targets(&hexy, pos);
+    fill_fx_targets(pos, fx_pos);
+    hpod_q16_t alpha, beta, theta;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            HPOD_fx_leg_ik3(&fx, &fx_pos[i], &alpha, &beta, &theta);
+            benchmark::DoNotOptimize(alpha);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_leg_ik3_fixed);
+
+static void BM_leg_fk3_float(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+    struct hpod_vector3_s pos;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            float a = (i - TARGET_COUNT / 2) * 0.001f;
+            HPOD_leg_fk3(&hexy, a, M_PI / 2 + a, a, &pos);
+            benchmark::DoNotOptimize(pos);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_leg_fk3_float);
+
+static void BM_leg_fk3_fixed(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hpod_fx_s fx;
+    HPOD_fx_init(&fx, &config);
+    struct hpod_fx_vector3_s pos;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            hpod_q16_t a = (i - TARGET_COUNT / 2) * 66;
+            HPOD_fx_leg_fk3(&fx, a, HPOD_Q16_PI / 2 + a, a, &pos);
+            benchmark::DoNotOptimize(pos);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_leg_fk3_fixed);
+
+static void BM_leg_ik3_servo_float(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    struct hpod_servo_s servo;
+    HPOD_init(&hexy, &config);
+    HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+
+    std::vector<struct hpod_vector3_s> pos;
+    fill_targets(&hexy, pos);
+    float angles[3];
+    int out[3];
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            HPOD_leg_ik3(&hexy, &pos[i], &angles[0], &angles[1], &angles[2]);
+            for (int j = 0; j < 3; j++) {
+                out[j] = HPOD_servo_scale(&servo, angles[j]);
+            }
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_leg_ik3_servo_float);
+
+static void BM_leg_ik3_servo_fixed(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    struct hpod_fx_s fx;
+    struct hpod_servo_s servo;
+    struct hpod_fx_servo_s fx_servo;
+    HPOD_init(&hexy, &config);
+    HPOD_fx_init(&fx, &config);
+    HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+    HPOD_fx_servo_init(&fx_servo, &servo);
+
+    std::vector<struct hpod_vector3_s> pos;
+    std::vector<struct hpod_fx_vector3_s> fx_pos;
+    fill_targets(&hexy, pos);
+    fill_fx_targets(pos, fx_pos);
+    int out[3];
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            HPOD_fx_leg_ik3_servo(&fx, &fx_servo, &fx_pos[i], out);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_leg_ik3_servo_fixed);
+
+static void BM_gait_calc_fixed(benchmark::State& state)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_fx_gait_s fx_gait;
+    HPOD_fx_gait_init(&fx_gait, &gait);
+    struct hpod_fx_vector3_s movement = {HPOD_Q16_HALF, HPOD_Q16_ONE, 0};
+    struct hpod_fx_vector3_s pos;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            HPOD_fx_gait_calc(&fx_gait, &movement, (i - TARGET_COUNT / 2) * 128, &pos);
+            benchmark::DoNotOptimize(pos);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * TARGET_COUNT);
+}
+BENCHMARK(BM_gait_calc_fixed);
+
@@ -0,0 +1,48 @@
+/**
+ * Libhexapod
+ * Hexapod Gait Search Benchmarks
+ * Thread scaling of the parallel gait search, from one thread to one per CPU
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <thread>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_search.h"
+
+static void BM_gait_search(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_gait_grid_s grid = {gait, gait, {10, 10, 1, 4, 1, 6, 1}};
+    grid.min.movement.x = 50;   grid.max.movement.x = 250;
+    grid.min.movement.y = 100;  grid.max.movement.y = 400;
+    grid.min.offset.x = 120;    grid.max.offset.x = 180;
+    grid.min.offset.z = -120;   grid.max.offset.z = -20;
+
+    struct hpod_vector3_s movements[2] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}};
+    struct hpod_gait_search_s search = {&hexy, &grid, NULL, movements, 2, 100, (int) state.range(0), 0};
+    int size = HPOD_gait_grid_size(&grid);
+    std::vector<struct hpod_gait_check_s> results(size);
+    int feasible = 0;
+
+    for (auto _ : state) {
+        feasible = HPOD_gait_search(&search, results.data());
+        benchmark::DoNotOptimize(results.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * size);
+    state.counters["feasible"] = feasible;
+    state.counters["steals"] = search.steals;
+}
+BENCHMARK(BM_gait_search)->RangeMultiplier(2)->Range(1, std::thread::hardware_concurrency())
+                         ->UseRealTime()->Unit(benchmark::kMillisecond);
+
@@ -0,0 +1,228 @@
+/**
+ * Libhexapod
+ * Hexapod Gait Table Benchmarks
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <math.h>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+#include "hexapod/gait_pattern.hpp"
+#include "hexapod/gait_table.h"
+#include "hexapod/gait_blend.h"
+
+#define GAIT_BENCH_STEP     0.0137f
+
+static void BM_gait_calc(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+    struct hpod_vector3_s pos;
+    float phase = -1.0f;
+
+    for (auto _ : state) {
+        HPOD_gait_calc(&hexy, &gait, &movement, phase, &pos);
+        benchmark::DoNotOptimize(pos);
+
+        phase += GAIT_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gait_calc);
+
+// Walking an arc, rotating each leg about the body center
+static void BM_gait_calc_leg(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.5};
+    struct hpod_vector3_s pos;
+    float phase = -1.0f;
+    int leg = 0;
+
+    for (auto _ : state) {
+        HPOD_gait_calc_leg(&hexy, &gait, &movement, phase, leg, &pos);
+        benchmark::DoNotOptimize(pos);
+
+        leg = (leg + 1) % 6;
+        phase += GAIT_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gait_calc_leg);
+
+// Leg phases for all six legs from the runtime pattern table
+static void BM_gait_pattern_phase(benchmark::State& state)
+{
+    const struct hpod_gait_pattern_s* pattern = &hpod_gait_patterns[HPOD_PATTERN_RIPPLE];
+    float phases[6];
+    float phase = -1.0f;
+
+    for (auto _ : state) {
+        for (int i = 0; i < 6; i++) {
+            phases[i] = HPOD_gait_pattern_phase(pattern, phase, i);
+        }
+        benchmark::DoNotOptimize(phases);
+
+        phase += GAIT_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_gait_pattern_phase);
+
+// Leg phases for all six legs from the compile time schedule
+static void BM_gait_pattern_phase_constexpr(benchmark::State& state)
+{
+    std::array<float, 6> phases;
+    float phase = -1.0f;
+
+    for (auto _ : state) {
+        phases = hpod::Ripple::phases(phase);
+        benchmark::DoNotOptimize(phases);
+
+        phase += GAIT_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_gait_pattern_phase_constexpr);
+
+// Args: slices, interpolation mode
+static void BM_gait_table_calc(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+    int slices = state.range(0);
+    enum hpod_interp_e interp = (enum hpod_interp_e) state.range(1);
+
+    std::vector<struct hpod_gait_slice_s> shape(slices);
+    struct hpod_gait_table_s table;
+    HPOD_gait_table_init(&table, &hexy, &gait, &movement, slices, shape.data(), NULL);
+
+    struct hpod_vector3_s pos;
+    float phase = -1.0f;
+
+    for (auto _ : state) {
+        HPOD_gait_table_calc(&table, phase, interp, &pos);
+        benchmark::DoNotOptimize(pos);
+
+        phase += GAIT_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    // Accuracy against the analytic gait
+    float error = 0;
+    for (int i = 0; i < 10000; i++) {
+        struct hpod_vector3_s expected;
+        float p = -1.0f + 2.0f * i / 10000;
+
+        HPOD_gait_calc(&hexy, &gait, &movement, p, &expected);
+        HPOD_gait_table_calc(&table, p, interp, &pos);
+
+        error = fmaxf(error, fabsf(expected.x - pos.x));
+        error = fmaxf(error, fabsf(expected.y - pos.y));
+        error = fmaxf(error, fabsf(expected.z - pos.z));
+    }
+    state.counters["max_error"] = error;
+}
+BENCHMARK(BM_gait_table_calc)
+    ->ArgsProduct({{64, 256, 1024}, {HPOD_INTERP_LINEAR, HPOD_INTERP_CUBIC}});
+
+static void BM_gait_table_set_movement(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+    int slices = state.range(0);
+
+    std::vector<struct hpod_gait_slice_s> shape(slices);
+    std::vector<struct hpod_gait_angles_s> angles(slices);
+    struct hpod_gait_table_s table;
+    HPOD_gait_table_init(&table, &hexy, &gait, &movement, slices, shape.data(),
+                         state.range(1) ? angles.data() : NULL);
+
+    for (auto _ : state) {
+        movement.y = -movement.y;
+        benchmark::DoNotOptimize(HPOD_gait_table_set_movement(&table, &movement));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gait_table_set_movement)->ArgsProduct({{256}, {0, 1}});
+
+
+// Args: blending (0 steady, 1 mid transition)
+static void BM_gait_blend_calc(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s forward = {0.0, 1.0, 0.0};
+    struct hpod_vector3_s sideways = {1.0, 0.0, 0.0};
+
+    std::vector<struct hpod_gait_slice_s> shape_a(64), shape_b(64);
+    struct hpod_gait_table_s table_a, table_b;
+    HPOD_gait_table_init(&table_a, &hexy, &gait, &forward, 64, shape_a.data(), NULL);
+    HPOD_gait_table_init(&table_b, &hexy, &gait, &sideways, 64, shape_b.data(), NULL);
+
+    // Long transition so the blend stays active for the whole benchmark
+    struct hpod_gait_blend_s blend;
+    HPOD_gait_blend_init(&blend, &table_a, -1.0f);
+    if (state.range(0)) {
+        HPOD_gait_blend_start(&blend, &table_b, 1e9f);
+    }
+
+    struct hpod_vector3_s pos;
+    float phase = -1.0f;
+
+    for (auto _ : state) {
+        HPOD_gait_blend_update(&blend, phase);
+        for (int i = 0; i < 6; i++) {
+            float leg_phase = HPOD_gait_pattern_phase(&gait.pattern, phase, i);
+            HPOD_gait_blend_calc(&blend, leg_phase, HPOD_INTERP_LINEAR, &pos);
+            benchmark::DoNotOptimize(pos);
+        }
+
+        phase += GAIT_BENCH_STEP;
+        if (phase >= 1.0f) {
+            phase -= 2.0f;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_gait_blend_calc)->Arg(0)->Arg(1);
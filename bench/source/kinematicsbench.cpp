@@ -0,0 +1,307 @@
+/**
+ * Libhexapod
+ * Hexapod Kinematics Benchmarks
+ * Microbenchmarks for each public core function, with sweep (Arg 0) and randomised (Arg 1)
+ * inputs. Random inputs use a fixed seed so results are comparable between runs.
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/body_pose.h"
+#include "hexapod/servo.h"
+#include "hexapod/servo_frame.h"
+
+#define INPUT_COUNT     1024
+#define INPUT_SEED      1337
+
+enum input_mode_e {
+    INPUT_SWEEP = 0,
+    INPUT_RANDOM = 1,
+};
+
+/**
+ * Input generator, returns values in min..max either as an even sweep or uniformly random
+ */
+static std::vector<float> make_inputs(int mode, float min, float max, unsigned int seed = INPUT_SEED)
+{
+    std::vector<float> v(INPUT_COUNT);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(min, max);
+
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        v[i] = (mode == INPUT_SWEEP) ? min + (max - min) * i / (INPUT_COUNT - 1) : dist(rng);
+    }
+
+    return v;
+}
+
+static void set_label(benchmark::State& state)
+{
+    state.SetLabel(state.range(0) == INPUT_SWEEP ? "sweep" : "random");
+}
+
+class KinematicsBench : public benchmark::Fixture
+{
+public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+        HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_servo_s servo;
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+};
+
+BENCHMARK_DEFINE_F(KinematicsBench, leg_ik2)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> d = make_inputs(mode, hexy.config.len_bc - hexy.config.len_ab / 2,
+                                       hexy.config.len_bc + hexy.config.len_ab / 2);
+    std::vector<float> h = make_inputs(mode, -hexy.config.len_ab / 2, hexy.config.len_ab / 2, INPUT_SEED + 1);
+    float alpha, beta;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_leg_ik2(&hexy, d[i], h[i], &alpha, &beta);
+        benchmark::DoNotOptimize(alpha);
+        benchmark::DoNotOptimize(beta);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, leg_ik2)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, leg_ik3)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> x = make_inputs(mode, hexy.config.offset_a + hexy.config.len_bc - hexy.config.len_ab / 2,
+                                       hexy.config.offset_a + hexy.config.len_bc + hexy.config.len_ab / 2);
+    std::vector<float> y = make_inputs(mode, -hexy.config.length / 4, hexy.config.length / 4, INPUT_SEED + 1);
+    std::vector<float> z = make_inputs(mode, -hexy.config.len_ab / 2, hexy.config.len_ab / 2, INPUT_SEED + 2);
+    float alpha, beta, theta;
+    int i = 0;
+
+    for (auto _ : state) {
+        struct hpod_vector3_s pos = {x[i], y[i], z[i]};
+        HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta);
+        benchmark::DoNotOptimize(alpha);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, leg_ik3)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, leg_fk2)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> alpha = make_inputs(mode, -M_PI / 4, M_PI / 4);
+    std::vector<float> beta = make_inputs(mode, M_PI / 4, 3 * M_PI / 4, INPUT_SEED + 1);
+    float x, h;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_leg_fk2(&hexy, alpha[i], beta[i], &x, &h);
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(h);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, leg_fk2)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, leg_fk3)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> alpha = make_inputs(mode, -M_PI / 4, M_PI / 4);
+    std::vector<float> beta = make_inputs(mode, M_PI / 4, 3 * M_PI / 4, INPUT_SEED + 1);
+    std::vector<float> theta = make_inputs(mode, -M_PI / 4, M_PI / 4, INPUT_SEED + 2);
+    struct hpod_vector3_s pos;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_leg_fk3(&hexy, alpha[i], beta[i], theta[i], &pos);
+        benchmark::DoNotOptimize(pos);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, leg_fk3)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, body_transform)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> roll = make_inputs(mode, -M_PI / 8, M_PI / 8);
+    std::vector<float> pitch = make_inputs(mode, -M_PI / 8, M_PI / 8, INPUT_SEED + 1);
+    struct hpod_vector3_s world = {hexy.config.offset_a + hexy.config.len_bc, 10.0f, -70.0f};
+    struct hpod_vector3_s joint;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_body_transform(&hexy, roll[i], pitch[i], hexy.config.width / 2, hexy.config.length / 2,
+                            &world, &joint);
+        benchmark::DoNotOptimize(joint);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, body_transform)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+// Full pose for all six legs per iteration, items are legs for comparison with body_transform
+BENCHMARK_DEFINE_F(KinematicsBench, body_pose)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> roll = make_inputs(mode, -M_PI / 8, M_PI / 8);
+    std::vector<float> pitch = make_inputs(mode, -M_PI / 8, M_PI / 8, INPUT_SEED + 1);
+    std::vector<float> yaw = make_inputs(mode, -M_PI / 8, M_PI / 8, INPUT_SEED + 2);
+    struct hpod_vector3_s feet[6], joints[6];
+    struct hpod_body_transform_s transform;
+    int i = 0;
+
+    for (int j = 0; j < 6; j++) {
+        feet[j] = {hexy.config.offset_a + hexy.config.len_bc, 10.0f, -70.0f};
+    }
+
+    for (auto _ : state) {
+        struct hpod_body_pose_s pose = {{0.0f, 0.0f, 10.0f}, roll[i], pitch[i], yaw[i]};
+        HPOD_body_pose_init(&transform, &pose);
+        HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+        benchmark::DoNotOptimize(joints);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations() * 6);
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, body_pose)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, gait_calc)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> phase = make_inputs(mode, -1.0f, 1.0f);
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+    struct hpod_vector3_s pos;
+    int i = 0;
+
+    for (auto _ : state) {
+        HPOD_gait_calc(&hexy, &gait, &movement, phase[i], &pos);
+        benchmark::DoNotOptimize(pos);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, gait_calc)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, gait_valid)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> height = make_inputs(mode, 10.0f, 40.0f);
+    struct hpod_gait_s g = gait;
+    int i = 0;
+
+    for (auto _ : state) {
+        g.movement.z = height[i];
+        int res = HPOD_gait_valid(&hexy, &g);
+        benchmark::DoNotOptimize(res);
+        i = (i + 1) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, gait_valid)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, servo_mix)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> angles = make_inputs(mode, -M_PI, M_PI);
+    float in[6][3];
+    int out[6][3];
+    int i = 0;
+
+    for (auto _ : state) {
+        for (int j = 0; j < 6; j++) {
+            for (int k = 0; k < 3; k++) {
+                in[j][k] = angles[(i + j * 3 + k) % INPUT_COUNT];
+            }
+        }
+        HPOD_servo_mix(&servo, 6, in, out);
+        benchmark::DoNotOptimize(out);
+        i = (i + 18) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, servo_mix)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, servo_table_mix)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> angles = make_inputs(mode, -M_PI, M_PI);
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, 6);
+    float in[6][3];
+    int out[6][3];
+    HPOD_servo_table_center(&table, out);
+    int i = 0;
+
+    for (auto _ : state) {
+        for (int j = 0; j < 6; j++) {
+            for (int k = 0; k < 3; k++) {
+                in[j][k] = angles[(i + j * 3 + k) % INPUT_COUNT];
+            }
+        }
+        HPOD_servo_table_mix(&table, in, out);
+        benchmark::DoNotOptimize(out);
+        i = (i + 18) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, servo_table_mix)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
+BENCHMARK_DEFINE_F(KinematicsBench, servo_frame_dxl1)(benchmark::State& state)
+{
+    int mode = state.range(0);
+    std::vector<float> angles = make_inputs(mode, -M_PI, M_PI);
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, 6);
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+    uint8_t ids[HPOD_SERVO_CHANNELS];
+    for (int j = 0; j < HPOD_SERVO_CHANNELS; j++) {
+        ids[j] = j + 1;
+    }
+    HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, 6, ids, 512, buffer, sizeof(buffer));
+    float in[6][3];
+    int i = 0;
+
+    for (auto _ : state) {
+        for (int j = 0; j < 6; j++) {
+            for (int k = 0; k < 3; k++) {
+                in[j][k] = angles[(i + j * 3 + k) % INPUT_COUNT];
+            }
+        }
+        HPOD_servo_frame_encode_table(&frame, &table, in);
+        benchmark::DoNotOptimize(buffer);
+        i = (i + 18) % INPUT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+BENCHMARK_REGISTER_F(KinematicsBench, servo_frame_dxl1)->Arg(INPUT_SWEEP)->Arg(INPUT_RANDOM);
+
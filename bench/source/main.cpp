@@ -0,0 +1,12 @@
+/**
+ * Libhexapod
+ * Hexapod Benchmark Main
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,78 @@
+/**
+ * Libhexapod
+ * Hexapod SIMD Benchmarks
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <math.h>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/simd.h"
+
+#define SIMD_BENCH_COUNT    (6 * 1024)
+
+static void BM_leg_ik2_simd(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    enum hpod_simd_e mode = (enum hpod_simd_e) state.range(0);
+    if (!HPOD_simd_supported(mode)) {
+        state.SkipWithError("kernel not supported");
+        return;
+    }
+    HPOD_simd_select(mode);
+
+    int count = SIMD_BENCH_COUNT;
+    std::vector<float> d(count), h(count), alpha(count), beta(count);
+    for (int i = 0; i < count; i++) {
+        d[i] = hexy.config.len_bc + hexy.config.len_ab / 2 * sinf(i * 0.1f);
+        h[i] = -hexy.config.len_bc / 4 * sinf(i * 0.13f);
+    }
+
+    for (auto _ : state) {
+        HPOD_leg_ik2_simd(&hexy, count, d.data(), h.data(), alpha.data(), beta.data());
+        benchmark::DoNotOptimize(alpha.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+
+    HPOD_simd_select(HPOD_SIMD_AUTO);
+}
+BENCHMARK(BM_leg_ik2_simd)->Arg(HPOD_SIMD_SCALAR)->Arg(HPOD_SIMD_X4)->Arg(HPOD_SIMD_X8);
+
+static void BM_leg_fk2_simd(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    enum hpod_simd_e mode = (enum hpod_simd_e) state.range(0);
+    if (!HPOD_simd_supported(mode)) {
+        state.SkipWithError("kernel not supported");
+        return;
+    }
+    HPOD_simd_select(mode);
+
+    int count = SIMD_BENCH_COUNT;
+    std::vector<float> alpha(count), beta(count), x(count), h(count);
+    for (int i = 0; i < count; i++) {
+        alpha[i] = M_PI / 4 * sinf(i * 0.1f);
+        beta[i] = M_PI / 2 + M_PI / 4 * sinf(i * 0.13f);
+    }
+
+    for (auto _ : state) {
+        HPOD_leg_fk2_simd(&hexy, count, alpha.data(), beta.data(), x.data(), h.data());
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+
+    HPOD_simd_select(HPOD_SIMD_AUTO);
+}
+BENCHMARK(BM_leg_fk2_simd)->Arg(HPOD_SIMD_SCALAR)->Arg(HPOD_SIMD_X4)->Arg(HPOD_SIMD_X8);
+
@@ -0,0 +1,88 @@
+/**
+ * Libhexapod
+ * Hexapod Workspace Benchmarks
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/workspace.h"
+
+#define QUERY_COUNT     4096
+
+static void fill_queries(struct hexapod_s* hexy, std::vector<struct hpod_vector3_s>& pos)
+{
+    float reach = hexy->config.offset_a + hexy->kinematics.reach_max;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-reach, reach);
+
+    pos.resize(QUERY_COUNT);
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        pos[i].x = dist(rng);
+        pos[i].y = dist(rng);
+        pos[i].z = dist(rng);
+    }
+}
+
+static void BM_workspace_build(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+    static struct hpod_workspace_s ws;
+
+    for (auto _ : state) {
+        HPOD_workspace_build(&ws, &hexy, NULL);
+        benchmark::DoNotOptimize(ws.margin);
+    }
+}
+BENCHMARK(BM_workspace_build)->Unit(benchmark::kMillisecond);
+
+static void BM_workspace_margin(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+    static struct hpod_workspace_s ws;
+    HPOD_workspace_build(&ws, &hexy, NULL);
+
+    std::vector<struct hpod_vector3_s> pos;
+    fill_queries(&hexy, pos);
+
+    for (auto _ : state) {
+        for (int i = 0; i < QUERY_COUNT; i++) {
+            float margin = HPOD_workspace_margin(&ws, &pos[i]);
+            benchmark::DoNotOptimize(margin);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * QUERY_COUNT);
+}
+BENCHMARK(BM_workspace_margin);
+
+// Reachability from a full IK solve, for comparison
+static void BM_workspace_ik3(benchmark::State& state)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hexapod_s hexy;
+    HPOD_init(&hexy, &config);
+
+    std::vector<struct hpod_vector3_s> pos;
+    fill_queries(&hexy, pos);
+    float a, b, t;
+
+    for (auto _ : state) {
+        for (int i = 0; i < QUERY_COUNT; i++) {
+            int res = HPOD_leg_ik3(&hexy, &pos[i], &a, &b, &t);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * QUERY_COUNT);
+}
+BENCHMARK(BM_workspace_ik3);
+
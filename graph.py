@@ -10,17 +10,26 @@ import numpy
 import matplotlib.pyplot as plt
 import argparse
 
+import hexfile
+
 # Parse arguments
-parser = argparse.ArgumentParser(description='Render csv outputs from hex-util')
-parser.add_argument('--filename', default="output.csv",
+parser = argparse.ArgumentParser(description='Render column file (or csv) outputs from hex-util')
+parser.add_argument('--filename', default="output.col",
                     help='input file for graphing')
+parser.add_argument('--step', type=int, default=1,
+                    help='plot every Nth row, for large outputs')
 args = parser.parse_args()
 
 # Load files
-rawdata = numpy.genfromtxt(args.filename, delimiter=", ", dtype=None, unpack=True)
+if args.filename.endswith(".csv"):
+    rawdata = numpy.genfromtxt(args.filename, delimiter=", ", dtype=None, unpack=True)
+    names = [column[0].decode('UTF-8') for column in rawdata]
+    data = [column[1:].astype(float) for column in rawdata]
+else:
+    names, data = hexfile.load(args.filename)
 
 # Calculate layout (only works for multiples of 3N + 1)
-lines = int(len(rawdata) - 1)
+lines = int(len(names) - 1)
 cols = int(lines / 3)
 rows = int(lines / cols)
 print("Loaded {} lines for {} rows and {} columns".format(lines, rows, cols))
@@ -40,7 +49,7 @@ def add_plot(x, y, i, scale, name, data):
 for r in range(0, rows):
     for c in range(0, cols):
         i = r * cols + c;
-        add_plot(rows, cols, r + c * rows + 1, rawdata[0][1:], rawdata[i+1][0].decode('UTF-8'), rawdata[i+1][1:])
+        add_plot(rows, cols, r + c * rows + 1, data[0][::args.step], names[i+1], data[i+1][::args.step])
 
 # Render plot
 plt.show();
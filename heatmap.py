@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+# Helper to render IK / FK round trip error heatmaps from hex-util --profile
+# Shows the maximum (or mean) error binned over the leg workspace, projected onto each plane.
+#
+# https://github.com/ryankurte/libhexapod
+# Copyright 2017 Ryan Kurte
+
+import numpy
+import matplotlib.pyplot as plt
+import matplotlib.colors as colors
+import argparse
+
+import hexfile
+
+# Parse arguments
+parser = argparse.ArgumentParser(description='Render accuracy heatmaps from hex-util --profile')
+parser.add_argument('--filename', default="output.col",
+                    help='profile output file')
+parser.add_argument('--mean', action='store_true',
+                    help='show the mean rather than the maximum error per bin')
+args = parser.parse_args()
+
+names, data = hexfile.load(args.filename)
+columns = dict(zip(names, data))
+
+# Bins are written with x varying fastest, so reshape to [z, y, x]
+bins = int(round(len(data[0]) ** (1.0 / 3)))
+shape = (bins, bins, bins)
+x = columns['Bin X (left/right)'].reshape(shape)[0, 0, :]
+y = columns['Bin Y (forward/back)'].reshape(shape)[0, :, 0]
+z = columns['Bin Z (up/down)'].reshape(shape)[:, 0, 0]
+samples = columns['Samples'].reshape(shape)
+error = columns['Mean Error' if args.mean else 'Max Error'].reshape(shape)
+
+# Bins outside the reach envelope have no samples
+error = numpy.ma.masked_where(samples == 0, error)
+print("Loaded {0}x{0}x{0} bins, max error {1:.3g} mm".format(bins, error.max()))
+
+# Project onto each plane, taking the worst bin along the remaining axis
+fig = plt.figure()
+fig.canvas.set_window_title('Hexapod IK / FK Round Trip Error')
+norm = colors.LogNorm(vmin=max(error.min(), 1e-9), vmax=error.max())
+
+views = [
+    ('X / Y (top)', error.max(axis=0), x, y, 'X (mm)', 'Y (mm)'),
+    ('X / Z (front)', error.max(axis=1), x, z, 'X (mm)', 'Z (mm)'),
+    ('Y / Z (side)', error.max(axis=2), y, z, 'Y (mm)', 'Z (mm)'),
+]
+
+for i, (title, image, h, v, h_label, v_label) in enumerate(views):
+    ax = fig.add_subplot(1, 3, i + 1)
+    mesh = ax.pcolormesh(h, v, image, norm=norm, shading='nearest')
+    ax.set_title(title)
+    ax.set_xlabel(h_label)
+    ax.set_ylabel(v_label)
+    ax.set_aspect('equal')
+
+fig.colorbar(mesh, ax=fig.axes, label='{} error (mm)'.format('Mean' if args.mean else 'Max'))
+
+# Render plot
+plt.show()
@@ -11,16 +11,60 @@ ffi = FFI()
 # Create interface for FFI
 # Note that this must be manually updated :-/
 ffi.cdef("""
+    struct hpod_leg_config_s {
+        float x;
+        float y;
+        float yaw;
+        float offset_a;
+        float len_ab;
+        float len_bc;
+    };
+
    struct hexapod_config_s {
         float length;
         float width;
         float offset_a;
         float len_ab;
         float len_bc;
+        int legs;
+        struct hpod_leg_config_s leg[8];
+    };
+
+    struct hpod_kinematics_s {
+        float len_ab_sq;
+        float len_bc_sq;
+        float len_ab_bc_2;
+        float inv_len_ab_2;
+        float inv_len_ab_bc_2;
+        float reach_min;
+        float reach_max;
+        float reach_min_sq;
+        float reach_max_sq;
+    };
+
+    struct hpod_leg_mount_s {
+        float x;
+        float y;
+        float side;
+        float cos_yaw;
+        float sin_yaw;
+    };
+
+    // Cache line aligned in C, padded here to match
+    struct hpod_leg_s {
+        struct hpod_leg_mount_s mount;
+        float offset_a;
+        struct hpod_kinematics_s kinematics;
+        float _pad;
     };
 
     struct hexapod_s {
         struct hexapod_config_s config;
+        struct hpod_kinematics_s kinematics;
+        int legs;
+        int uniform;
+        char _pad[60];
+        struct hpod_leg_s leg[8];
     };
 
     struct hpod_vector3_s {
@@ -29,10 +73,17 @@ ffi.cdef("""
         float z;
     };
 
+    struct hpod_gait_pattern_s {
+        float offset[8];
+        float duty;
+    };
+
     struct hpod_gait_s {
         struct hpod_vector3_s movement;
         struct hpod_vector3_s offset;
         float height_scale;
+        float yaw;
+        struct hpod_gait_pattern_s pattern;
     };
 
     void HPOD_init(struct hexapod_s* hexapod, struct hexapod_config_s* config);
@@ -40,6 +91,8 @@ ffi.cdef("""
                   float* alpha, float* beta, float* theta);
     void HPOD_gait_calc(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
                     float phase_scl, struct hpod_vector3_s* leg_pos);
+    void HPOD_gait_calc_leg(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
+                    float phase_scl, int leg, struct hpod_vector3_s* leg_pos);
     int HPOD_gait_valid(struct hexapod_s* hexapod, struct hpod_gait_s *gait);
 """)
 
@@ -63,8 +116,9 @@ class Hexapod:
         # Set default gait
         self.set_gait()
 
-    def set_gait(self, movement=(100.0, 200.0, 40.0), offset=(150.0, 0.0, -100.0), lift=0.05):
-        self.gait = ffi.new("struct hpod_gait_s *", (movement, offset, lift))
+    def set_gait(self, movement=(100.0, 200.0, 40.0), offset=(150.0, 0.0, -100.0), lift=0.05, yaw=0.4,
+                 pattern=((0.0, 1.0, 1.0, 0.0, 0.0, 1.0), 0.5)):
+        self.gait = ffi.new("struct hpod_gait_s *", (movement, offset, lift, yaw, pattern))
 
     def leg_ik3(self, x, y, z):
         end_pos = ffi.new("struct hpod_vector3_s *", (x, y, z))
@@ -80,6 +134,12 @@ class Hexapod:
         lib.HPOD_gait_calc(self.hexy, self.gait, m, phase, pos)
         return (float(pos.x), float(pos.y), float(pos.z))
 
+    def gait_calc_leg(self, movement, phase, leg):
+        m = ffi.new("struct hpod_vector3_s *", movement)
+        pos = ffi.new("struct hpod_vector3_s *")
+        lib.HPOD_gait_calc_leg(self.hexy, self.gait, m, phase, leg, pos)
+        return (float(pos.x), float(pos.y), float(pos.z))
+
     def gait_valid(self):
         res = lib.HPOD_gait_valid(self.hexy, self.gait)
         return (res == 0)
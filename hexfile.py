@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+# Hexapod column file reader
+# Loads column files written by hex-util as numpy arrays, memory mapped so that large
+# outputs are not read into memory or parsed. See util/include/colfile.h for the layout.
+#
+# https://github.com/ryankurte/libhexapod
+# Copyright 2017 Ryan Kurte
+
+import numpy
+
+MAGIC = b"HPODCOL1"
+NAME_MAX = 48
+
+HEADER = numpy.dtype([
+    ('magic', 'S8'),
+    ('columns', '<u4'),
+    ('data_offset', '<u4'),
+    ('rows', '<u8'),
+    ('dtype', 'S8'),
+])
+
+# Load a column file, returning the column names and a (columns, rows) array
+def load(filename):
+    header = numpy.fromfile(filename, dtype=HEADER, count=1)[0]
+    if header['magic'] != MAGIC:
+        raise ValueError("{} is not a hexapod column file".format(filename))
+
+    columns = int(header['columns'])
+    rows = int(header['rows'])
+    names = numpy.fromfile(filename, dtype='S{}'.format(NAME_MAX), count=columns, offset=HEADER.itemsize)
+    data = numpy.memmap(filename, dtype=header['dtype'].decode('ascii'), mode='r',
+                        offset=int(header['data_offset']), shape=(columns, rows))
+
+    return [n.decode('UTF-8') for n in names], data
+
+# Print a summary if run directly
+if __name__ == "__main__":
+    import sys
+    for filename in sys.argv[1:]:
+        names, data = load(filename)
+        print("{}: {} rows".format(filename, data.shape[1]))
+        for name, column in zip(names, data):
+            print("  {}: min {:.4f} max {:.4f}".format(name, column.min(), column.max()))
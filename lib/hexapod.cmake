@@ -10,9 +10,31 @@ set(LIBHEXAPOD_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/source/hexapod.c
     ${CMAKE_CURRENT_LIST_DIR}/source/vector.c
     ${CMAKE_CURRENT_LIST_DIR}/source/servo.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/servo_frame.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/controller.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/channel.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/batch.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/simd.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/gait_table.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/gait_blend.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/gait_pattern.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/fixed.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/jacobian.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/pipeline.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/gait_search.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/workspace.c
+    ${CMAKE_CURRENT_LIST_DIR}/source/body_pose.c
 )
 
+# Single precision only build, for targets with a float-only FPU
+option(HPOD_FLOAT_ONLY "Route all libhexapod math through single precision functions" OFF)
+if(HPOD_FLOAT_ONLY)
+    add_definitions(-DHPOD_FLOAT_ONLY)
+endif()
+
 # Create library
 add_library(hexapod SHARED ${LIBHEXAPOD_SOURCES})
 add_library(hexapod-static STATIC ${LIBHEXAPOD_SOURCES})
+target_link_libraries(hexapod m pthread)
+target_link_libraries(hexapod-static m pthread)
 set(OPTIONAL_LIBS hexapod-static ${OPTIONAL_LIBS} ${PYTHON_LIBRARIES})
@@ -0,0 +1,41 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Batched kinematics functions
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_BATCH_H
+#define HEXAPOD_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+
+/** \defgroup Batch
+ * @brief Structure-of-arrays kinematics for evaluating many legs per call
+ * @{
+ */
+
+int HPOD_leg_ik3_batch(struct hexapod_s* hexapod, int count,
+                       const float* x, const float* y, const float* z,
+                       float* alpha, float* beta, float* theta, uint8_t* valid);
+
+int HPOD_leg_ik3_batch_n(struct hexapod_s* hexapod, int leg, int count,
+                         const float* x, const float* y, const float* z,
+                         float* alpha, float* beta, float* theta, uint8_t* valid);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
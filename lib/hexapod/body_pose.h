@@ -0,0 +1,75 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Rigid body pose transform
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_BODY_POSE_H
+#define HEXAPOD_BODY_POSE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+
+/** \defgroup BodyPose
+ * @brief Six degree of freedom body pose
+ * HPOD_body_transform evaluates roll and pitch separately for each leg with integer joint
+ * offsets and no yaw or translation. A body transform instead builds the body rotation matrix
+ * once per tick (three sine / cosine pairs), after which moving each hip and foot target is a
+ * 3x3 matrix vector product with no transcendental functions.
+ *
+ * Feet are expressed in the neutral stance, which is the body frame with zero pose (X right,
+ * Y forwards, Z up, origin at the body center). Positive roll raises the right side, positive
+ * pitch raises the front and positive yaw turns the body anticlockwise from above, applied
+ * as yaw, then pitch, then roll. With no yaw or translation and zero joint offsets this is
+ * the same rotation as HPOD_body_transform.
+ * @{
+ */
+
+/**
+ * @brief Body pose relative to the neutral stance
+ */
+struct hpod_body_pose_s {
+    struct hpod_vector3_s position; //!< Body center translation (mm)
+    float roll;                     //!< Rotation about Y, right side up (radians)
+    float pitch;                    //!< Rotation about X, front up (radians)
+    float yaw;                      //!< Rotation about Z, anticlockwise from above (radians)
+};
+
+#define HPOD_DEFAULT_BODY_POSE {{0.0, 0.0, 0.0}, 0.0, 0.0, 0.0}
+
+/**
+ * @brief Body transform for a pose
+ * rotation maps body to neutral stance coordinates, its transpose is the inverse.
+ */
+struct hpod_body_transform_s {
+    float rotation[3][3];           //!< Body to stance rotation matrix
+    struct hpod_vector3_s position; //!< Body center in the stance frame
+};
+
+void HPOD_body_pose_init(struct hpod_body_transform_s* transform, struct hpod_body_pose_s* pose);
+
+void HPOD_body_pose_hips(struct hexapod_s* hexapod, struct hpod_body_transform_s* transform,
+                         struct hpod_vector3_s hips[]);
+
+void HPOD_body_pose_apply(struct hexapod_s* hexapod, struct hpod_body_transform_s* transform,
+                          const struct hpod_vector3_s feet[], struct hpod_vector3_s joints[]);
+
+void HPOD_body_pose_apply_leg(struct hexapod_s* hexapod, struct hpod_body_transform_s* transform, int leg,
+                              const struct hpod_vector3_s* foot, struct hpod_vector3_s* joint);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Lock free command and telemetry channels
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_CHANNEL_H
+#define HEXAPOD_CHANNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/pipeline.h"
+
+/** \defgroup Channel
+ * @brief Single producer, single consumer exchange between planner and control threads
+ * Commands flow to the control thread through a triple buffered mailbox, where only the
+ * latest command matters. Telemetry flows back through a ring, where every sample matters
+ * but the control thread must never wait for the consumer. Both are wait free on each side
+ * and contain no pointers, so they can be placed in shared memory.
+ * @{
+ */
+
+/**
+ * @brief Motion command
+ */
+struct hpod_command_s {
+    struct hpod_vector3_s movement;     //!< Movement scale, as for HPOD_gait_calc
+    struct hpod_body_pose_s pose;       //!< Body pose
+    struct hpod_gait_s gait;            //!< Gait parameters
+    float cycle_rate;                   //!< Gait cycles per second
+};
+
+/**
+ * @brief Triple buffered command mailbox
+ * The producer and consumer each own one buffer, the third is exchanged atomically on
+ * publish and fetch, so neither side ever observes a partially written command. Fields
+ * accessed by different threads are kept on separate cache lines.
+ */
+struct hpod_mailbox_s {
+    struct hpod_command_s buffers[3];
+    uint32_t shared __attribute__((aligned(HPOD_CACHE_LINE)));  //!< Exchange buffer index and fresh flag
+    uint32_t write __attribute__((aligned(HPOD_CACHE_LINE)));   //!< Producer buffer index
+    uint32_t read __attribute__((aligned(HPOD_CACHE_LINE)));    //!< Consumer buffer index
+};
+
+/**
+ * @brief Per tick telemetry sample
+ */
+struct hpod_telemetry_s {
+    uint64_t tick;                      //!< Controller tick number
+    uint64_t time_ns;                   //!< Tick start (monotonic)
+    float phase;                        //!< Walking phase
+    float angles[HPOD_MAX_LEGS][3];     //!< Joint angles (alpha, beta, theta)
+    int out[HPOD_MAX_LEGS][3];          //!< Servo outputs
+    uint8_t valid[HPOD_MAX_LEGS];       //!< IK succeeded for the leg
+};
+
+// Telemetry ring capacity, must be a power of two
+#define HPOD_TELEMETRY_SLOTS        64
+
+/**
+ * @brief Telemetry ring
+ * Samples are claimed and committed in place by the producer. When the ring is full new
+ * samples are dropped (and counted) rather than blocking the producer.
+ */
+struct hpod_telemetry_ring_s {
+    struct hpod_telemetry_s slots[HPOD_TELEMETRY_SLOTS];
+    uint32_t head __attribute__((aligned(HPOD_CACHE_LINE)));    //!< Next slot to write (producer)
+    uint32_t dropped;                                           //!< Samples dropped while full (producer)
+    uint32_t tail __attribute__((aligned(HPOD_CACHE_LINE)));    //!< Next slot to read (consumer)
+};
+
+void HPOD_mailbox_init(struct hpod_mailbox_s *mailbox, struct hpod_command_s *initial);
+
+void HPOD_mailbox_publish(struct hpod_mailbox_s *mailbox, struct hpod_command_s *command);
+
+struct hpod_command_s *HPOD_mailbox_fetch(struct hpod_mailbox_s *mailbox, int *updated);
+
+void HPOD_telemetry_init(struct hpod_telemetry_ring_s *ring);
+
+struct hpod_telemetry_s *HPOD_telemetry_claim(struct hpod_telemetry_ring_s *ring);
+
+void HPOD_telemetry_commit(struct hpod_telemetry_ring_s *ring);
+
+int HPOD_telemetry_pop(struct hpod_telemetry_ring_s *ring, struct hpod_telemetry_s *sample);
+
+uint32_t HPOD_telemetry_dropped(struct hpod_telemetry_ring_s *ring);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Real time controller
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_CONTROLLER_H
+#define HEXAPOD_CONTROLLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/servo.h"
+#include "hexapod/pipeline.h"
+#include "hexapod/channel.h"
+
+/** \defgroup Controller
+ * @brief Fixed rate gait -> IK -> servo loop with latency and jitter monitoring
+ * The controller runs HPOD_pipeline once per period on its own thread, advancing the walking
+ * phase from the monotonic clock. All state is allocated in the controller object, so the
+ * loop performs no allocation or locking. Commands arrive through a mailbox and telemetry
+ * leaves through a ring (see Channel), statistics are published through a sequence lock, so
+ * the controller thread never blocks on other threads.
+ * @{
+ */
+
+/**
+ * @brief Controller stages, timed individually each tick
+ */
+enum hpod_controller_stage_e {
+    HPOD_STAGE_COMMAND = 0,     //!< Command latch and phase advance
+    HPOD_STAGE_KINEMATICS = 1,  //!< Gait, body transform, IK and servo scaling
+    HPOD_STAGE_OUTPUT = 2,      //!< Output callback (frame encoding and transport)
+    HPOD_CONTROLLER_STAGES = 3,
+};
+
+// Jitter histogram bins, bin 0 is under 1us and bin n covers [2^(n-1), 2^n) us
+#define HPOD_JITTER_BINS            16
+
+// Default tick period (500 Hz)
+#define HPOD_CONTROLLER_DEFAULT_PERIOD_NS   2000000
+
+/**
+ * @brief Controller output callback
+ * Called from the controller thread each tick with the pipeline results, out has an entry
+ * for each leg of the hexapod.
+ */
+typedef void (*hpod_controller_output_f)(void *ctx, struct hpod_pipeline_scratch_s *scratch, int out[][3]);
+
+/**
+ * @brief Controller configuration
+ */
+struct hpod_controller_config_s {
+    uint32_t period_ns;                 //!< Tick period
+    int priority;                       //!< SCHED_FIFO priority, 0 for the default scheduler
+    int cpu;                            //!< CPU to pin the controller thread to, -1 for any
+    hpod_controller_output_f output;    //!< Output callback (may be NULL)
+    void *output_ctx;                   //!< Output callback context
+};
+
+/**
+ * @brief Per stage latency statistics (nanoseconds)
+ */
+struct hpod_stage_stats_s {
+    uint32_t last;
+    uint32_t max;
+    uint64_t total;
+};
+
+/**
+ * @brief Controller statistics
+ */
+struct hpod_controller_stats_s {
+    uint64_t ticks;                     //!< Ticks executed
+    uint64_t deadline_misses;           //!< Ticks completing after the next tick was due
+    uint64_t skipped;                   //!< Periods skipped to recover from overruns
+    uint64_t ik_failures;               //!< Legs without an IK solution
+    uint64_t commands;                  //!< Commands received
+    uint32_t telemetry_dropped;         //!< Telemetry samples dropped while the ring was full
+    int realtime;                       //!< SCHED_FIFO was applied to the controller thread
+    float phase;                        //!< Phase of the last tick
+    struct hpod_stage_stats_s stage[HPOD_CONTROLLER_STAGES];
+    uint32_t jitter_max;                //!< Maximum wakeup lateness (ns)
+    uint64_t jitter[HPOD_JITTER_BINS];  //!< Wakeup lateness histogram
+};
+
+/**
+ * @brief Controller object
+ * Fields are internal, use the HPOD_controller functions to interact with a controller.
+ */
+struct hpod_controller_s {
+    struct hexapod_s *hexapod;
+    struct hpod_servo_s *servo;
+    struct hpod_controller_config_s config;
+
+    // Controller thread state
+    pthread_t thread;
+    int running;
+    uint64_t last_ns;
+    float phase;
+    struct hpod_body_transform_s transform;
+    struct hpod_pipeline_scratch_s scratch;
+    int out[HPOD_MAX_LEGS][3];
+    struct hpod_controller_stats_s working;
+
+    // Thread exchange
+    struct hpod_mailbox_s commands;
+    struct hpod_telemetry_ring_s telemetry;
+    uint32_t stats_seq;
+    struct hpod_controller_stats_s stats;
+};
+
+void HPOD_controller_init(struct hpod_controller_s *ctrl, struct hexapod_s *hexapod, struct hpod_gait_s *gait,
+                          struct hpod_servo_s *servo, struct hpod_controller_config_s *config);
+
+void HPOD_controller_command(struct hpod_controller_s *ctrl, struct hpod_command_s *command);
+
+int HPOD_controller_telemetry(struct hpod_controller_s *ctrl, struct hpod_telemetry_s *sample);
+
+int HPOD_controller_step(struct hpod_controller_s *ctrl, uint64_t now_ns);
+
+int HPOD_controller_start(struct hpod_controller_s *ctrl);
+
+void HPOD_controller_stop(struct hpod_controller_s *ctrl);
+
+void HPOD_controller_stats(struct hpod_controller_s *ctrl, struct hpod_controller_stats_s *stats);
+
+uint64_t HPOD_controller_time_ns(void);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
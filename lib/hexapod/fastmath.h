@@ -0,0 +1,185 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Fast polynomial approximations of math functions
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_FASTMATH_H
+#define HEXAPOD_FASTMATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/** \defgroup Fastmath
+ * @brief Branch free approximations used by the vectorised kernels
+ * These mirror the SIMD implementations lane for lane, for use in scalar code that
+ * should match the vector kernels. Maximum errors are measured against libm over
+ * the full input domain and checked in the unit tests.
+ * @{
+ */
+
+#define HPOD_FAST_PI            3.14159265358979f
+#define HPOD_FAST_PI_2          1.57079632679490f
+#define HPOD_FAST_2PI           6.28318530717959f
+#define HPOD_FAST_INV_2PI       0.159154943091895f
+
+// Magic constant for round-to-nearest by float addition (1.5 * 2^23)
+#define HPOD_FAST_ROUND_MAGIC   12582912.0f
+
+// Inverse square root seed, refined by Newton iterations
+#define HPOD_FAST_RSQRT_MAGIC   0x5f3759df
+
+// Abramowitz & Stegun 4.4.46 acos coefficients (0 <= x <= 1)
+#define HPOD_FAST_ACOS_C0       1.5707963050f
+#define HPOD_FAST_ACOS_C1      -0.2145988016f
+#define HPOD_FAST_ACOS_C2       0.0889789874f
+#define HPOD_FAST_ACOS_C3      -0.0501743046f
+#define HPOD_FAST_ACOS_C4       0.0308918810f
+#define HPOD_FAST_ACOS_C5      -0.0170881256f
+#define HPOD_FAST_ACOS_C6       0.0066700901f
+#define HPOD_FAST_ACOS_C7      -0.0012624911f
+
+// Minimax atan coefficients (0 <= x <= 1), odd polynomial to x^11
+#define HPOD_FAST_ATAN_C1       0.99997726f
+#define HPOD_FAST_ATAN_C3      -0.33262347f
+#define HPOD_FAST_ATAN_C5       0.19354346f
+#define HPOD_FAST_ATAN_C7      -0.11643287f
+#define HPOD_FAST_ATAN_C9       0.05265332f
+#define HPOD_FAST_ATAN_C11     -0.01172120f
+
+// Taylor sin coefficients (-pi/2 <= x <= pi/2), odd polynomial to x^11
+#define HPOD_FAST_SIN_C3       -1.6666667e-1f
+#define HPOD_FAST_SIN_C5        8.3333333e-3f
+#define HPOD_FAST_SIN_C7       -1.9841270e-4f
+#define HPOD_FAST_SIN_C9        2.7557319e-6f
+#define HPOD_FAST_SIN_C11      -2.5052108e-8f
+
+// Documented maximum errors (absolute for angles, relative for sqrt)
+#define HPOD_FAST_SQRT_MAX_REL_ERROR    3e-7f
+#define HPOD_FAST_ACOS_MAX_ERROR        1e-6f
+#define HPOD_FAST_ATAN2_MAX_ERROR       3e-6f
+#define HPOD_FAST_SIN_MAX_ERROR         2e-6f   //!< For |x| < 8 pi, also applies to cos
+
+/**
+ * @brief Fast square root
+ * Bit-level inverse square root seed with three Newton iterations, returns 0 for 0
+ */
+static inline float HPOD_fast_sqrtf(float x)
+{
+    int32_t i;
+    float y;
+
+    memcpy(&i, &x, sizeof(i));
+    i = HPOD_FAST_RSQRT_MAGIC - (i >> 1);
+    memcpy(&y, &i, sizeof(y));
+
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+
+    return x * y;
+}
+
+/**
+ * @brief Fast arc cosine
+ * Returns NaN outside of -1 <= x <= 1 to match acosf
+ */
+static inline float HPOD_fast_acosf(float x)
+{
+    float a = x < 0 ? -x : x;
+
+    float p = HPOD_FAST_ACOS_C7;
+    p = p * a + HPOD_FAST_ACOS_C6;
+    p = p * a + HPOD_FAST_ACOS_C5;
+    p = p * a + HPOD_FAST_ACOS_C4;
+    p = p * a + HPOD_FAST_ACOS_C3;
+    p = p * a + HPOD_FAST_ACOS_C2;
+    p = p * a + HPOD_FAST_ACOS_C1;
+    p = p * a + HPOD_FAST_ACOS_C0;
+
+    float r = HPOD_fast_sqrtf(1.0f - a) * p;
+
+    if (!(a <= 1.0f)) {
+        return NAN;
+    }
+
+    return x < 0 ? HPOD_FAST_PI - r : r;
+}
+
+/**
+ * @brief Fast two argument arc tangent
+ * Octant reduction onto a minimax polynomial, returns 0 for (0, 0)
+ */
+static inline float HPOD_fast_atan2f(float y, float x)
+{
+    float ax = x < 0 ? -x : x;
+    float ay = y < 0 ? -y : y;
+
+    float mn = ax < ay ? ax : ay;
+    float mx = ax < ay ? ay : ax;
+
+    float a = mn / (mx > 1e-30f ? mx : 1e-30f);
+    float s = a * a;
+
+    float p = HPOD_FAST_ATAN_C11;
+    p = p * s + HPOD_FAST_ATAN_C9;
+    p = p * s + HPOD_FAST_ATAN_C7;
+    p = p * s + HPOD_FAST_ATAN_C5;
+    p = p * s + HPOD_FAST_ATAN_C3;
+    p = p * s + HPOD_FAST_ATAN_C1;
+
+    float r = p * a;
+
+    r = ay > ax ? HPOD_FAST_PI_2 - r : r;
+    r = x < 0 ? HPOD_FAST_PI - r : r;
+    return y < 0 ? -r : r;
+}
+
+/**
+ * @brief Fast sine
+ * Wraps to the nearest period then reflects into -pi/2..pi/2
+ */
+static inline float HPOD_fast_sinf(float x)
+{
+    // Wrap into -pi..pi
+    float k = (x * HPOD_FAST_INV_2PI + HPOD_FAST_ROUND_MAGIC) - HPOD_FAST_ROUND_MAGIC;
+    x = x - k * HPOD_FAST_2PI;
+
+    // Reflect into -pi/2..pi/2
+    x = x > HPOD_FAST_PI_2 ? HPOD_FAST_PI - x : x;
+    x = x < -HPOD_FAST_PI_2 ? -HPOD_FAST_PI - x : x;
+
+    float s = x * x;
+
+    float p = HPOD_FAST_SIN_C11;
+    p = p * s + HPOD_FAST_SIN_C9;
+    p = p * s + HPOD_FAST_SIN_C7;
+    p = p * s + HPOD_FAST_SIN_C5;
+    p = p * s + HPOD_FAST_SIN_C3;
+
+    return x + x * s * p;
+}
+
+/**
+ * @brief Fast cosine
+ */
+static inline float HPOD_fast_cosf(float x)
+{
+    return HPOD_fast_sinf(x + HPOD_FAST_PI_2);
+}
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
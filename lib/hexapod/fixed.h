@@ -0,0 +1,110 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Fixed point kinematics for targets without an FPU
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_FIXED_H
+#define HEXAPOD_FIXED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/servo.h"
+
+/** \defgroup Fixed
+ * @brief Q16.16 fixed point kinematics
+ * Lengths are in Q16.16 millimetres, angles in Q16.16 radians and phase in Q16.16
+ * scalar (-1 to 1). Trig is evaluated with CORDIC so no floating point operations
+ * are used outside of the init functions.
+ * @{
+ */
+
+typedef int32_t hpod_q16_t;
+
+#define HPOD_Q16_ONE                (1 << 16)
+#define HPOD_Q16_HALF               (1 << 15)
+#define HPOD_Q16_PI                 205887
+#define HPOD_Q16_FROM_FLOAT(a)      ((hpod_q16_t)((a) * 65536.0f + ((a) < 0 ? -0.5f : 0.5f)))
+#define HPOD_Q16_TO_FLOAT(a)        ((float)(a) / 65536.0f)
+#define HPOD_Q16_MUL(a, b)          ((hpod_q16_t)(((int64_t)(a) * (b)) >> 16))
+
+/**
+ * @brief Fixed point vector
+ */
+struct hpod_fx_vector3_s {
+    hpod_q16_t x;
+    hpod_q16_t y;
+    hpod_q16_t z;
+};
+
+/**
+ * @brief Fixed point hexapod object
+ * Geometry and derived kinematic constants converted from a hexapod config
+ */
+struct hpod_fx_s {
+    hpod_q16_t offset_a;        //!< Distance between planar and vertical shoulder joints
+    hpod_q16_t len_ab;          //!< Length of upper leg (femur)
+    hpod_q16_t len_bc;          //!< Length of foreleg
+    int64_t len_ab_sq;          //!< len_ab^2 (Q32)
+    int64_t len_bc_sq;          //!< len_bc^2 (Q32)
+    int64_t len_ab_bc_2;        //!< 2 * len_ab * len_bc (Q32)
+    int64_t reach_min_sq;       //!< Minimum reachable |AC|^2 (Q32)
+    int64_t reach_max_sq;       //!< Maximum reachable |AC|^2 (Q32)
+};
+
+/**
+ * @brief Fixed point gait object
+ */
+struct hpod_fx_gait_s {
+    struct hpod_fx_vector3_s movement;  //!< Dimensions of leg movement box
+    struct hpod_fx_vector3_s offset;    //!< Offset of movement box
+    hpod_q16_t height_scale;            //!< Leg lift offset as a factor of movement height
+    hpod_q16_t inv_height_scale;        //!< 1 / height_scale
+};
+
+/**
+ * @brief Fixed point servo adaptor
+ */
+struct hpod_fx_servo_s {
+    hpod_q16_t range_rads;      //!< Servo range in radians
+    hpod_q16_t counts_per_rad;  //!< Servo output counts per radian
+    int output_offset;          //!< Servo output offset (ie. 512 midpoint)
+};
+
+void HPOD_fx_init(struct hpod_fx_s* fx, struct hexapod_config_s* config);
+void HPOD_fx_gait_init(struct hpod_fx_gait_s* fx_gait, struct hpod_gait_s* gait);
+void HPOD_fx_servo_init(struct hpod_fx_servo_s* fx_servo, struct hpod_servo_s* servo);
+
+void HPOD_fx_sincos(hpod_q16_t angle, hpod_q16_t* sin, hpod_q16_t* cos);
+hpod_q16_t HPOD_fx_atan2(hpod_q16_t y, hpod_q16_t x);
+
+int HPOD_fx_leg_ik3(struct hpod_fx_s* fx, struct hpod_fx_vector3_s* end_pos,
+                    hpod_q16_t* alpha, hpod_q16_t* beta, hpod_q16_t* theta);
+
+void HPOD_fx_leg_fk3(struct hpod_fx_s* fx, hpod_q16_t alpha, hpod_q16_t beta, hpod_q16_t theta,
+                     struct hpod_fx_vector3_s* end_pos);
+
+void HPOD_fx_gait_calc(struct hpod_fx_gait_s* gait, struct hpod_fx_vector3_s* movement,
+                       hpod_q16_t phase_scl, struct hpod_fx_vector3_s* leg_pos);
+
+int HPOD_fx_servo_scale(struct hpod_fx_servo_s* servo, hpod_q16_t angle);
+
+int HPOD_fx_leg_ik3_servo(struct hpod_fx_s* fx, struct hpod_fx_servo_s* servo,
+                          struct hpod_fx_vector3_s* end_pos, int out[3]);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Gait transition blending
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_GAIT_BLEND_H
+#define HEXAPOD_GAIT_BLEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/gait_table.h"
+
+/** \defgroup GaitBlend
+ * @brief Smooth transitions between gaits or movements
+ * Switching gait or movement mid stride makes leg positions jump. A blend cross-fades leg
+ * positions from one gait table to another over a number of phase cycles, weighted by a
+ * smootherstep so velocity and acceleration are continuous at both ends of the transition.
+ * The weight is evaluated once per tick by HPOD_gait_blend_update, so each leg costs two
+ * table lookups and an interpolation.
+ * @{
+ */
+
+/**
+ * @brief Gait blend object
+ * Tables are referenced and must outlive the blend, the target table becomes the current
+ * table once the transition completes.
+ */
+struct hpod_gait_blend_s {
+    struct hpod_gait_table_s* from;     //!< Current gait table
+    struct hpod_gait_table_s* to;       //!< Target gait table (NULL when not blending)
+    float rate;                         //!< Progress per unit phase (1 / (2 * cycles))
+    float progress;                     //!< Transition progress (0 to 1)
+    float weight;                       //!< Target weight, smootherstep(progress)
+    float last_phase;                   //!< Phase of the previous update
+};
+
+void HPOD_gait_blend_init(struct hpod_gait_blend_s* blend, struct hpod_gait_table_s* table, float phase_scl);
+
+int HPOD_gait_blend_start(struct hpod_gait_blend_s* blend, struct hpod_gait_table_s* to, float cycles);
+
+int HPOD_gait_blend_update(struct hpod_gait_blend_s* blend, float phase_scl);
+
+void HPOD_gait_blend_calc(struct hpod_gait_blend_s* blend, float phase_scl, enum hpod_interp_e interp,
+                          struct hpod_vector3_s* leg_pos);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
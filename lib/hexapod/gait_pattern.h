@@ -0,0 +1,64 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Gait patterns
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_GAIT_PATTERN_H
+#define HEXAPOD_GAIT_PATTERN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+
+/** \defgroup GaitPattern
+ * @brief Leg phase schedules and static stability
+ * A pattern sets when each leg steps (its phase offset) and how long it stays down (the duty
+ * factor). Higher duty factors keep more legs on the ground, trading speed for a larger
+ * support polygon. hexapod/gait_pattern.hpp provides the same schedules as compile time
+ * constants for C++ callers.
+ * @{
+ */
+
+/**
+ * @brief Standard gait patterns
+ */
+enum hpod_gait_pattern_e {
+    HPOD_PATTERN_TRIPOD = 0,    //!< Alternating tripods, duty 1/2 (fastest, three legs down)
+    HPOD_PATTERN_RIPPLE = 1,    //!< Back to front waves offset by half a cycle per side, duty 2/3
+    HPOD_PATTERN_WAVE = 2,      //!< One leg at a time back to front, duty 5/6 (five legs down)
+    HPOD_PATTERN_COUNT
+};
+
+// Duty factor limits, a leg must spend some of each cycle both in contact and in swing
+#define HPOD_GAIT_DUTY_MIN      0.01f
+#define HPOD_GAIT_DUTY_MAX      0.99f
+
+// Standard gait patterns, indexed by hpod_gait_pattern_e
+extern const struct hpod_gait_pattern_s hpod_gait_patterns[HPOD_PATTERN_COUNT];
+
+int HPOD_gait_pattern_init(struct hpod_gait_pattern_s* pattern, enum hpod_gait_pattern_e base, float duty);
+
+float HPOD_gait_pattern_phase(const struct hpod_gait_pattern_s* pattern, float phase_scl, int leg);
+
+int HPOD_gait_pattern_contacts(const struct hpod_gait_pattern_s* pattern, float phase_scl, int legs,
+                               uint8_t contact[]);
+
+float HPOD_gait_stability(struct hexapod_s* hexapod, struct hpod_gait_s* gait,
+                          struct hpod_vector3_s* movement, int slices, float* min_phase);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
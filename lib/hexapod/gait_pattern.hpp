@@ -0,0 +1,124 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Compile time gait patterns for C++
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_GAIT_PATTERN_HPP
+#define HEXAPOD_GAIT_PATTERN_HPP
+
+#include <math.h>
+
+#include <array>
+#include <utility>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+#include "hexapod/scalar.hpp"
+
+/** \addtogroup GaitPattern
+ * @{
+ */
+
+namespace hpod
+{
+
+/**
+ * @brief Leg phase schedule with compile time offsets and duty factor
+ * Offsets and duty are rational (in units of one cycle over Den) with one offset per leg, so
+ * for a constant leg the offset and the contact / swing scale factors fold to constants and
+ * phase() reduces to a wrap and a multiply. Matches HPOD_gait_pattern_phase for the
+ * equivalent C pattern.
+ */
+template <int Den, int Duty, int... Offsets>
+struct PhaseSchedule {
+    static_assert(float(Duty) / Den >= HPOD_GAIT_DUTY_MIN && float(Duty) / Den <= HPOD_GAIT_DUTY_MAX,
+                  "duty factor must be between HPOD_GAIT_DUTY_MIN and HPOD_GAIT_DUTY_MAX");
+
+    /** @brief Number of legs scheduled */
+    static constexpr int legs = sizeof...(Offsets);
+
+    /** @brief Duty factor (fraction of the cycle in contact) */
+    static constexpr float duty()
+    {
+        return (float)Duty / Den;
+    }
+
+    /** @brief Phase offset of a leg (0 to 2, in units of phase) */
+    static constexpr float offset(int leg)
+    {
+        constexpr int offsets[] = {Offsets...};
+        return 2.0f * offsets[leg] / Den;
+    }
+
+    /** @brief Equivalent C pattern (six legs only) */
+    static constexpr struct hpod_gait_pattern_s pattern()
+    {
+        static_assert(legs == 6, "C patterns have six legs");
+        return {{offset(0), offset(1), offset(2), offset(3), offset(4), offset(5)}, duty()};
+    }
+
+    /** @brief Gait phase of a leg at a walking phase, see HPOD_gait_pattern_phase */
+    template <int Leg, typename T = float>
+    static inline T phase(T phase_scl)
+    {
+        static_assert(Leg >= 0 && Leg < legs, "leg out of range");
+        constexpr T leg_offset = T(offset(Leg));
+        constexpr T leg_duty = T(duty());
+        constexpr T contact_scale = T(0.5f / duty());
+        constexpr T swing_scale = T(0.5f / (1.0f - duty()));
+
+        T phase = Scalar<T>::wrap(phase_scl + leg_offset);
+        T abs_phase = Scalar<T>::abs(phase);
+
+        if (abs_phase < leg_duty) {
+            return phase * contact_scale;
+        }
+
+        T swing = T(0.5f) + (abs_phase - leg_duty) * swing_scale;
+        return phase < T(0.0f) ? -swing : swing;
+    }
+
+    /** @brief Gait phases of every leg at a walking phase */
+    template <typename T = float>
+    static inline std::array<T, legs> phases(T phase_scl)
+    {
+        return phases(phase_scl, std::make_integer_sequence<int, legs>{});
+    }
+
+    /** @brief Static stability margin of a gait walked with this schedule, see HPOD_gait_stability */
+    static float stability(struct hexapod_s* hexapod, struct hpod_gait_s gait,
+                           struct hpod_vector3_s* movement, int slices, float* min_phase = NULL)
+    {
+        gait.pattern = pattern();
+        return HPOD_gait_stability(hexapod, &gait, movement, slices, min_phase);
+    }
+
+private:
+    template <typename T, int... Legs>
+    static inline std::array<T, legs> phases(T phase_scl, std::integer_sequence<int, Legs...>)
+    {
+        return {phase<Legs, T>(phase_scl)...};
+    }
+};
+
+// Standard schedules, matching hpod_gait_patterns (offsets in sixths of a cycle)
+typedef PhaseSchedule<2, 1, 0, 1, 1, 0, 0, 1> Tripod;
+typedef PhaseSchedule<6, 4, 2, 5, 4, 1, 0, 3> Ripple;
+typedef PhaseSchedule<6, 5, 4, 1, 5, 2, 0, 3> Wave;
+
+// Custom duty factor schedules with the standard leg orders
+template <int Den, int Duty>
+using TripodDuty = PhaseSchedule<2 * Den, 2 * Duty, 0, Den, Den, 0, 0, Den>;
+
+template <int Den, int Duty>
+using WaveDuty = PhaseSchedule<6 * Den, 6 * Duty, 4 * Den, Den, 5 * Den, 2 * Den, 0, 3 * Den>;
+
+}
+
+/** @}*/
+
+#endif
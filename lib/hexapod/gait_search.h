@@ -0,0 +1,100 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Gait feasibility checking and parallel gait parameter search
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_GAIT_SEARCH_H
+#define HEXAPOD_GAIT_SEARCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+
+/** \defgroup GaitSearch
+ * @brief Feasibility of gaits against a hexapod config
+ * A gait is feasible if every leg position over a walking period is reachable for each of
+ * the provided movements, and (optionally) within joint limits.
+ * @{
+ */
+
+// Number of searchable gait parameters (movement x/y/z, offset x/y/z, height_scale, yaw)
+#define HPOD_GAIT_PARAMS            8
+
+// Maximum number of search worker threads
+#define HPOD_SEARCH_MAX_THREADS     64
+
+/**
+ * @brief Joint angle limits (alpha, beta, theta)
+ */
+struct hpod_joint_limits_s {
+    float min[3];
+    float max[3];
+};
+
+/**
+ * @brief Gait feasibility result
+ * Checks stop at the first failing slice, so margins for infeasible gaits only cover the
+ * slices before the failure.
+ */
+struct hpod_gait_check_s {
+    int feasible;               //!< All slices solved within joint limits
+    int fail_movement;          //!< Index of the failing movement (or -1)
+    int fail_leg;               //!< Index of the failing leg (or -1)
+    float fail_phase;           //!< First failing phase (or NaN)
+    float reach_margin;         //!< Minimum distance (mm) inside the leg reach envelope
+    float joint_margin[3];      //!< Minimum distance (rad) inside the joint limits
+    int slices_checked;         //!< Slices evaluated before completion or failure
+};
+
+/**
+ * @brief Gait parameter grid
+ * Each parameter is sampled with steps points from min to max (inclusive), a parameter
+ * with steps of 1 (or less) is fixed at min. Candidates are indexed with movement.x varying
+ * fastest, in the order given by HPOD_GAIT_PARAMS.
+ */
+struct hpod_gait_grid_s {
+    struct hpod_gait_s min;
+    struct hpod_gait_s max;
+    int steps[HPOD_GAIT_PARAMS];
+};
+
+/**
+ * @brief Parallel gait search configuration
+ */
+struct hpod_gait_search_s {
+    struct hexapod_s* hexapod;              //!< Hexapod to check against
+    struct hpod_gait_grid_s* grid;          //!< Candidate grid
+    struct hpod_joint_limits_s* limits;     //!< Joint limits, NULL for none
+    struct hpod_vector3_s* movements;       //!< Movements each candidate must support
+    int movement_count;
+    int slices;                             //!< Slices per walking period
+    int threads;                            //!< Worker threads, 0 for one per online CPU
+    uint32_t steals;                        //!< Work stealing operations in the last search
+};
+
+int HPOD_gait_check(struct hexapod_s* hexapod, struct hpod_gait_s* gait,
+                    struct hpod_vector3_s* movements, int movement_count, int slices,
+                    struct hpod_joint_limits_s* limits, struct hpod_gait_check_s* result);
+
+int HPOD_gait_grid_size(struct hpod_gait_grid_s* grid);
+
+void HPOD_gait_grid_get(struct hpod_gait_grid_s* grid, int index, struct hpod_gait_s* gait);
+
+int HPOD_gait_search(struct hpod_gait_search_s* search, struct hpod_gait_check_s* results);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Gait lookup tables
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_GAIT_TABLE_H
+#define HEXAPOD_GAIT_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/vector.h"
+
+/** \defgroup GaitTable
+ * @brief Precomputed gait trajectories sampled over phase
+ * For a fixed gait the leg trajectory is a pure function of phase, so it is sampled
+ * once and interpolated per tick instead of evaluating trig in HPOD_gait_calc.
+ * Movement only scales the sampled shape, so changing it does not resample the gait.
+ * @{
+ */
+
+/**
+ * @brief Gait shape at a single phase slice
+ * Leg position is x = sin * kx + offset.x, y = sin * ky, z = z
+ */
+struct hpod_gait_slice_s {
+    float sin;  //!< sin(phase * pi), scaled by movement to give x and y
+    float z;    //!< Leg height, independent of movement
+};
+
+/**
+ * @brief Precomputed leg angles at a single phase slice
+ */
+struct hpod_gait_angles_s {
+    float alpha;
+    float beta;
+    float theta;
+};
+
+/**
+ * @brief Interpolation modes for table lookups
+ */
+enum hpod_interp_e {
+    HPOD_INTERP_LINEAR = 0, //!< Linear between neighbouring slices
+    HPOD_INTERP_CUBIC = 1,  //!< Catmull-Rom spline over four neighbouring slices
+};
+
+/**
+ * @brief Gait table object
+ * Slice storage is provided by the caller, slice i is at phase -1 + 2 * i / slices
+ */
+struct hpod_gait_table_s {
+    struct hexapod_s* hexapod;          //!< Hexapod instance used for IK
+    int leg;                            //!< Leg the table is built for, -1 for the shared links
+    struct hpod_gait_s gait;            //!< Gait the table was built from
+    struct hpod_vector3_s movement;     //!< Current movement vector
+    int slices;                         //!< Number of slices over one phase cycle
+    float slices_per_phase;             //!< Slices per unit phase (slices / 2)
+    float kx;                           //!< X scale (gait.movement.x / 2 * movement.x, in the leg frame)
+    float ky;                           //!< Y scale (gait.movement.y / 2 * movement.y, in the leg frame)
+    struct hpod_gait_slice_s* shape;    //!< Sampled gait shape (slices entries)
+    struct hpod_gait_angles_s* angles;  //!< Optional precomputed angles (slices entries or NULL)
+};
+
+int HPOD_gait_table_init(struct hpod_gait_table_s* table, struct hexapod_s* hexapod,
+                         struct hpod_gait_s* gait, struct hpod_vector3_s* movement, int slices,
+                         struct hpod_gait_slice_s* shape, struct hpod_gait_angles_s* angles);
+
+int HPOD_gait_table_init_n(struct hpod_gait_table_s* table, struct hexapod_s* hexapod, int leg,
+                           struct hpod_gait_s* gait, struct hpod_vector3_s* movement, int slices,
+                           struct hpod_gait_slice_s* shape, struct hpod_gait_angles_s* angles);
+
+int HPOD_gait_table_set_movement(struct hpod_gait_table_s* table, struct hpod_vector3_s* movement);
+
+void HPOD_gait_table_calc(struct hpod_gait_table_s* table, float phase_scl, enum hpod_interp_e interp,
+                          struct hpod_vector3_s* leg_pos);
+
+int HPOD_gait_table_angles(struct hpod_gait_table_s* table, float phase_scl, enum hpod_interp_e interp,
+                           float* alpha, float* beta, float* theta);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
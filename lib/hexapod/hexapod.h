@@ -32,12 +32,21 @@ void HPOD_leg_ik2(struct hexapod_s* hexapod, float d, float h, float* alpha, flo
 int HPOD_leg_ik3(struct hexapod_s* hexapod, struct hpod_vector3_s *end_pos,
                   float* alpha, float* beta, float* theta);
 
+int HPOD_leg_ik3_n(struct hexapod_s* hexapod, int leg, struct hpod_vector3_s *end_pos,
+                   float* alpha, float* beta, float* theta);
+
 void HPOD_leg_fk2(struct hexapod_s* hexapod, float alpha, float beta,
                   float* x, float* h);
 
+void HPOD_leg_fk2_n(struct hexapod_s* hexapod, int leg, float alpha, float beta,
+                    float* x, float* h);
+
 void HPOD_leg_fk3(struct hexapod_s* hexapod, float alpha, float beta, float theta,
                   struct hpod_vector3_s *end_pos);
 
+void HPOD_leg_fk3_n(struct hexapod_s* hexapod, int leg, float alpha, float beta, float theta,
+                    struct hpod_vector3_s *end_pos);
+
 void HPOD_body_transform(struct hexapod_s* hexapod, float alpha, float beta, int offset_x, int offset_y,
                          struct hpod_vector3_s *world_pos, struct hpod_vector3_s *joint_pos);
 
@@ -47,8 +56,14 @@ void HPOD_world_roll_pitch(struct hexapod_s* hexapod, float angle, int offset,
 void HPOD_gait_calc(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
                     float phase_scl, struct hpod_vector3_s* leg_pos);
 
+void HPOD_gait_calc_leg(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
+                        float phase_scl, int leg, struct hpod_vector3_s* leg_pos);
+
 int HPOD_gait_valid(struct hexapod_s* hexapod, struct hpod_gait_s *gait);
 
+void HPOD_output_mix(struct hexapod_s *hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
+                     float phase_scl, float outputs[][3]);
+
 /** @}*/
 
 #ifdef __cplusplus
@@ -1,7 +1,7 @@
 /**
  * Libhexapod
  * @file
- * @brief Hexapod c++ wrapper
+ * @brief Header only C++ API
  *
  * https://github.com/ryankurte/libhexapod
  * Copyright 2017 Ryan Kurte
@@ -10,45 +10,313 @@
 #ifndef HEXAPOD_HPP
 #define HEXAPOD_HPP
 
+#include <math.h>
+
+#include <array>
+#include <optional>
+#include <utility>
+
 #include "hexapod/hexapod.h"
+#include "hexapod/fixed.h"
+#include "hexapod/scalar.hpp"
+#include "hexapod/gait_pattern.hpp"
 
 /** \defgroup Wrapper
- * @brief C++ Wrapper for libhexapod
+ * @brief C++17 API for libhexapod
+ * Templated on the scalar type (float, double or hpod::Q16) with the hexapod geometry and
+ * leg count as compile time parameters, so leg mounts and kinematic constants are constants
+ * and the per leg loops unroll. Values are passed and returned by value. float and double
+ * follow the C implementation in their own precision, Q16 uses the fixed point kernels from
+ * hexapod/fixed.h.
  * @{
  */
 
+namespace hpod
+{
+
+/**
+ * @brief Three component vector (X outwards from the body, Y forwards, Z up)
+ */
+template <typename T>
+struct Vec3 {
+    T x, y, z;
+
+    static constexpr Vec3 from(const struct hpod_vector3_s& v)
+    {
+        return {T(v.x), T(v.y), T(v.z)};
+    }
+
+    constexpr Vec3 operator+(Vec3 b) const
+    {
+        return {x + b.x, y + b.y, z + b.z};
+    }
+    constexpr Vec3 operator-(Vec3 b) const
+    {
+        return {x - b.x, y - b.y, z - b.z};
+    }
+    constexpr Vec3 operator*(T s) const
+    {
+        return {x * s, y * s, z * s};
+    }
+};
+
+/**
+ * @brief Joint angles (radians)
+ */
+template <typename T>
+struct Angles {
+    T alpha;    //!< Upper leg, wrt. the horizontal plane
+    T beta;     //!< Foreleg, wrt. the upper leg
+    T theta;    //!< Planar rotation at the body
+};
+
+/**
+ * @brief Gait, as struct hpod_gait_s with the leg schedule supplied as a template parameter
+ */
+template <typename T>
+struct Gait {
+    Vec3<T> movement;   //!< Dimensions of the leg movement box
+    Vec3<T> offset;     //!< Offset of the movement box
+    T height_scale;     //!< Leg lift offset as a factor of movement height
+    T yaw;              //!< Body rotation per stride at full rotational movement (radians)
+
+    static constexpr Gait from(const struct hpod_gait_s& g)
+    {
+        return {Vec3<T>::from(g.movement), Vec3<T>::from(g.offset), T(g.height_scale), T(g.yaw)};
+    }
+};
+
+/**
+ * @brief Leg mount position, as struct hpod_leg_mount_s
+ */
+template <typename T>
+struct Mount {
+    T x;        //!< Distance outwards from the body center to joint A
+    T y;        //!< Distance forwards from the body center to joint A
+    T side;     //!< Leg frame handedness, -1 for the mirrored (left) side
+};
+
+/**
+ * @brief Default geometry, matching HPOD_DEFAULT_CONFIG
+ * Geometries are types with the hexapod_config_s fields as static constexpr floats.
+ */
+struct DefaultGeometry {
+    static constexpr float length = 200;
+    static constexpr float width = 100;
+    static constexpr float offset_a = 45;
+    static constexpr float len_ab = 80;
+    static constexpr float len_bc = 150;
+};
+
+/**
+ * @brief C config for a geometry
+ */
+template <typename Geometry>
+constexpr struct hexapod_config_s geometry_config()
+{
+    return {Geometry::length, Geometry::width, Geometry::offset_a, Geometry::len_ab, Geometry::len_bc};
+}
+
+namespace detail
+{
+
+/**
+ * @brief Floating point leg kinematic constants, as struct hpod_kinematics_s
+ */
+template <typename T, typename Geometry>
+struct Kinematics {
+    static constexpr float reach_min_f = Geometry::len_ab > Geometry::len_bc ?
+                                         Geometry::len_ab - Geometry::len_bc : Geometry::len_bc - Geometry::len_ab;
+    static constexpr float reach_max_f = Geometry::len_ab + Geometry::len_bc;
+
+    static constexpr T offset_a = T(Geometry::offset_a);
+    static constexpr T len_ab = T(Geometry::len_ab);
+    static constexpr T len_bc = T(Geometry::len_bc);
+    static constexpr T len_ab_sq = T(Geometry::len_ab) * T(Geometry::len_ab);
+    static constexpr T len_bc_sq = T(Geometry::len_bc) * T(Geometry::len_bc);
+    static constexpr T inv_len_ab_2 = T(1) / (T(2) * T(Geometry::len_ab));
+    static constexpr T inv_len_ab_bc_2 = T(1) / (T(2) * T(Geometry::len_ab) * T(Geometry::len_bc));
+    static constexpr T reach_min_sq = T(reach_min_f) * T(reach_min_f);
+    static constexpr T reach_max_sq = T(reach_max_f) * T(reach_max_f);
+};
+
+// Fixed point kinematics use the C kernels, which hold the geometry
+struct Empty {
+};
+
+}
+
 /**
- * @brief Hexapod wrapper class
+ * @brief Hexapod
+ * Legs are ordered front to back, left then right, as in leg_offsets, and are evenly spaced
+ * along the body length. Gait schedules must have Legs legs.
  */
+template <typename T, typename Geometry = DefaultGeometry, int Legs = 6>
 class Hexapod
 {
 public:
+    static_assert(Legs >= 4 && Legs % 2 == 0, "legs must be mounted in left / right pairs");
+
+    using Math = hpod::Scalar<T>;
+    using Vec = Vec3<T>;
+
+    static constexpr int legs = Legs;
+
+    Hexapod()
+    {
+        if constexpr (is_fixed_v<T>) {
+            struct hexapod_config_s config = geometry_config<Geometry>();
+            HPOD_fx_init(&fx, &config);
+        }
+    }
 
-    void init(struct hexapod_config_s* config)
+    /** @brief Mount position of a leg, as computed by HPOD_init */
+    static constexpr Mount<T> mount(int leg)
     {
-        HPOD_init(&this->hexapod, config);
+        constexpr float spacing = Geometry::length / (Legs / 2 - 1);
+        return {T(Geometry::width / 2), T(Geometry::length / 2 - (leg / 2) * spacing), T(leg % 2 ? 1.0f : -1.0f)};
     }
 
-    void leg_ik3(float x, float y, float h, float* alpha, float* beta, float* theta)
+    /**
+     * @brief 3 Joint Arm Inverse Kinematics, see HPOD_leg_ik3
+     * Returns no angles for targets outside of the reach envelope
+     */
+    std::optional<Angles<T>> ik(Vec p) const
     {
-        HPOD_leg_ik3(&this->hexapod, x, y, h, alpha, beta, theta);
+        if constexpr (is_fixed_v<T>) {
+            struct hpod_fx_vector3_s end_pos = {p.x.raw, p.y.raw, p.z.raw};
+            hpod_q16_t alpha, beta, theta;
+            if (HPOD_fx_leg_ik3(const_cast<struct hpod_fx_s*>(&fx), &end_pos, &alpha, &beta, &theta) != 0) {
+                return std::nullopt;
+            }
+            return Angles<T> {T::from_raw(alpha), T::from_raw(beta), T::from_raw(theta)};
+        } else {
+            using K = detail::Kinematics<T, Geometry>;
+
+            T len_xy = Math::sqrt(p.x * p.x + p.y * p.y);
+            T angle_xy = Math::atan2(p.y, p.x);
+
+            T d = len_xy - K::offset_a;
+            T len_ac_sq = d * d + p.z * p.z;
+
+            if (!(len_ac_sq >= K::reach_min_sq && len_ac_sq <= K::reach_max_sq)) {
+                return std::nullopt;
+            }
+
+            T len_ac = Math::sqrt(len_ac_sq);
+            T angle_dh = Math::atan2(p.z, d);
+            T angle_a = Math::acos((len_ac_sq + K::len_ab_sq - K::len_bc_sq) * K::inv_len_ab_2 / len_ac);
+            T angle_b = Math::acos((K::len_ab_sq + K::len_bc_sq - len_ac_sq) * K::inv_len_ab_bc_2);
+
+            if (angle_a != angle_a || angle_b != angle_b) {
+                return std::nullopt;
+            }
+
+            return Angles<T> {angle_a + angle_dh, angle_b, angle_xy};
+        }
     }
 
-    void leg_fk3(float alpha, float beta, float theta, float* x, float* y, float* h)
+    /** @brief 3 Joint Arm Forward Kinematics, see HPOD_leg_fk3 */
+    Vec fk(Angles<T> a) const
     {
-        HPOD_leg_fk3(&this->hexapod, alpha, beta, theta, x, y, h);
+        if constexpr (is_fixed_v<T>) {
+            struct hpod_fx_vector3_s end_pos;
+            HPOD_fx_leg_fk3(const_cast<struct hpod_fx_s*>(&fx), a.alpha.raw, a.beta.raw, a.theta.raw, &end_pos);
+            return {T::from_raw(end_pos.x), T::from_raw(end_pos.y), T::from_raw(end_pos.z)};
+        } else {
+            using K = detail::Kinematics<T, Geometry>;
+
+            T c_d = K::len_ab * Math::cos(a.alpha) + K::len_bc * Math::cos(Math::pi - a.alpha - a.beta);
+            T c_h = K::len_ab * Math::sin(a.alpha) - K::len_bc * Math::sin(Math::pi - a.alpha - a.beta);
+            T r = K::offset_a + c_d;
+
+            return {r * Math::cos(a.theta), r * Math::sin(a.theta), c_h};
+        }
     }
 
-    void gait_calc(struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
-                   float phase, struct hpod_vector3_s* leg_pos)
+    /** @brief Position of a limb for a gait and movement at a walking phase, see HPOD_gait_calc */
+    static Vec gait(const Gait<T>& g, Vec movement, T phase_scl)
     {
-        HPOD_gait_calc(&this->hexapod, gait, movement, phase, leg_pos);
+        return gait_stride(g, movement, phase_scl).first;
+    }
+
+    /** @brief Position of a specific limb including rotation, see HPOD_gait_calc_leg */
+    template <int Leg>
+    static Vec gait_leg(const Gait<T>& g, Vec movement, T phase_scl)
+    {
+        static_assert(Leg >= 0 && Leg < Legs, "leg out of range");
+        constexpr Mount<T> m = mount(Leg);
+
+        auto [pos, stride] = gait_stride(g, movement, phase_scl);
+        T angle = stride * g.yaw * T(0.5f) * movement.z * m.side;
+
+        T foot_x = m.x + pos.x;
+        T foot_y = m.y + pos.y;
+
+        // sin(a) and cos(a) - 1 to fourth order, as HPOD_gait_calc_leg
+        T a_sq = angle * angle;
+        T sin_a = angle * (T(1.0f) - a_sq / T(6.0f) * (T(1.0f) - a_sq / T(20.0f)));
+        T cos_a_1 = -a_sq / T(2.0f) * (T(1.0f) - a_sq / T(12.0f));
+
+        pos.x += cos_a_1 * foot_x - sin_a * foot_y;
+        pos.y += sin_a * foot_x + cos_a_1 * foot_y;
+
+        return pos;
+    }
+
+    /**
+     * @brief Leg angles for every leg at a walking phase, see HPOD_output_mix
+     * Legs are unrolled at compile time, unreachable legs have no angles.
+     */
+    template <typename Schedule = Tripod>
+    std::array<std::optional<Angles<T>>, Legs> output(const Gait<T>& g, Vec movement, T phase_scl) const
+    {
+        static_assert(Schedule::legs == Legs, "schedule leg count must match the hexapod");
+        return output<Schedule>(g, movement, phase_scl, std::make_integer_sequence<int, Legs>{});
     }
 
 private:
-    struct hexapod_s hexapod;
+    template <typename Schedule, int... Leg>
+    std::array<std::optional<Angles<T>>, Legs> output(const Gait<T>& g, Vec movement, T phase_scl,
+                                                      std::integer_sequence<int, Leg...>) const
+    {
+        return {ik(gait_leg<Leg>(g, movement, Schedule::template phase<Leg, T>(phase_scl)))...};
+    }
+
+    /** @brief Gait translation and height, with the stride sine for rotation */
+    static std::pair<Vec, T> gait_stride(const Gait<T>& g, Vec movement, T phase_scl)
+    {
+        const T half = T(0.5f);
+
+        T phase = Math::wrap(phase_scl);
+        T stride = Math::sin(phase * Math::pi);
+        Vec pos;
+
+        pos.x = stride * g.movement.x * half * movement.x + g.offset.x;
+        pos.y = stride * g.movement.y * half * movement.y;
+
+        // Height morphing, as HPOD_gait_calc
+        T abs_phase = Math::abs(phase);
+        if (abs_phase < half) {
+            pos.z = -g.movement.z * half + g.offset.z;
+        } else if (abs_phase > half + g.height_scale) {
+            pos.z = g.movement.z * half + g.offset.z;
+        } else if (phase > T(0.0f)) {
+            pos.z = Math::cos((phase - half + g.height_scale) / g.height_scale * Math::pi)
+                    * g.movement.z * half + g.offset.z;
+        } else {
+            pos.z = Math::cos((phase + half - g.height_scale) / g.height_scale * Math::pi)
+                    * g.movement.z * half + g.offset.z;
+        }
+
+        return {pos, stride};
+    }
+
+    std::conditional_t<is_fixed_v<T>, struct hpod_fx_s, detail::Empty> fx;
 };
 
+}
+
 /** @}*/
 
 #endif
@@ -24,18 +24,56 @@ extern "C" {
  * @{
  */
 
+// Math routing
+// HPOD_FLOAT_ONLY keeps every operation in single precision for targets with a
+// float-only FPU, otherwise the double precision libm functions are used
+#ifdef HPOD_FLOAT_ONLY
+#define HPOD_PI                     3.14159265358979f
+#define HPOD_SQRT(a)                sqrtf(a)
+#define HPOD_ATAN2(y, x)            atan2f(y, x)
+#define HPOD_FMOD(a, b)             fmodf(a, b)
+#define HPOD_FABS(a)                fabsf(a)
+#define HPOD_SQ(a)                  ((a) * (a))
+#else
+#define HPOD_PI                     M_PI
+#define HPOD_SQRT(a)                sqrt(a)
+#define HPOD_ATAN2(y, x)            atan2(y, x)
+#define HPOD_FMOD(a, b)             fmod(a, b)
+#define HPOD_FABS(a)                fabs(a)
+#define HPOD_SQ(a)                  pow(a, 2)
+#endif
+
 // Helpers for degree <-> radian conversion
-#define HPOD_RAD_TO_DEG(a)          (a * 180 / M_PI)
-#define HPOD_DEG_TO_RAD(a)          (a * M_PI / 180)
+#define HPOD_RAD_TO_DEG(a)          (a * 180 / HPOD_PI)
+#define HPOD_DEG_TO_RAD(a)          (a * HPOD_PI / 180)
 
 // Helpers for scalar <-> radian conversion
 // Scalar ranges from -1 to 1 are used to represent angles to simplify floating point
 // methods and reduce error where possible
-#define HPOD_RAD_TO_SCL(a)          (a / M_PI)
-#define HPOD_SCL_TO_RAD(a)          (a * M_PI)
-#define HPOD_WRAP_SCL(a)            fmod(a, 1.0)
+#define HPOD_RAD_TO_SCL(a)          (a / HPOD_PI)
+#define HPOD_SCL_TO_RAD(a)          (a * HPOD_PI)
+#define HPOD_WRAP_SCL(a)            HPOD_FMOD(a, 1.0f)
 #define HPOD_LIMIT_RANGE(min, max, val)   ((val < min) ? min : (val > max) ? max : val)
 
+// Maximum number of legs on a hexapod instance
+#define HPOD_MAX_LEGS               8
+
+// Cache line size, for per leg data and fields shared between threads
+#define HPOD_CACHE_LINE             64
+
+/**
+ * Leg config object
+ * Mount position, orientation and links of a single leg
+ */
+struct hpod_leg_config_s {
+    float x;        //!< Joint A position right of the body center
+    float y;        //!< Joint A position forwards of the body center
+    float yaw;      //!< Leg frame rotation from straight outwards, positive towards the front (radians)
+    float offset_a; //!< Distance between planar and vertical shoulder joints, 0 for the shared value
+    float len_ab;   //!< Length of upper leg (femur), 0 for the shared value
+    float len_bc;   //!< Length of foreleg, 0 for the shared value
+};
+
 /**
  * Hexapod config object
  * This is used to configure the hexapod dimensions
@@ -46,17 +84,76 @@ struct hexapod_config_s {
     float offset_a; //!< Distance between planar and vertical shoulder joints
     float len_ab;   //!< Length of upper leg (femur)
     float len_bc;   //!< Length of foreleg
+    int legs;       //!< Number of legs in leg, 0 for six legs at the corners and sides of length x width
+    struct hpod_leg_config_s leg[HPOD_MAX_LEGS];    //!< Per leg mounts and links
 };
 
 // Default hexapod config for testing / convenience purposes
 #define HPOD_DEFAULT_CONFIG {200, 100, 45, 80, 150}
 
+/**
+ * Leg kinematic constants
+ * Derived from the hexapod config in HPOD_init so they are not recomputed per IK call
+ */
+struct hpod_kinematics_s {
+    float len_ab;           //!< Upper leg length
+    float len_bc;           //!< Foreleg length
+    float len_ab_sq;        //!< Upper leg length squared
+    float len_bc_sq;        //!< Foreleg length squared
+    float inv_len_ab_2;     //!< 1 / (2 * len_ab)
+    float inv_len_ab_bc_2;  //!< 1 / (2 * len_ab * len_bc)
+    float reach_min;        //!< Minimum reachable |AC| (|len_ab - len_bc|)
+    float reach_max;        //!< Maximum reachable |AC| (len_ab + len_bc)
+    float reach_min_sq;     //!< Minimum reachable |AC| squared
+    float reach_max_sq;     //!< Maximum reachable |AC| squared
+};
+
+/**
+ * Leg mount position
+ * Derived from the leg config in HPOD_init, relative to the body center in the leg frame (X
+ * outwards along the leg, Y forwards). The leg frame is rotated by the mount yaw from straight
+ * outwards and mirrored on the left side, so body frame positions are
+ * (side * (cos_yaw * x - sin_yaw * y), sin_yaw * x + cos_yaw * y).
+ */
+struct hpod_leg_mount_s {
+    float x;                //!< Distance outwards from the body center to joint A (width / 2 without yaw)
+    float y;                //!< Distance forwards from the body center to joint A
+    float side;             //!< Leg frame handedness, -1 for the mirrored (left) side
+    float cos_yaw;          //!< Cosine of the mount yaw
+    float sin_yaw;          //!< Sine of the mount yaw
+};
+
+/**
+ * Per leg constants
+ * One cache line per leg, so per leg loops touch contiguous lines whatever the topology
+ */
+struct hpod_leg_s {
+    struct hpod_leg_mount_s mount;
+    float offset_a;                     //!< Distance between planar and vertical shoulder joints
+    struct hpod_kinematics_s kinematics;
+} __attribute__((aligned(HPOD_CACHE_LINE)));
+
 /**
  * Hexapod object for internal use
  * This stores the context required to perform hexapod related calculations
  */
 struct hexapod_s {
     struct hexapod_config_s config;
+    struct hpod_kinematics_s kinematics;    //!< Shared leg constants, for single leg functions
+    int legs;                               //!< Number of legs
+    int uniform;                            //!< Every leg has the shared links and offset_a
+    int aligned;                            //!< No leg has a mount yaw
+    struct hpod_leg_s leg[HPOD_MAX_LEGS];
+};
+
+/**
+ * Gait pattern (leg phase schedule)
+ * Each leg walks the same path, shifted in phase by its offset, with contact compressed or
+ * stretched to the duty factor (see HPOD_gait_pattern_phase)
+ */
+struct hpod_gait_pattern_s {
+    float offset[HPOD_MAX_LEGS];        //!< Leg phase offsets (0 to 2, in units of phase)
+    float duty;                         //!< Fraction of the cycle each leg is in contact (0 to 1)
 };
 
 /**
@@ -66,27 +163,31 @@ struct hpod_gait_s {
     struct hpod_vector3_s movement;     //!< Defines dimensions of leg movement box
     struct hpod_vector3_s offset;       //!< Defines offset of movement box
     float height_scale;                 //!< Defines leg lift offset as a factor of movement height
+    float yaw;                          //!< Body rotation per stride at full rotational movement (radians)
+    struct hpod_gait_pattern_s pattern; //!< Leg phase schedule
 };
 
 // Default gait for testing / convenience purposes
 #define HPOD_DEFAULT_MOVEMENT {100.0, 200.0, 20.0}
 #define HPOD_DEFAULT_OFFSET {150.0, 0.0, -70.0}
 #define HPOD_DEFAULT_LIFT_SCALE 0.1
-#define HPOD_DEFAULT_GAIT {HPOD_DEFAULT_MOVEMENT, HPOD_DEFAULT_OFFSET, HPOD_DEFAULT_LIFT_SCALE}
+#define HPOD_DEFAULT_YAW 0.4
+#define HPOD_DEFAULT_PATTERN {{0.0, 1.0, 1.0, 0.0, 0.0, 1.0}, 0.5}
+#define HPOD_DEFAULT_GAIT {HPOD_DEFAULT_MOVEMENT, HPOD_DEFAULT_OFFSET, HPOD_DEFAULT_LIFT_SCALE, HPOD_DEFAULT_YAW, \
+                           HPOD_DEFAULT_PATTERN}
 
 /**
  * Leg offset structure
- * Used for computation of leg offsets in output calculation
+ * Default six leg layout, used when the config does not provide legs
  */
 struct leg_offset_s {
-    int phase;
     int x;
     int y;
 };
 
 // Leg location multipliers
-// Phase modifier, X offset, Y offset
-extern struct leg_offset_s leg_offsets[6];
+// X offset, Y offset
+extern const struct leg_offset_s leg_offsets[6];
 
 #ifdef __cplusplus
 }
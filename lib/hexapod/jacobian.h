@@ -0,0 +1,89 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Leg Jacobian and velocity level inverse kinematics
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_JACOBIAN_H
+#define HEXAPOD_JACOBIAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/hexapod.h"
+
+/** \defgroup Jacobian
+ * @brief Differential kinematics for high rate control loops
+ * Joint velocities are solved from a desired foot velocity at the current joint angles,
+ * so a control loop can integrate small steps without re-solving the full IK each tick.
+ * @{
+ */
+
+// Default damping factor (mm) for the damped least squares fallback
+#define HPOD_JACOBIAN_DEFAULT_DAMPING   5.0f
+
+/**
+ * @brief Velocity IK solution type
+ */
+enum hpod_velocity_e {
+    HPOD_VELOCITY_EXACT = 0,        //!< Exact inverse of the Jacobian
+    HPOD_VELOCITY_DAMPED = 1,       //!< Damped least squares near a singularity
+};
+
+// Default warm start solver limits
+#define HPOD_IK_DEFAULT_ITERATIONS      4
+#define HPOD_IK_DEFAULT_TOLERANCE       0.01f
+
+/**
+ * @brief Warm started IK solver context
+ * Holds the previous solution for a single leg, plus solver statistics
+ */
+struct hpod_ik_context_s {
+    int leg;                    //!< Leg solved, -1 for the shared links
+    float alpha;                //!< Previous solution
+    float beta;
+    float theta;
+    int valid;                  //!< Previous solution is usable as a warm start
+    int max_iterations;         //!< Newton step limit before falling back to the analytic solve
+    float tolerance;            //!< Foot position tolerance (mm)
+    int iterations;             //!< Newton steps used by the last solve
+    uint32_t solves;            //!< Total solves
+    uint32_t fallbacks;         //!< Solves that used the analytic IK
+};
+
+void HPOD_leg_jacobian(struct hexapod_s* hexapod, float alpha, float beta, float theta,
+                       float jacobian[3][3]);
+
+void HPOD_leg_jacobian_n(struct hexapod_s* hexapod, int leg, float alpha, float beta, float theta,
+                         float jacobian[3][3]);
+
+int HPOD_leg_ik3_velocity(struct hexapod_s* hexapod, float alpha, float beta, float theta,
+                          struct hpod_vector3_s* velocity, float damping,
+                          float* d_alpha, float* d_beta, float* d_theta);
+
+int HPOD_leg_ik3_velocity_n(struct hexapod_s* hexapod, int leg, float alpha, float beta, float theta,
+                            struct hpod_vector3_s* velocity, float damping,
+                            float* d_alpha, float* d_beta, float* d_theta);
+
+void HPOD_ik_context_init(struct hpod_ik_context_s* ctx, int max_iterations, float tolerance);
+
+void HPOD_ik_context_init_n(struct hpod_ik_context_s* ctx, int leg, int max_iterations, float tolerance);
+
+int HPOD_leg_ik3_warm(struct hexapod_s* hexapod, struct hpod_ik_context_s* ctx,
+                      struct hpod_vector3_s* end_pos, float* alpha, float* beta, float* theta);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
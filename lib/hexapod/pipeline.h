@@ -0,0 +1,50 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Full body control pipeline
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_PIPELINE_H
+#define HEXAPOD_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/servo.h"
+#include "hexapod/body_pose.h"
+
+/** \defgroup Pipeline
+ * @brief Gait, body transform, IK and servo scaling in a single call
+ * @{
+ */
+
+/**
+ * @brief Pipeline intermediate results
+ * Provided by the caller and written once per leg, for telemetry and debugging
+ */
+struct hpod_pipeline_scratch_s {
+    struct hpod_vector3_s gait_pos[HPOD_MAX_LEGS];  //!< Foot positions from the gait
+    struct hpod_vector3_s joint_pos[HPOD_MAX_LEGS]; //!< Foot positions in the leg joint frame
+    float angles[HPOD_MAX_LEGS][3];                 //!< Joint angles (alpha, beta, theta)
+    uint8_t valid[HPOD_MAX_LEGS];                   //!< IK succeeded for the leg
+};
+
+int HPOD_pipeline(struct hexapod_s *hexapod, struct hpod_gait_s *gait, struct hpod_servo_s *servo,
+                  struct hpod_body_transform_s *transform, struct hpod_vector3_s *movement, float phase_scl,
+                  struct hpod_pipeline_scratch_s *scratch, int out[][3]);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
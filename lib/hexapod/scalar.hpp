@@ -0,0 +1,224 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Scalar types and math for the C++ API
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_SCALAR_HPP
+#define HEXAPOD_SCALAR_HPP
+
+#include <math.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "hexapod/fixed.h"
+
+/** \defgroup Scalar
+ * @brief Scalar types supported by the C++ API
+ * float and double use libm in their own precision, Q16 wraps the Q16.16 fixed point
+ * type and CORDIC routines from hexapod/fixed.h.
+ * @{
+ */
+
+namespace hpod
+{
+
+/**
+ * @brief Q16.16 fixed point value
+ * Products and quotients use 64-bit intermediates, so operands must fit Q16.16 (+-32767)
+ * as in hexapod/fixed.h.
+ */
+struct Q16 {
+    hpod_q16_t raw;
+
+    constexpr Q16() : raw(0) {}
+    constexpr explicit Q16(float a) : raw(HPOD_Q16_FROM_FLOAT(a)) {}
+    constexpr explicit Q16(int a) : raw(a * HPOD_Q16_ONE) {}
+
+    static constexpr Q16 from_raw(hpod_q16_t raw)
+    {
+        Q16 q;
+        q.raw = raw;
+        return q;
+    }
+
+    constexpr explicit operator float() const
+    {
+        return HPOD_Q16_TO_FLOAT(raw);
+    }
+
+    constexpr Q16 operator-() const
+    {
+        return from_raw(-raw);
+    }
+    constexpr Q16 operator+(Q16 b) const
+    {
+        return from_raw(raw + b.raw);
+    }
+    constexpr Q16 operator-(Q16 b) const
+    {
+        return from_raw(raw - b.raw);
+    }
+    constexpr Q16 operator*(Q16 b) const
+    {
+        return from_raw(HPOD_Q16_MUL(raw, b.raw));
+    }
+    constexpr Q16 operator/(Q16 b) const
+    {
+        return from_raw((hpod_q16_t)(((int64_t)raw * HPOD_Q16_ONE) / b.raw));
+    }
+
+    Q16& operator+=(Q16 b)
+    {
+        raw += b.raw;
+        return *this;
+    }
+    Q16& operator-=(Q16 b)
+    {
+        raw -= b.raw;
+        return *this;
+    }
+
+    constexpr bool operator<(Q16 b) const
+    {
+        return raw < b.raw;
+    }
+    constexpr bool operator>(Q16 b) const
+    {
+        return raw > b.raw;
+    }
+    constexpr bool operator<=(Q16 b) const
+    {
+        return raw <= b.raw;
+    }
+    constexpr bool operator>=(Q16 b) const
+    {
+        return raw >= b.raw;
+    }
+    constexpr bool operator==(Q16 b) const
+    {
+        return raw == b.raw;
+    }
+    constexpr bool operator!=(Q16 b) const
+    {
+        return raw != b.raw;
+    }
+};
+
+/**
+ * @brief Scalar math, specialised per scalar type
+ */
+template <typename T>
+struct Scalar;
+
+template <>
+struct Scalar<float> {
+    static constexpr float pi = 3.14159265358979f;
+
+    static float sqrt(float a)
+    {
+        return sqrtf(a);
+    }
+    static float atan2(float y, float x)
+    {
+        return atan2f(y, x);
+    }
+    static float acos(float a)
+    {
+        return acosf(a);
+    }
+    static float sin(float a)
+    {
+        return sinf(a);
+    }
+    static float cos(float a)
+    {
+        return cosf(a);
+    }
+    static float abs(float a)
+    {
+        return fabsf(a);
+    }
+    /** @brief Wrap a phase into -1 to 1 */
+    static float wrap(float a)
+    {
+        return fmodf(a + 3.0f, 2.0f) - 1.0f;
+    }
+};
+
+template <>
+struct Scalar<double> {
+    static constexpr double pi = M_PI;
+
+    static double sqrt(double a)
+    {
+        return ::sqrt(a);
+    }
+    static double atan2(double y, double x)
+    {
+        return ::atan2(y, x);
+    }
+    static double acos(double a)
+    {
+        return ::acos(a);
+    }
+    static double sin(double a)
+    {
+        return ::sin(a);
+    }
+    static double cos(double a)
+    {
+        return ::cos(a);
+    }
+    static double abs(double a)
+    {
+        return fabs(a);
+    }
+    static double wrap(double a)
+    {
+        return fmod(a + 3.0, 2.0) - 1.0;
+    }
+};
+
+template <>
+struct Scalar<Q16> {
+    static constexpr Q16 pi = Q16::from_raw(HPOD_Q16_PI);
+
+    static Q16 atan2(Q16 y, Q16 x)
+    {
+        return Q16::from_raw(HPOD_fx_atan2(y.raw, x.raw));
+    }
+    static Q16 sin(Q16 a)
+    {
+        hpod_q16_t s, c;
+        HPOD_fx_sincos(a.raw, &s, &c);
+        return Q16::from_raw(s);
+    }
+    static Q16 cos(Q16 a)
+    {
+        hpod_q16_t s, c;
+        HPOD_fx_sincos(a.raw, &s, &c);
+        return Q16::from_raw(c);
+    }
+    static Q16 abs(Q16 a)
+    {
+        return a.raw < 0 ? -a : a;
+    }
+    static Q16 wrap(Q16 a)
+    {
+        return Q16::from_raw((a.raw + 3 * HPOD_Q16_ONE) % (2 * HPOD_Q16_ONE) - HPOD_Q16_ONE);
+    }
+};
+
+template <typename T>
+constexpr bool is_fixed_v = std::is_same<T, Q16>::value;
+
+}
+
+/** @}*/
+
+#endif
@@ -17,6 +17,8 @@ extern "C" {
 #include <stdlib.h>
 #include <stdint.h>
 
+#include "hexapod/hexapod_defs.h"
+
 /** \defgroup Servo
  * @brief Servo output adaption
  * @{
@@ -33,9 +35,45 @@ struct hpod_servo_s {
     float scale;        //!< Servo scale factor
 };
 
+// Maximum number of servo channels (three joints per leg), channel = leg * 3 + joint
+#define HPOD_SERVO_CHANNELS     (HPOD_MAX_LEGS * 3)
+
+/**
+ * @brief Per joint servo calibration
+ */
+struct hpod_servo_cal_s {
+    float trim;         //!< Angle offset (radians) added to the joint angle
+    int direction;      //!< Rotation direction (1 or -1)
+    float gain;         //!< Gain correction applied to the nominal scale
+    float min;          //!< Soft limit minimum (radians, after trim)
+    float max;          //!< Soft limit maximum (radians, after trim)
+    int center;         //!< Output count at zero angle
+};
+
+/**
+ * @brief Servo calibration table
+ * Structure of arrays across all channels so the mixing kernel can be vectorised
+ */
+struct hpod_servo_table_s {
+    int legs;           //!< Legs in use, mixing covers channels 0 to legs * 3 - 1
+    float trim[HPOD_SERVO_CHANNELS];
+    float min[HPOD_SERVO_CHANNELS];
+    float max[HPOD_SERVO_CHANNELS];
+    float scale[HPOD_SERVO_CHANNELS];   //!< Counts per radian including direction and gain
+    float center[HPOD_SERVO_CHANNELS];
+};
+
 void HPOD_servo_init(struct hpod_servo_s *servo, float range_rads, int output_range, int output_offset);
 int HPOD_servo_scale(struct hpod_servo_s *servo, float angle);
-void HPOD_servo_mix(struct hpod_servo_s *servo, float in[6][3], int out[6][3]);
+void HPOD_servo_mix(struct hpod_servo_s *servo, int legs, float in[][3], int out[][3]);
+
+void HPOD_servo_table_init(struct hpod_servo_table_s *table, struct hpod_servo_s *servo, int legs);
+void HPOD_servo_table_set(struct hpod_servo_table_s *table, struct hpod_servo_s *servo, int channel,
+                          struct hpod_servo_cal_s *cal);
+void HPOD_servo_table_center(struct hpod_servo_table_s *table, int out[][3]);
+void HPOD_servo_table_mix(struct hpod_servo_table_s *table, float in[][3], int out[][3]);
+void HPOD_servo_table_pack_u16le(struct hpod_servo_table_s *table, float in[][3],
+                                 uint8_t *frame, int stride);
 
 /** @}*/
 
@@ -0,0 +1,96 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Servo bus frame encoding
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_SERVO_FRAME_H
+#define HEXAPOD_SERVO_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/servo.h"
+
+/** \defgroup ServoFrame
+ * @brief Encoding of servo outputs into serial servo bus frames
+ * Frames are written into a caller supplied buffer (which may be a DMA buffer). All fixed
+ * fields (headers, servo IDs, separators) are written once by HPOD_servo_frame_init, so
+ * each tick only overwrites the position fields and checksum in place. A whole frame is
+ * then handed to the transport in a single write.
+ * @{
+ */
+
+/**
+ * @brief Supported wire formats
+ */
+enum hpod_servo_format_e {
+    HPOD_SERVO_FORMAT_DXL1 = 0,     //!< Dynamixel protocol 1.0 sync write of goal positions
+    HPOD_SERVO_FORMAT_SSC32 = 1,    //!< SSC-32 ASCII group move ("#<ch>P<pw>...\r")
+};
+
+// Dynamixel protocol 1.0 fields
+#define HPOD_DXL1_BROADCAST_ID      0xFE
+#define HPOD_DXL1_SYNC_WRITE        0x83
+#define HPOD_DXL1_GOAL_POSITION     0x1E
+#define HPOD_DXL1_HEADER_LENGTH     7       //!< FF FF ID LEN INSTR ADDR DATA_LEN
+#define HPOD_DXL1_CHANNEL_LENGTH    3       //!< ID POS_L POS_H
+#define HPOD_DXL1_FRAME_LENGTH(channels)    (HPOD_DXL1_HEADER_LENGTH + \
+                                             (channels) * HPOD_DXL1_CHANNEL_LENGTH + 1)
+
+// SSC-32 fields, pulse widths are written as four fixed width digits
+#define HPOD_SSC32_MAX_CHANNEL      31
+#define HPOD_SSC32_CHANNEL_LENGTH   8       //!< "#nnPpppp"
+#define HPOD_SSC32_FRAME_LENGTH(channels)   ((channels) * HPOD_SSC32_CHANNEL_LENGTH + 1)
+
+// Buffer size sufficient for any supported format and leg count
+#define HPOD_SERVO_FRAME_MAX        HPOD_SSC32_FRAME_LENGTH(HPOD_SERVO_CHANNELS)
+
+/**
+ * @brief Servo frame encoder
+ * Holds the buffer layout for a single format, along with the last output counts which
+ * are held for NaN (unsolved) joints.
+ */
+struct hpod_servo_frame_s {
+    enum hpod_servo_format_e format;
+    int legs;                   //!< Legs in the frame, with channels 0 to legs * 3 - 1
+    uint8_t *buffer;            //!< Frame buffer (caller owned)
+    int length;                 //!< Encoded frame length
+    int counts[HPOD_MAX_LEGS][3];   //!< Last output counts
+};
+
+/**
+ * @brief Servo transport interface
+ * write must send the whole frame, returning 0 on success or a negative value on error.
+ */
+struct hpod_servo_transport_s {
+    int (*write)(void *ctx, const uint8_t *data, int length);
+    void *ctx;
+};
+
+int HPOD_servo_frame_init(struct hpod_servo_frame_s *frame, enum hpod_servo_format_e format, int legs,
+                          const uint8_t ids[], int center, uint8_t *buffer, int size);
+
+int HPOD_servo_frame_encode(struct hpod_servo_frame_s *frame, int counts[][3]);
+
+int HPOD_servo_frame_encode_table(struct hpod_servo_frame_s *frame, struct hpod_servo_table_s *table,
+                                  float in[][3]);
+
+int HPOD_servo_frame_send(struct hpod_servo_frame_s *frame, struct hpod_servo_transport_s *transport);
+
+void HPOD_servo_transport_fd(struct hpod_servo_transport_s *transport, int *fd);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
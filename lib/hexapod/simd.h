@@ -0,0 +1,53 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Vectorised kinematics kernels
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_SIMD_H
+#define HEXAPOD_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+
+/** \defgroup SIMD
+ * @brief 4 and 8 wide kinematics kernels using fast math approximations
+ * Kernels are selected at runtime, see hexapod/fastmath.h for approximation errors.
+ * @{
+ */
+
+/**
+ * @brief Kernel selection
+ */
+enum hpod_simd_e {
+    HPOD_SIMD_AUTO = 0,     //!< Widest kernel supported by the running CPU
+    HPOD_SIMD_SCALAR = 1,   //!< Scalar libm implementation (HPOD_leg_ik2 / HPOD_leg_fk2)
+    HPOD_SIMD_X4 = 4,       //!< 4 lanes per instruction
+    HPOD_SIMD_X8 = 8,       //!< 8 lanes per instruction
+};
+
+int HPOD_simd_supported(enum hpod_simd_e mode);
+enum hpod_simd_e HPOD_simd_select(enum hpod_simd_e mode);
+
+int HPOD_leg_ik2_simd(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                      float* alpha, float* beta);
+
+int HPOD_leg_fk2_simd(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                      float* x, float* h);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
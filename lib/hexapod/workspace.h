@@ -0,0 +1,79 @@
+/**
+ * Libhexapod
+ * @file
+ * @brief Precomputed leg workspace map
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_WORKSPACE_H
+#define HEXAPOD_WORKSPACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hexapod/hexapod_defs.h"
+#include "hexapod/gait_search.h"
+
+/** \defgroup Workspace
+ * @brief Constant time foot reachability and boundary margin queries
+ * Legs are rotationally symmetric about the theta joint, so reachability is stored as a
+ * signed distance field over the leg plane (planar radius, height), with theta limits
+ * evaluated analytically. Maps have a fixed size and contain no pointers, so they can be
+ * stored and loaded with HPOD_workspace_serialise / HPOD_workspace_deserialise.
+ * @{
+ */
+
+// Workspace grid nodes in each axis
+#define HPOD_WORKSPACE_NODES        128
+
+// Serialised format identifiers
+#define HPOD_WORKSPACE_MAGIC        0x44505748      // "HWPD"
+#define HPOD_WORKSPACE_VERSION      1
+
+/**
+ * @brief Leg workspace map
+ * margin holds the signed distance (in margin_scale mm units) from each grid node to the
+ * reachable boundary, positive inside, saturating at +-127.
+ */
+struct hpod_workspace_s {
+    uint32_t magic;
+    uint32_t version;
+    float r_min;                //!< Planar radius of the first node column (mm)
+    float z_min;                //!< Height of the first node row (mm)
+    float cell;                 //!< Node spacing (mm)
+    float inv_cell;             //!< 1 / cell
+    float margin_scale;         //!< Millimetres per margin unit
+    int32_t theta_limited;      //!< Theta limits are applied
+    float theta_min_sin, theta_min_cos;
+    float theta_max_sin, theta_max_cos;
+    int8_t margin[HPOD_WORKSPACE_NODES][HPOD_WORKSPACE_NODES];  //!< [z][r]
+    uint32_t checksum;          //!< FNV-1a of all preceding bytes, set when serialised
+};
+
+int HPOD_workspace_build(struct hpod_workspace_s* ws, struct hexapod_s* hexapod,
+                         struct hpod_joint_limits_s* limits);
+
+int HPOD_workspace_build_n(struct hpod_workspace_s* ws, struct hexapod_s* hexapod, int leg,
+                           struct hpod_joint_limits_s* limits);
+
+float HPOD_workspace_margin(struct hpod_workspace_s* ws, struct hpod_vector3_s* pos);
+
+int HPOD_workspace_reachable(struct hpod_workspace_s* ws, struct hpod_vector3_s* pos);
+
+int HPOD_workspace_serialise(struct hpod_workspace_s* ws, uint8_t* buffer, int length);
+
+int HPOD_workspace_deserialise(struct hpod_workspace_s* ws, const uint8_t* buffer, int length);
+
+/** @}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * Libhexapod
+ * Hexapod batched kinematics
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/batch.h"
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief Batched 3 Joint Arm Inverse Kinematics for a set of leg constants
+ * Geometry is loaded once before the loop and the loop body is branch free, so it can
+ * be auto-vectorised. Unreachable targets have NaN angles and a zero valid flag.
+ */
+static inline int leg_ik3_batch(const struct hpod_kinematics_s* k, float offset_a, int count,
+                                const float* restrict x, const float* restrict y, const float* restrict z,
+                                float* restrict alpha, float* restrict beta, float* restrict theta,
+                                uint8_t* restrict valid)
+{
+    // Load geometry into locals so the loop holds no struct dereferences
+    const float len_ab_sq = k->len_ab_sq;
+    const float len_bc_sq = k->len_bc_sq;
+    const float inv_2_ab = k->inv_len_ab_2;
+    const float inv_2_ab_bc = k->inv_len_ab_bc_2;
+    const float reach_min_sq = k->reach_min_sq;
+    const float reach_max_sq = k->reach_max_sq;
+
+    int solved = 0;
+
+    for (int i = 0; i < count; i++) {
+        // Planar distance from joint A to the end position
+        float d = sqrtf(x[i] * x[i] + y[i] * y[i]) - offset_a;
+        float h = z[i];
+
+        // Length between A & C
+        float len_ac_sq = d * d + h * h;
+        float len_ac = sqrtf(len_ac_sq);
+
+        // Cosine rule for the two triangles sharing face AC
+        float cos_a = (len_ac_sq + len_ab_sq - len_bc_sq) * inv_2_ab / len_ac;
+        float cos_b = (len_ab_sq + len_bc_sq - len_ac_sq) * inv_2_ab_bc;
+
+        // Solutions exist only inside the reach envelope (false for NaN), the same test as
+        // HPOD_leg_ik3 so both agree on validity at the boundary
+        int ok = (len_ac_sq >= reach_min_sq) & (len_ac_sq <= reach_max_sq) & (len_ac_sq > 0.0f);
+
+        // Clamp so acosf is always evaluated in its domain, including rounding at the envelope
+        cos_a = fminf(fmaxf(cos_a, -1.0f), 1.0f);
+        cos_b = fminf(fmaxf(cos_b, -1.0f), 1.0f);
+
+        float a = acosf(cos_a) + atan2f(h, d);
+        float b = acosf(cos_b);
+        float t = atan2f(y[i], x[i]);
+
+        alpha[i] = ok ? a : NAN;
+        beta[i] = ok ? b : NAN;
+        theta[i] = ok ? t : NAN;
+        valid[i] = (uint8_t) ok;
+
+        solved += ok;
+    }
+
+    return solved;
+}
+
+/**
+ * @brief Batched 3 Joint Arm Inverse Kinematics
+ * Solves count legs from structure-of-arrays end positions, equivalent to calling
+ * HPOD_leg_ik3 for each element. Legs from any number of hexapods sharing the same
+ * configuration may be packed into the same arrays.
+ * Uses the shared leg geometry, so returns -1 for hexapods without uniform legs, use
+ * HPOD_leg_ik3_batch_n for those. Otherwise returns the number of legs with valid solutions.
+ */
+int HPOD_leg_ik3_batch(struct hexapod_s* hexapod, int count,
+                       const float* restrict x, const float* restrict y, const float* restrict z,
+                       float* restrict alpha, float* restrict beta, float* restrict theta,
+                       uint8_t* restrict valid)
+{
+    if (!hexapod->uniform) {
+        return -1;
+    }
+
+    return leg_ik3_batch(&hexapod->kinematics, hexapod->config.offset_a, count,
+                         x, y, z, alpha, beta, theta, valid);
+}
+
+/**
+ * @brief Batched 3 Joint Arm Inverse Kinematics for a specific leg
+ * As HPOD_leg_ik3_batch, using the links of the provided leg, equivalent to calling
+ * HPOD_leg_ik3_n for each element.
+ */
+int HPOD_leg_ik3_batch_n(struct hexapod_s* hexapod, int leg, int count,
+                         const float* restrict x, const float* restrict y, const float* restrict z,
+                         float* restrict alpha, float* restrict beta, float* restrict theta,
+                         uint8_t* restrict valid)
+{
+    struct hpod_leg_s *l = &hexapod->leg[leg];
+
+    return leg_ik3_batch(&l->kinematics, l->offset_a, count, x, y, z, alpha, beta, theta, valid);
+}
@@ -0,0 +1,106 @@
+/**
+ * Libhexapod
+ * Hexapod rigid body pose transform
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/body_pose.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+
+/**
+ * @brief Build the body transform for a pose
+ * Computes rotation = Rz(yaw) * Rx(pitch) * Ry(-roll), this is the only place the pose
+ * angles are evaluated, so should be called once per tick.
+ */
+void HPOD_body_pose_init(struct hpod_body_transform_s* transform, struct hpod_body_pose_s* pose)
+{
+    const float sr = sinf(pose->roll), cr = cosf(pose->roll);
+    const float sp = sinf(pose->pitch), cp = cosf(pose->pitch);
+    const float sy = sinf(pose->yaw), cy = cosf(pose->yaw);
+
+    // Pitch then roll, Rx(pitch) * Ry(-roll)
+    const float pr[3][3] = {
+        {cr, 0.0f, -sr},
+        {-sp * sr, cp, -sp * cr},
+        {cp * sr, sp, cp * cr},
+    };
+
+    // Yaw about Z
+    for (int j = 0; j < 3; j++) {
+        transform->rotation[0][j] = cy * pr[0][j] - sy * pr[1][j];
+        transform->rotation[1][j] = sy * pr[0][j] + cy * pr[1][j];
+        transform->rotation[2][j] = pr[2][j];
+    }
+
+    transform->position = pose->position;
+}
+
+/**
+ * @brief Calculate hip (joint A) positions in the stance frame for a body transform
+ * hips must have hexapod->legs entries.
+ */
+void HPOD_body_pose_hips(struct hexapod_s* hexapod, struct hpod_body_transform_s* transform,
+                         struct hpod_vector3_s hips[])
+{
+    float (*r)[3] = transform->rotation;
+
+    for (int i = 0; i < hexapod->legs; i++) {
+        struct hpod_leg_mount_s* mount = &hexapod->leg[i].mount;
+        float x = mount->side * (mount->cos_yaw * mount->x - mount->sin_yaw * mount->y);
+        float y = mount->sin_yaw * mount->x + mount->cos_yaw * mount->y;
+
+        hips[i].x = r[0][0] * x + r[0][1] * y + transform->position.x;
+        hips[i].y = r[1][0] * x + r[1][1] * y + transform->position.y;
+        hips[i].z = r[2][0] * x + r[2][1] * y + transform->position.z;
+    }
+}
+
+/**
+ * @brief Transform a single leg foot target from the neutral stance into its leg joint frame
+ * As HPOD_body_pose_apply for one leg, for callers that process legs one at a time.
+ */
+void HPOD_body_pose_apply_leg(struct hexapod_s* hexapod, struct hpod_body_transform_s* transform, int leg,
+                              const struct hpod_vector3_s* foot, struct hpod_vector3_s* joint)
+{
+    float (*r)[3] = transform->rotation;
+    struct hpod_leg_mount_s* mount = &hexapod->leg[leg].mount;
+    float c = mount->cos_yaw, s = mount->sin_yaw;
+
+    // Foot relative to the body center in the stance frame
+    float fx = mount->x + foot->x, fy = mount->y + foot->y;
+    float sx = mount->side * (c * fx - s * fy) - transform->position.x;
+    float sy = s * fx + c * fy - transform->position.y;
+    float sz = foot->z - transform->position.z;
+
+    // Into the body frame by the transpose
+    float bx = r[0][0] * sx + r[1][0] * sy + r[2][0] * sz;
+    float by = r[0][1] * sx + r[1][1] * sy + r[2][1] * sz;
+    float bz = r[0][2] * sx + r[1][2] * sy + r[2][2] * sz;
+
+    // Relative to the hip, in the (mirrored and rotated) leg frame
+    bx = mount->side * bx;
+    joint->x = c * bx + s * by - mount->x;
+    joint->y = c * by - s * bx - mount->y;
+    joint->z = bz;
+}
+
+/**
+ * @brief Transform foot targets from the neutral stance into the leg joint frames of a posed body
+ * Feet are provided per leg in the joint frame of the neutral stance (as from
+ * HPOD_gait_calc_leg), and are held fixed in the stance frame while the body moves, so the
+ * resulting joint frame targets can be passed to HPOD_leg_ik3_n. feet and joints have
+ * hexapod->legs entries and may alias.
+ */
+void HPOD_body_pose_apply(struct hexapod_s* hexapod, struct hpod_body_transform_s* transform,
+                          const struct hpod_vector3_s feet[], struct hpod_vector3_s joints[])
+{
+    for (int i = 0; i < hexapod->legs; i++) {
+        HPOD_body_pose_apply_leg(hexapod, transform, i, &feet[i], &joints[i]);
+    }
+}
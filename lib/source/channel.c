@@ -0,0 +1,129 @@
+/**
+ * Libhexapod
+ * Lock free command and telemetry channels
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/channel.h"
+
+#include <stdint.h>
+
+// Set in the shared mailbox index when it holds a command the consumer has not fetched
+#define MAILBOX_FRESH           0x4
+#define MAILBOX_INDEX(a)        ((a) & 0x3)
+
+#define RING_MASK               (HPOD_TELEMETRY_SLOTS - 1)
+
+/**
+ * @brief Initialise a command mailbox, all buffers start with the initial command
+ */
+void HPOD_mailbox_init(struct hpod_mailbox_s *mailbox, struct hpod_command_s *initial)
+{
+    for (int i = 0; i < 3; i++) {
+        mailbox->buffers[i] = *initial;
+    }
+
+    mailbox->write = 0;
+    mailbox->read = 1;
+    __atomic_store_n(&mailbox->shared, 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Publish a command (producer)
+ * Replaces any command the consumer has not yet fetched. Wait free.
+ */
+void HPOD_mailbox_publish(struct hpod_mailbox_s *mailbox, struct hpod_command_s *command)
+{
+    mailbox->buffers[mailbox->write] = *command;
+
+    // Hand the written buffer over and take back whichever buffer was waiting
+    uint32_t prev = __atomic_exchange_n(&mailbox->shared, mailbox->write | MAILBOX_FRESH, __ATOMIC_ACQ_REL);
+    mailbox->write = MAILBOX_INDEX(prev);
+}
+
+/**
+ * @brief Fetch the latest command (consumer)
+ * Returns the most recently published command, which remains valid and unchanged until the
+ * next fetch. updated (if not NULL) is set when a new command was received. Wait free.
+ */
+struct hpod_command_s *HPOD_mailbox_fetch(struct hpod_mailbox_s *mailbox, int *updated)
+{
+    int fresh = (__atomic_load_n(&mailbox->shared, __ATOMIC_RELAXED) & MAILBOX_FRESH) != 0;
+
+    if (fresh) {
+        uint32_t prev = __atomic_exchange_n(&mailbox->shared, mailbox->read, __ATOMIC_ACQ_REL);
+        mailbox->read = MAILBOX_INDEX(prev);
+    }
+
+    if (updated != NULL) {
+        *updated = fresh;
+    }
+
+    return &mailbox->buffers[mailbox->read];
+}
+
+/**
+ * @brief Initialise an empty telemetry ring
+ */
+void HPOD_telemetry_init(struct hpod_telemetry_ring_s *ring)
+{
+    ring->dropped = 0;
+    __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->tail, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Claim the next telemetry slot (producer)
+ * Returns the slot to fill in place, or NULL (and counts a drop) if the ring is full.
+ * A claimed slot is published with HPOD_telemetry_commit.
+ */
+struct hpod_telemetry_s *HPOD_telemetry_claim(struct hpod_telemetry_ring_s *ring)
+{
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= HPOD_TELEMETRY_SLOTS) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    return &ring->slots[head & RING_MASK];
+}
+
+/**
+ * @brief Publish the claimed telemetry slot (producer)
+ */
+void HPOD_telemetry_commit(struct hpod_telemetry_ring_s *ring)
+{
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Pop the oldest telemetry sample (consumer)
+ * Returns 0 on success, -1 if the ring is empty.
+ */
+int HPOD_telemetry_pop(struct hpod_telemetry_ring_s *ring, struct hpod_telemetry_s *sample)
+{
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        return -1;
+    }
+
+    *sample = ring->slots[tail & RING_MASK];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+/**
+ * @brief Number of samples dropped while the ring was full (any thread)
+ */
+uint32_t HPOD_telemetry_dropped(struct hpod_telemetry_ring_s *ring)
+{
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,322 @@
+/**
+ * Libhexapod
+ * Real time controller
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#define _GNU_SOURCE
+
+#include "hexapod/controller.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+
+#define NS_PER_S        1000000000ULL
+#define NS_PER_US       1000
+
+// Statistics are published with a sequence lock, the writer makes the sequence odd while updating
+#define STATS_WORDS     (sizeof(struct hpod_controller_stats_s) / sizeof(uint32_t))
+
+_Static_assert(sizeof(struct hpod_controller_stats_s) % sizeof(uint32_t) == 0, "stats must be whole words");
+
+// Copy word by word with relaxed atomics, so a torn read is detected rather than undefined
+static void seq_copy(uint32_t *dest, const uint32_t *src, size_t words)
+{
+    for (size_t i = 0; i < words; i++) {
+        __atomic_store_n(&dest[i], __atomic_load_n(&src[i], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Read the monotonic clock in nanoseconds
+ */
+uint64_t HPOD_controller_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * NS_PER_S + ts.tv_nsec;
+}
+
+static void stage_record(struct hpod_stage_stats_s *stage, uint64_t start, uint64_t end)
+{
+    uint32_t elapsed = (end - start) > UINT32_MAX ? UINT32_MAX : (uint32_t) (end - start);
+
+    stage->last = elapsed;
+    stage->max = elapsed > stage->max ? elapsed : stage->max;
+    stage->total += elapsed;
+}
+
+static void jitter_record(struct hpod_controller_stats_s *stats, uint64_t late_ns)
+{
+    uint64_t us = late_ns / NS_PER_US;
+    int bin = 0;
+
+    // Log2 microsecond bins
+    while (us > 0 && bin < HPOD_JITTER_BINS - 1) {
+        us >>= 1;
+        bin++;
+    }
+
+    stats->jitter[bin]++;
+    if (late_ns > stats->jitter_max) {
+        stats->jitter_max = late_ns > UINT32_MAX ? UINT32_MAX : (uint32_t) late_ns;
+    }
+}
+
+static void stats_publish(struct hpod_controller_s *ctrl)
+{
+    uint32_t seq = __atomic_load_n(&ctrl->stats_seq, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&ctrl->stats_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    seq_copy((uint32_t *) &ctrl->stats, (const uint32_t *) &ctrl->working, STATS_WORDS);
+    __atomic_store_n(&ctrl->stats_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * Run a single tick, scheduled is the time the tick was due and start the time it began.
+ * Returns the completion time.
+ */
+static uint64_t controller_tick(struct hpod_controller_s *ctrl, uint64_t scheduled, uint64_t start)
+{
+    struct hpod_controller_stats_s *stats = &ctrl->working;
+
+    jitter_record(stats, start > scheduled ? start - scheduled : 0);
+
+    // Latch the latest command and advance phase by the elapsed time
+    int updated;
+    struct hpod_command_s *command = HPOD_mailbox_fetch(&ctrl->commands, &updated);
+    stats->commands += updated;
+
+    // Pose trig is only evaluated when the command changes
+    if (updated) {
+        HPOD_body_pose_init(&ctrl->transform, &command->pose);
+    }
+
+    float dt = (ctrl->last_ns == 0) ? 0.0f : (float) (start - ctrl->last_ns) / (float) NS_PER_S;
+    float phase = ctrl->phase + 2.0f * command->cycle_rate * dt;
+    ctrl->phase = phase - 2.0f * floorf((phase + 1.0f) / 2.0f);
+    ctrl->last_ns = start;
+
+    uint64_t kinematics = HPOD_controller_time_ns();
+    stage_record(&stats->stage[HPOD_STAGE_COMMAND], start, kinematics);
+
+    int failed = HPOD_pipeline(ctrl->hexapod, &command->gait, ctrl->servo, &ctrl->transform,
+                               &command->movement, ctrl->phase, &ctrl->scratch, ctrl->out);
+
+    uint64_t output = HPOD_controller_time_ns();
+    stage_record(&stats->stage[HPOD_STAGE_KINEMATICS], kinematics, output);
+
+    if (ctrl->config.output != NULL) {
+        ctrl->config.output(ctrl->config.output_ctx, &ctrl->scratch, ctrl->out);
+    }
+
+    struct hpod_telemetry_s *sample = HPOD_telemetry_claim(&ctrl->telemetry);
+    if (sample != NULL) {
+        sample->tick = stats->ticks;
+        sample->time_ns = start;
+        sample->phase = ctrl->phase;
+        memcpy(sample->angles, ctrl->scratch.angles, sizeof(sample->angles));
+        memcpy(sample->out, ctrl->out, sizeof(sample->out));
+        memcpy(sample->valid, ctrl->scratch.valid, sizeof(sample->valid));
+        HPOD_telemetry_commit(&ctrl->telemetry);
+    }
+    stats->telemetry_dropped = ctrl->telemetry.dropped;
+
+    uint64_t end = HPOD_controller_time_ns();
+    stage_record(&stats->stage[HPOD_STAGE_OUTPUT], output, end);
+
+    stats->ticks++;
+    stats->ik_failures += failed;
+    stats->phase = ctrl->phase;
+
+    return end;
+}
+
+/**
+ * @brief Initialise a controller
+ * The hexapod and servo objects are referenced and must outlive the controller, the gait
+ * is copied into the initial command, which is stationary at the default pose.
+ */
+void HPOD_controller_init(struct hpod_controller_s *ctrl, struct hexapod_s *hexapod, struct hpod_gait_s *gait,
+                          struct hpod_servo_s *servo, struct hpod_controller_config_s *config)
+{
+    memset(ctrl, 0, sizeof(*ctrl));
+
+    ctrl->hexapod = hexapod;
+    ctrl->servo = servo;
+    ctrl->config = *config;
+
+    if (ctrl->config.period_ns == 0) {
+        ctrl->config.period_ns = HPOD_CONTROLLER_DEFAULT_PERIOD_NS;
+    }
+
+    for (int i = 0; i < HPOD_MAX_LEGS; i++) {
+        for (int j = 0; j < 3; j++) {
+            ctrl->out[i][j] = servo->output_offset;
+        }
+    }
+
+    struct hpod_command_s initial = {
+        .movement = {0.0f, 0.0f, 0.0f},
+        .pose = HPOD_DEFAULT_BODY_POSE,
+        .gait = *gait,
+        .cycle_rate = 0.0f,
+    };
+    HPOD_body_pose_init(&ctrl->transform, &initial.pose);
+    HPOD_mailbox_init(&ctrl->commands, &initial);
+    HPOD_telemetry_init(&ctrl->telemetry);
+}
+
+/**
+ * @brief Set the controller command
+ * Wait free, safe to call from a single planner thread while the controller is running.
+ * The latest command is applied at the start of the next tick.
+ */
+void HPOD_controller_command(struct hpod_controller_s *ctrl, struct hpod_command_s *command)
+{
+    HPOD_mailbox_publish(&ctrl->commands, command);
+}
+
+/**
+ * @brief Read the oldest telemetry sample
+ * Wait free, safe to call from a single consumer thread while the controller is running.
+ * Returns 0 on success, -1 if no samples are waiting.
+ */
+int HPOD_controller_telemetry(struct hpod_controller_s *ctrl, struct hpod_telemetry_s *sample)
+{
+    return HPOD_telemetry_pop(&ctrl->telemetry, sample);
+}
+
+/**
+ * @brief Run a single controller tick at the provided monotonic time
+ * For driving the controller from an external timer (or in simulation) instead of the
+ * controller thread. Returns the number of legs without an IK solution.
+ */
+int HPOD_controller_step(struct hpod_controller_s *ctrl, uint64_t now_ns)
+{
+    uint64_t failures = ctrl->working.ik_failures;
+
+    controller_tick(ctrl, now_ns, now_ns);
+    stats_publish(ctrl);
+
+    return (int) (ctrl->working.ik_failures - failures);
+}
+
+static void *controller_thread(void *arg)
+{
+    struct hpod_controller_s *ctrl = (struct hpod_controller_s *) arg;
+    const uint64_t period = ctrl->config.period_ns;
+
+    uint64_t next = HPOD_controller_time_ns();
+
+    while (__atomic_load_n(&ctrl->running, __ATOMIC_ACQUIRE)) {
+        struct timespec ts = {
+            .tv_sec = next / NS_PER_S,
+            .tv_nsec = next % NS_PER_S,
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+
+        uint64_t end = controller_tick(ctrl, next, HPOD_controller_time_ns());
+        next += period;
+
+        // Ticks completing after the next was due are misses, whole periods overrun are
+        // skipped rather than run back to back
+        if (end > next) {
+            uint64_t skipped = (end - next) / period;
+            ctrl->working.deadline_misses++;
+            ctrl->working.skipped += skipped;
+            next += skipped * period;
+        }
+
+        stats_publish(ctrl);
+    }
+
+    return NULL;
+}
+
+static void controller_attr_init(pthread_attr_t *attr, int cpu)
+{
+    pthread_attr_init(attr);
+
+    if (cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        pthread_attr_setaffinity_np(attr, sizeof(cpus), &cpus);
+    }
+}
+
+/**
+ * @brief Start the controller thread
+ * When a priority is configured the thread is created with SCHED_FIFO, falling back to the
+ * default scheduler if this is not permitted (check the realtime field of the stats).
+ * Callers requiring bounded latency should also lock memory (mlockall) before starting.
+ * Returns 0 on success, -1 if the thread could not be started.
+ */
+int HPOD_controller_start(struct hpod_controller_s *ctrl)
+{
+    pthread_attr_t attr;
+    int res = -1;
+
+    __atomic_store_n(&ctrl->running, 1, __ATOMIC_RELEASE);
+
+    if (ctrl->config.priority > 0) {
+        struct sched_param param = {.sched_priority = ctrl->config.priority};
+
+        controller_attr_init(&attr, ctrl->config.cpu);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+
+        ctrl->working.realtime = 1;
+        res = pthread_create(&ctrl->thread, &attr, controller_thread, ctrl);
+        pthread_attr_destroy(&attr);
+    }
+
+    if (res != 0) {
+        controller_attr_init(&attr, ctrl->config.cpu);
+        ctrl->working.realtime = 0;
+        res = pthread_create(&ctrl->thread, &attr, controller_thread, ctrl);
+        pthread_attr_destroy(&attr);
+    }
+
+    if (res != 0) {
+        __atomic_store_n(&ctrl->running, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Stop the controller thread, returning once the current tick has completed
+ */
+void HPOD_controller_stop(struct hpod_controller_s *ctrl)
+{
+    if (__atomic_exchange_n(&ctrl->running, 0, __ATOMIC_ACQ_REL)) {
+        pthread_join(ctrl->thread, NULL);
+    }
+}
+
+/**
+ * @brief Take a consistent snapshot of the controller statistics
+ * Lock free, may be called from any thread while the controller is running.
+ */
+void HPOD_controller_stats(struct hpod_controller_s *ctrl, struct hpod_controller_stats_s *stats)
+{
+    uint32_t begin, end;
+
+    do {
+        begin = __atomic_load_n(&ctrl->stats_seq, __ATOMIC_ACQUIRE);
+        seq_copy((uint32_t *) stats, (const uint32_t *) &ctrl->stats, STATS_WORDS);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        end = __atomic_load_n(&ctrl->stats_seq, __ATOMIC_RELAXED);
+    } while ((begin & 1) || (begin != end));
+}
@@ -0,0 +1,379 @@
+/**
+ * Libhexapod
+ * Hexapod fixed point kinematics
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/fixed.h"
+
+#include <stdint.h>
+
+// CORDIC working precision, angles in Q29 (+-pi fits in int32) and unit vectors in Q30
+#define CORDIC_ITERATIONS   20
+#define CORDIC_ANGLE_SHIFT  13                  // Q29 -> Q16
+#define CORDIC_UNIT_SHIFT   14                  // Q30 -> Q16
+#define CORDIC_PI           1686629713          // pi (Q29)
+#define CORDIC_PI_2         843314857           // pi / 2 (Q29)
+#define CORDIC_GAIN_INV     652032874           // 1 / K (Q30)
+#define CORDIC_NORM_LIMIT   (1 << 29)           // Vectoring input limit for gain headroom
+
+// atan(2^-i) in Q29
+static const int32_t cordic_atan[CORDIC_ITERATIONS] = {
+    421657428, 248918915, 131521918, 66762579, 33510843, 16771758, 8387925, 4194219,
+    2097141, 1048575, 524288, 262144, 131072, 65536, 32768, 16384,
+    8192, 4096, 2048, 1024
+};
+
+/**
+ * @brief Integer square root of an unsigned 64-bit value
+ */
+static uint32_t fx_isqrt64(uint64_t v)
+{
+    uint64_t res = 0;
+    uint64_t bit;
+
+    if (v == 0) {
+        return 0;
+    }
+
+    // Start from the highest even power of two not above v
+    bit = (uint64_t)1 << ((63 - __builtin_clzll(v)) & ~1);
+
+    while (bit != 0) {
+        uint64_t t = res + bit;
+        uint64_t mask = -(uint64_t)(v >= t);
+
+        v -= t & mask;
+        res = (res >> 1) + (bit & mask);
+        bit >>= 2;
+    }
+
+    return (uint32_t)res;
+}
+
+/**
+ * @brief CORDIC vectoring mode
+ * Rotates (x, y) onto the x axis, returning the angle in Q29. Inputs must be
+ * smaller than CORDIC_NORM_LIMIT, magnitude (scaled by the CORDIC gain) is
+ * returned in mag if not NULL.
+ */
+static int32_t fx_cordic_vector(int32_t x, int32_t y, int32_t* mag)
+{
+    int32_t z = 0;
+
+    // Pre-rotate into the right half plane
+    if (x < 0) {
+        int32_t t = x;
+        if (y >= 0) {
+            x = y;
+            y = -t;
+            z = CORDIC_PI_2;
+        } else {
+            x = -y;
+            y = t;
+            z = -CORDIC_PI_2;
+        }
+    }
+
+    // Branch free, s is -1 when rotating clockwise and 0 otherwise
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t s = (y > 0) - 1;
+        int32_t xs = x >> i;
+        int32_t ys = y >> i;
+
+        x += (ys ^ s) - s;
+        y -= (xs ^ s) - s;
+        z += (cordic_atan[i] ^ s) - s;
+    }
+
+    if (mag != NULL) {
+        *mag = x;
+    }
+
+    return z;
+}
+
+/**
+ * @brief Scale a pair of 64-bit values to use the full CORDIC input range
+ * The ratio (and so the angle) between them is preserved
+ */
+static void fx_normalise(int64_t* a, int64_t* b)
+{
+    uint64_t m = (uint64_t)(*a < 0 ? -*a : *a) | (uint64_t)(*b < 0 ? -*b : *b);
+
+    if (m == 0) {
+        return;
+    }
+
+    // Shift so the larger magnitude sits in bit 28 (just under CORDIC_NORM_LIMIT)
+    int shift = (63 - __builtin_clzll(m)) - 28;
+
+    if (shift > 0) {
+        *a /= (int64_t)1 << shift;
+        *b /= (int64_t)1 << shift;
+    } else {
+        *a *= (int64_t)1 << -shift;
+        *b *= (int64_t)1 << -shift;
+    }
+}
+
+/**
+ * @brief Arc cosine of num / den (den > 0) without division
+ * Evaluated as atan2(sqrt(den^2 - num^2), num), returns Q16 radians
+ */
+static hpod_q16_t fx_acos_ratio(int64_t num, int64_t den)
+{
+    fx_normalise(&num, &den);
+
+    int64_t opp_sq = den * den - num * num;
+    int32_t opp = (opp_sq > 0) ? (int32_t)fx_isqrt64((uint64_t)opp_sq) : 0;
+
+    int32_t z = fx_cordic_vector((int32_t)num, opp, NULL);
+
+    return (z + (1 << (CORDIC_ANGLE_SHIFT - 1))) >> CORDIC_ANGLE_SHIFT;
+}
+
+/**
+ * @brief Initialise a fixed point hexapod instance from a hexapod config
+ * This is the only point where floating point values are converted
+ */
+void HPOD_fx_init(struct hpod_fx_s* fx, struct hexapod_config_s* config)
+{
+    fx->offset_a = HPOD_Q16_FROM_FLOAT(config->offset_a);
+    fx->len_ab = HPOD_Q16_FROM_FLOAT(config->len_ab);
+    fx->len_bc = HPOD_Q16_FROM_FLOAT(config->len_bc);
+
+    fx->len_ab_sq = (int64_t)fx->len_ab * fx->len_ab;
+    fx->len_bc_sq = (int64_t)fx->len_bc * fx->len_bc;
+    fx->len_ab_bc_2 = 2 * (int64_t)fx->len_ab * fx->len_bc;
+
+    int64_t reach_min = fx->len_ab > fx->len_bc ? fx->len_ab - fx->len_bc : fx->len_bc - fx->len_ab;
+    int64_t reach_max = (int64_t)fx->len_ab + fx->len_bc;
+    fx->reach_min_sq = reach_min * reach_min;
+    fx->reach_max_sq = reach_max * reach_max;
+}
+
+/**
+ * @brief Initialise a fixed point gait from a floating point gait
+ */
+void HPOD_fx_gait_init(struct hpod_fx_gait_s* fx_gait, struct hpod_gait_s* gait)
+{
+    fx_gait->movement.x = HPOD_Q16_FROM_FLOAT(gait->movement.x);
+    fx_gait->movement.y = HPOD_Q16_FROM_FLOAT(gait->movement.y);
+    fx_gait->movement.z = HPOD_Q16_FROM_FLOAT(gait->movement.z);
+    fx_gait->offset.x = HPOD_Q16_FROM_FLOAT(gait->offset.x);
+    fx_gait->offset.y = HPOD_Q16_FROM_FLOAT(gait->offset.y);
+    fx_gait->offset.z = HPOD_Q16_FROM_FLOAT(gait->offset.z);
+    fx_gait->height_scale = HPOD_Q16_FROM_FLOAT(gait->height_scale);
+    fx_gait->inv_height_scale = HPOD_Q16_FROM_FLOAT(1.0f / gait->height_scale);
+}
+
+/**
+ * @brief Initialise a fixed point servo adaptor from a servo adaptor
+ */
+void HPOD_fx_servo_init(struct hpod_fx_servo_s* fx_servo, struct hpod_servo_s* servo)
+{
+    fx_servo->range_rads = HPOD_Q16_FROM_FLOAT(servo->range_rads);
+    fx_servo->counts_per_rad = HPOD_Q16_FROM_FLOAT(1.0f / servo->scale);
+    fx_servo->output_offset = servo->output_offset;
+}
+
+/**
+ * @brief Fixed point sine and cosine using CORDIC rotation
+ * Accepts any angle, maximum error is around 2e-5
+ */
+void HPOD_fx_sincos(hpod_q16_t angle, hpod_q16_t* sin, hpod_q16_t* cos)
+{
+    const hpod_q16_t two_pi = 2 * HPOD_Q16_PI;
+    int negate = 0;
+
+    // Wrap into -pi..pi
+    angle = angle % two_pi;
+    if (angle > HPOD_Q16_PI) {
+        angle -= two_pi;
+    } else if (angle < -HPOD_Q16_PI) {
+        angle += two_pi;
+    }
+
+    // Reflect into -pi/2..pi/2
+    int32_t z = angle * (1 << CORDIC_ANGLE_SHIFT);
+    if (z > CORDIC_PI_2) {
+        z -= CORDIC_PI;
+        negate = 1;
+    } else if (z < -CORDIC_PI_2) {
+        z += CORDIC_PI;
+        negate = 1;
+    }
+
+    int32_t x = CORDIC_GAIN_INV;
+    int32_t y = 0;
+
+    // Branch free, s is -1 when rotating clockwise and 0 otherwise
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t s = z >> 31;
+        int32_t xs = x >> i;
+        int32_t ys = y >> i;
+
+        x -= (ys ^ s) - s;
+        y += (xs ^ s) - s;
+        z -= (cordic_atan[i] ^ s) - s;
+    }
+
+    x = (x + (1 << (CORDIC_UNIT_SHIFT - 1))) >> CORDIC_UNIT_SHIFT;
+    y = (y + (1 << (CORDIC_UNIT_SHIFT - 1))) >> CORDIC_UNIT_SHIFT;
+
+    *sin = negate ? -y : y;
+    *cos = negate ? -x : x;
+}
+
+/**
+ * @brief Fixed point two argument arc tangent using CORDIC vectoring
+ */
+hpod_q16_t HPOD_fx_atan2(hpod_q16_t y, hpod_q16_t x)
+{
+    int64_t a = x, b = y;
+
+    fx_normalise(&a, &b);
+
+    int32_t z = fx_cordic_vector((int32_t)a, (int32_t)b, NULL);
+
+    return (z + (1 << (CORDIC_ANGLE_SHIFT - 1))) >> CORDIC_ANGLE_SHIFT;
+}
+
+/**
+ * @brief Fixed point 3 Joint Arm Inverse Kinematics
+ * Equivalent to HPOD_leg_ik3, returns -1 for targets outside of the reach envelope
+ */
+int HPOD_fx_leg_ik3(struct hpod_fx_s* fx, struct hpod_fx_vector3_s* end_pos,
+                    hpod_q16_t* alpha, hpod_q16_t* beta, hpod_q16_t* theta)
+{
+    // Planar distance and angle from origin to point (x, y)
+    int64_t len_xy_sq = (int64_t)end_pos->x * end_pos->x + (int64_t)end_pos->y * end_pos->y;
+    hpod_q16_t len_xy = (hpod_q16_t)fx_isqrt64((uint64_t)len_xy_sq);
+
+    // Distance in the leg plane (less offset between joints at A)
+    hpod_q16_t d = len_xy - fx->offset_a;
+    hpod_q16_t h = end_pos->z;
+
+    int64_t len_ac_sq = (int64_t)d * d + (int64_t)h * h;
+    if (len_ac_sq < fx->reach_min_sq || len_ac_sq > fx->reach_max_sq || len_ac_sq == 0) {
+        return -1;
+    }
+    hpod_q16_t len_ac = (hpod_q16_t)fx_isqrt64((uint64_t)len_ac_sq);
+
+    // Cosine rule for the two triangles sharing face AC
+    hpod_q16_t angle_a = fx_acos_ratio(len_ac_sq + fx->len_ab_sq - fx->len_bc_sq,
+                                       2 * (int64_t)fx->len_ab * len_ac);
+    hpod_q16_t angle_b = fx_acos_ratio(fx->len_ab_sq + fx->len_bc_sq - len_ac_sq,
+                                       fx->len_ab_bc_2);
+
+    *alpha = angle_a + HPOD_fx_atan2(h, d);
+    *beta = angle_b;
+    *theta = HPOD_fx_atan2(end_pos->y, end_pos->x);
+
+    return 0;
+}
+
+/**
+ * @brief Fixed point 3 Joint Arm Forward Kinematics
+ * Equivalent to HPOD_leg_fk3
+ */
+void HPOD_fx_leg_fk3(struct hpod_fx_s* fx, hpod_q16_t alpha, hpod_q16_t beta, hpod_q16_t theta,
+                     struct hpod_fx_vector3_s* end_pos)
+{
+    hpod_q16_t sin_a, cos_a, sin_w, cos_w, sin_t, cos_t;
+
+    HPOD_fx_sincos(alpha, &sin_a, &cos_a);
+    HPOD_fx_sincos(HPOD_Q16_PI - alpha - beta, &sin_w, &cos_w);
+    HPOD_fx_sincos(theta, &sin_t, &cos_t);
+
+    // Joint C position in the leg plane
+    hpod_q16_t c_d = HPOD_Q16_MUL(fx->len_ab, cos_a) + HPOD_Q16_MUL(fx->len_bc, cos_w);
+    hpod_q16_t c_h = HPOD_Q16_MUL(fx->len_ab, sin_a) - HPOD_Q16_MUL(fx->len_bc, sin_w);
+
+    hpod_q16_t r = fx->offset_a + c_d;
+
+    end_pos->x = HPOD_Q16_MUL(r, cos_t);
+    end_pos->y = HPOD_Q16_MUL(r, sin_t);
+    end_pos->z = c_h;
+}
+
+/**
+ * @brief Fixed point gait calculation
+ * Equivalent to HPOD_gait_calc
+ */
+void HPOD_fx_gait_calc(struct hpod_fx_gait_s* gait, struct hpod_fx_vector3_s* movement,
+                       hpod_q16_t phase_scl, struct hpod_fx_vector3_s* leg_pos)
+{
+    const hpod_q16_t period = 2 * HPOD_Q16_ONE;
+    hpod_q16_t s, c;
+
+    // Wrap phase into -1..1
+    hpod_q16_t phase = (phase_scl + HPOD_Q16_ONE) % period;
+    if (phase < 0) {
+        phase += period;
+    }
+    phase -= HPOD_Q16_ONE;
+
+    HPOD_fx_sincos(HPOD_Q16_MUL(phase, HPOD_Q16_PI), &s, &c);
+
+    // Forward walk
+    leg_pos->x = HPOD_Q16_MUL(HPOD_Q16_MUL(s, gait->movement.x / 2), movement->x) + gait->offset.x;
+    leg_pos->y = HPOD_Q16_MUL(HPOD_Q16_MUL(s, gait->movement.y / 2), movement->y);
+
+    // Height morphing, as in HPOD_gait_calc
+    hpod_q16_t abs_phase = phase < 0 ? -phase : phase;
+    hpod_q16_t half_z = gait->movement.z / 2;
+
+    if (abs_phase < HPOD_Q16_HALF) {
+        leg_pos->z = -half_z + gait->offset.z;
+    } else if (abs_phase > HPOD_Q16_HALF + gait->height_scale) {
+        leg_pos->z = half_z + gait->offset.z;
+    } else {
+        hpod_q16_t t;
+        if (phase > 0) {
+            t = HPOD_Q16_MUL(phase - HPOD_Q16_HALF + gait->height_scale, gait->inv_height_scale);
+        } else {
+            t = HPOD_Q16_MUL(phase + HPOD_Q16_HALF - gait->height_scale, gait->inv_height_scale);
+        }
+        HPOD_fx_sincos(HPOD_Q16_MUL(t, HPOD_Q16_PI), &s, &c);
+        leg_pos->z = HPOD_Q16_MUL(c, half_z) + gait->offset.z;
+    }
+}
+
+/**
+ * @brief Scale a fixed point angle to a servo output
+ * Equivalent to HPOD_servo_scale
+ */
+int HPOD_fx_servo_scale(struct hpod_fx_servo_s* servo, hpod_q16_t angle)
+{
+    hpod_q16_t limited = HPOD_LIMIT_RANGE(-servo->range_rads, servo->range_rads, angle);
+
+    // Q16 * Q16 -> Q32, truncated toward zero to match the float cast
+    int64_t counts = (int64_t)limited * servo->counts_per_rad + ((int64_t)servo->output_offset << 32);
+
+    return (int)(counts >= 0 ? counts >> 32 : -((-counts) >> 32));
+}
+
+/**
+ * @brief Fixed point IK straight to servo outputs
+ * Unreachable targets set outputs to the servo offset and return -1
+ */
+int HPOD_fx_leg_ik3_servo(struct hpod_fx_s* fx, struct hpod_fx_servo_s* servo,
+                          struct hpod_fx_vector3_s* end_pos, int out[3])
+{
+    hpod_q16_t alpha, beta, theta;
+
+    if (HPOD_fx_leg_ik3(fx, end_pos, &alpha, &beta, &theta) < 0) {
+        out[0] = out[1] = out[2] = servo->output_offset;
+        return -1;
+    }
+
+    out[0] = HPOD_fx_servo_scale(servo, alpha);
+    out[1] = HPOD_fx_servo_scale(servo, beta);
+    out[2] = HPOD_fx_servo_scale(servo, theta);
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * Libhexapod
+ * Hexapod gait transition blending
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/gait_blend.h"
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief Smootherstep, zero first and second derivatives at 0 and 1
+ */
+static inline float gait_blend_weight(float t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+/**
+ * @brief Initialise a blend, steady on the provided table
+ */
+void HPOD_gait_blend_init(struct hpod_gait_blend_s* blend, struct hpod_gait_table_s* table, float phase_scl)
+{
+    blend->from = table;
+    blend->to = NULL;
+    blend->rate = 0.0f;
+    blend->progress = 0.0f;
+    blend->weight = 0.0f;
+    blend->last_phase = phase_scl;
+}
+
+/**
+ * @brief Start a transition to a new gait table over the provided number of phase cycles
+ * Transitions of zero cycles switch immediately. Returns -1 if a transition is already in
+ * progress, as a blend only holds two gaits.
+ */
+int HPOD_gait_blend_start(struct hpod_gait_blend_s* blend, struct hpod_gait_table_s* to, float cycles)
+{
+    if (blend->to != NULL) {
+        return -1;
+    }
+
+    if (cycles <= 0.0f) {
+        blend->from = to;
+        return 0;
+    }
+
+    blend->to = to;
+    blend->rate = 1.0f / (2.0f * cycles);
+    blend->progress = 0.0f;
+    blend->weight = 0.0f;
+
+    return 0;
+}
+
+/**
+ * @brief Advance the transition to the current phase, called once per tick before calc
+ * Progress follows the phase travelled since the previous update (in either direction),
+ * so updates must be made at least twice per cycle.
+ * Returns 1 while a transition is in progress, 0 once steady.
+ */
+int HPOD_gait_blend_update(struct hpod_gait_blend_s* blend, float phase_scl)
+{
+    float delta = phase_scl - blend->last_phase;
+    blend->last_phase = phase_scl;
+
+    if (blend->to == NULL) {
+        return 0;
+    }
+
+    // Shortest wrapped distance, phase has a period of 2
+    delta = delta - 2.0f * floorf((delta + 1.0f) / 2.0f);
+    blend->progress += HPOD_FABS(delta) * blend->rate;
+
+    if (blend->progress >= 1.0f) {
+        blend->from = blend->to;
+        blend->to = NULL;
+        blend->progress = 0.0f;
+        blend->weight = 0.0f;
+        return 0;
+    }
+
+    blend->weight = gait_blend_weight(blend->progress);
+
+    return 1;
+}
+
+/**
+ * @brief Calculate the position of a limb through a blend
+ * Equivalent to HPOD_gait_table_calc on the current table when steady.
+ */
+void HPOD_gait_blend_calc(struct hpod_gait_blend_s* blend, float phase_scl, enum hpod_interp_e interp,
+                          struct hpod_vector3_s* leg_pos)
+{
+    HPOD_gait_table_calc(blend->from, phase_scl, interp, leg_pos);
+
+    if (blend->to == NULL) {
+        return;
+    }
+
+    struct hpod_vector3_s to_pos;
+    HPOD_gait_table_calc(blend->to, phase_scl, interp, &to_pos);
+
+    const float w = blend->weight;
+    leg_pos->x += (to_pos.x - leg_pos->x) * w;
+    leg_pos->y += (to_pos.y - leg_pos->y) * w;
+    leg_pos->z += (to_pos.z - leg_pos->z) * w;
+}
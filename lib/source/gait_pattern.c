@@ -0,0 +1,210 @@
+/**
+ * Libhexapod
+ * Hexapod gait patterns and static stability
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/gait_pattern.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+
+/**
+ * Standard gait patterns
+ * Legs lift in the order given by the (negated) offsets, legs are ordered front left, front
+ * right, middle left, middle right, rear left, rear right.
+ */
+const struct hpod_gait_pattern_s hpod_gait_patterns[HPOD_PATTERN_COUNT] = {
+    // Tripod: front left, middle right and rear left step together
+    {{0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f}, 1.0f / 2},
+    // Ripple: rear, middle, front on each side, with the right side half a cycle behind
+    {{2.0f / 3, 5.0f / 3, 4.0f / 3, 1.0f / 3, 0.0f, 1.0f}, 2.0f / 3},
+    // Wave: rear left, middle left, front left, rear right, middle right, front right
+    {{4.0f / 3, 1.0f / 3, 5.0f / 3, 2.0f / 3, 0.0f, 1.0f}, 5.0f / 6},
+};
+
+/**
+ * @brief Initialise a custom pattern from a standard leg order with the provided duty factor
+ * Legs are in contact for duty / 2 of each unit of phase.
+ * Returns 0 on success, or -1 (leaving pattern unchanged) if the base is unknown or duty is
+ * outside HPOD_GAIT_DUTY_MIN to HPOD_GAIT_DUTY_MAX.
+ */
+int HPOD_gait_pattern_init(struct hpod_gait_pattern_s* pattern, enum hpod_gait_pattern_e base, float duty)
+{
+    if ((unsigned) base >= HPOD_PATTERN_COUNT || !(duty >= HPOD_GAIT_DUTY_MIN && duty <= HPOD_GAIT_DUTY_MAX)) {
+        return -1;
+    }
+
+    *pattern = hpod_gait_patterns[base];
+    pattern->duty = duty;
+
+    return 0;
+}
+
+/**
+ * @brief Duty factor of a pattern, limited so phases are always defined
+ * Patterns may be written directly, a duty of 1 would divide by zero at the end of the swing.
+ */
+static inline float gait_pattern_duty(const struct hpod_gait_pattern_s* pattern)
+{
+    return HPOD_LIMIT_RANGE(HPOD_GAIT_DUTY_MIN, HPOD_GAIT_DUTY_MAX, pattern->duty);
+}
+
+/**
+ * @brief Offset phase for a leg, wrapped into -1 to 1
+ */
+static inline float gait_pattern_wrap(const struct hpod_gait_pattern_s* pattern, float phase_scl, int leg)
+{
+    return HPOD_FMOD(phase_scl + pattern->offset[leg] + 3.0f, 2.0f) - 1.0f;
+}
+
+/**
+ * @brief Calculate the gait phase of a leg for a pattern
+ * Offsets the walking phase by the leg offset, then maps contact (|phase| < duty) onto the
+ * contact half of the gait (|phase| < 0.5) and the swing onto the remainder, so the result
+ * can be passed directly to HPOD_gait_calc.
+ */
+float HPOD_gait_pattern_phase(const struct hpod_gait_pattern_s* pattern, float phase_scl, int leg)
+{
+    float phase = gait_pattern_wrap(pattern, phase_scl, leg);
+    float duty = gait_pattern_duty(pattern);
+    float abs_phase = HPOD_FABS(phase);
+
+    if (abs_phase < duty) {
+        return phase * 0.5f / duty;
+    }
+
+    return copysignf(0.5f + (abs_phase - duty) * 0.5f / (1.0f - duty), phase);
+}
+
+/**
+ * @brief Find the legs in contact at a walking phase
+ * Evaluates the first legs legs of the pattern, returns the number of legs in contact.
+ */
+int HPOD_gait_pattern_contacts(const struct hpod_gait_pattern_s* pattern, float phase_scl, int legs,
+                               uint8_t contact[])
+{
+    float duty = gait_pattern_duty(pattern);
+    int count = 0;
+
+    for (int i = 0; i < legs; i++) {
+        contact[i] = HPOD_FABS(gait_pattern_wrap(pattern, phase_scl, i)) <= duty;
+        count += contact[i];
+    }
+
+    return count;
+}
+
+/**
+ * @brief Signed distance from the origin to the convex hull of the provided points
+ * Positive inside the hull, negative outside. Points are reordered.
+ */
+static float support_margin(float points[HPOD_MAX_LEGS][2], int count)
+{
+    float hull[2 * HPOD_MAX_LEGS][2];
+    int n = 0;
+
+    if (count < 3) {
+        return -INFINITY;
+    }
+
+    // Sort by x then y
+    for (int i = 1; i < count; i++) {
+        float x = points[i][0], y = points[i][1];
+        int j = i - 1;
+        for (; j >= 0 && (points[j][0] > x || (points[j][0] == x && points[j][1] > y)); j--) {
+            points[j + 1][0] = points[j][0];
+            points[j + 1][1] = points[j][1];
+        }
+        points[j + 1][0] = x;
+        points[j + 1][1] = y;
+    }
+
+    // Monotone chain, lower then upper hull (counter clockwise)
+    for (int pass = 0; pass < 2; pass++) {
+        int start = n;
+        for (int k = 0; k < count; k++) {
+            int i = pass == 0 ? k : count - 1 - k;
+            while (n >= start + 2) {
+                float cross = (hull[n - 1][0] - hull[n - 2][0]) * (points[i][1] - hull[n - 2][1])
+                              - (hull[n - 1][1] - hull[n - 2][1]) * (points[i][0] - hull[n - 2][0]);
+                if (cross > 0.0f) {
+                    break;
+                }
+                n--;
+            }
+            hull[n][0] = points[i][0];
+            hull[n][1] = points[i][1];
+            n++;
+        }
+        // The last point of each chain starts the next
+        n--;
+    }
+
+    if (n < 3) {
+        return -INFINITY;
+    }
+
+    float margin = INFINITY;
+    for (int i = 0; i < n; i++) {
+        float *a = hull[i], *b = hull[(i + 1) % n];
+        float dx = b[0] - a[0], dy = b[1] - a[1];
+        float distance = (dx * -a[1] - dy * -a[0]) / HPOD_SQRT(dx * dx + dy * dy);
+        margin = fminf(margin, distance);
+    }
+
+    return margin;
+}
+
+/**
+ * @brief Evaluate the static stability margin of a gait over a walking period
+ * The margin is the distance (mm) from the body center to the nearest edge of the support
+ * polygon formed by the feet in contact, negative if the body center is outside it. Evaluated
+ * at the center of slices equal divisions of the walking period (so samples fall between
+ * contact changes), returning the minimum margin and (if not NULL) the phase it occurs at.
+ */
+float HPOD_gait_stability(struct hexapod_s* hexapod, struct hpod_gait_s* gait,
+                          struct hpod_vector3_s* movement, int slices, float* min_phase)
+{
+    float min_margin = INFINITY;
+
+    for (int s = 0; s < slices; s++) {
+        float phase_scl = (2.0f * s + 1.0f) / slices - 1.0f;
+        uint8_t contact[HPOD_MAX_LEGS];
+        float feet[HPOD_MAX_LEGS][2];
+        int count = 0;
+
+        HPOD_gait_pattern_contacts(&gait->pattern, phase_scl, hexapod->legs, contact);
+
+        // Feet in contact, in the body frame
+        for (int i = 0; i < hexapod->legs; i++) {
+            if (!contact[i]) {
+                continue;
+            }
+
+            struct hpod_leg_mount_s* mount = &hexapod->leg[i].mount;
+            struct hpod_vector3_s pos;
+            float phase = HPOD_gait_pattern_phase(&gait->pattern, phase_scl, i);
+            HPOD_gait_calc_leg(hexapod, gait, movement, phase, i, &pos);
+
+            float foot_x = mount->x + pos.x, foot_y = mount->y + pos.y;
+            feet[count][0] = mount->side * (mount->cos_yaw * foot_x - mount->sin_yaw * foot_y);
+            feet[count][1] = mount->sin_yaw * foot_x + mount->cos_yaw * foot_y;
+            count++;
+        }
+
+        float margin = support_margin(feet, count);
+        if (margin < min_margin) {
+            min_margin = margin;
+            if (min_phase != NULL) {
+                *min_phase = phase_scl;
+            }
+        }
+    }
+
+    return min_margin;
+}
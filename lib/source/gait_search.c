@@ -0,0 +1,279 @@
+/**
+ * Libhexapod
+ * Hexapod gait feasibility search
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/gait_search.h"
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "hexapod/hexapod.h"
+
+/**
+ * @brief Access a searchable gait parameter by index
+ */
+static float* gait_param(struct hpod_gait_s* gait, int i)
+{
+    switch (i) {
+    case 0: return &gait->movement.x;
+    case 1: return &gait->movement.y;
+    case 2: return &gait->movement.z;
+    case 3: return &gait->offset.x;
+    case 4: return &gait->offset.y;
+    case 5: return &gait->offset.z;
+    case 6: return &gait->height_scale;
+    default: return &gait->yaw;
+    }
+}
+
+/**
+ * @brief Check a gait is feasible for a set of movements
+ * Evaluates slices leg positions over one walking period (-1 to 1) for each movement,
+ * stopping at the first slice that cannot be solved or exceeds the joint limits (if not NULL).
+ * Without rotation every leg of a uniform hexapod with no mount yaw follows the same path in
+ * its own frame, so a single leg is checked. Movements with rotation, or hexapods with per leg
+ * links or mount yaw, are checked for each leg.
+ * Returns 0 if the gait is feasible, -1 otherwise, with details in result.
+ */
+int HPOD_gait_check(struct hexapod_s* hexapod, struct hpod_gait_s* gait,
+                    struct hpod_vector3_s* movements, int movement_count, int slices,
+                    struct hpod_joint_limits_s* limits, struct hpod_gait_check_s* result)
+{
+    result->feasible = 0;
+    result->fail_movement = -1;
+    result->fail_leg = -1;
+    result->fail_phase = NAN;
+    result->reach_margin = INFINITY;
+    result->slices_checked = 0;
+    for (int j = 0; j < 3; j++) {
+        result->joint_margin[j] = INFINITY;
+    }
+
+    for (int m = 0; m < movement_count; m++) {
+        int legs = (movements[m].z != 0.0f || !hexapod->uniform || !hexapod->aligned) ? hexapod->legs : 1;
+
+        for (int leg = 0; leg < legs; leg++) {
+            const struct hpod_leg_s *l = &hexapod->leg[leg];
+
+            for (int i = 0; i < slices; i++) {
+                float phase = 2.0f * i / slices - 1.0f;
+                struct hpod_vector3_s position;
+                float angles[3];
+
+                HPOD_gait_calc_leg(hexapod, gait, &movements[m], phase, leg, &position);
+                result->slices_checked++;
+
+                // Distance inside the reach envelope, from the same plane as HPOD_leg_ik3
+                float d = HPOD_SQRT(HPOD_SQ(position.x) + HPOD_SQ(position.y)) - l->offset_a;
+                float len_ac = HPOD_SQRT(HPOD_SQ(d) + HPOD_SQ(position.z));
+                float margin = fminf(len_ac - l->kinematics.reach_min, l->kinematics.reach_max - len_ac);
+
+                int res = HPOD_leg_ik3_n(hexapod, leg, &position, &angles[0], &angles[1], &angles[2]);
+
+                if (limits != NULL && res == 0) {
+                    for (int j = 0; j < 3; j++) {
+                        float joint_margin = fminf(angles[j] - limits->min[j], limits->max[j] - angles[j]);
+                        res |= (joint_margin < 0.0f) ? -1 : 0;
+                        result->joint_margin[j] = fminf(result->joint_margin[j], joint_margin);
+                    }
+                }
+
+                if (res < 0) {
+                    result->fail_movement = m;
+                    result->fail_leg = leg;
+                    result->fail_phase = phase;
+                    result->reach_margin = fminf(result->reach_margin, margin);
+                    return -1;
+                }
+
+                result->reach_margin = fminf(result->reach_margin, margin);
+            }
+        }
+    }
+
+    result->feasible = 1;
+    return 0;
+}
+
+/**
+ * @brief Fetch the number of candidates in a gait grid
+ */
+int HPOD_gait_grid_size(struct hpod_gait_grid_s* grid)
+{
+    int size = 1;
+
+    for (int i = 0; i < HPOD_GAIT_PARAMS; i++) {
+        size *= (grid->steps[i] > 1) ? grid->steps[i] : 1;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Fetch a candidate gait from a gait grid by index
+ */
+void HPOD_gait_grid_get(struct hpod_gait_grid_s* grid, int index, struct hpod_gait_s* gait)
+{
+    *gait = grid->min;
+
+    for (int i = 0; i < HPOD_GAIT_PARAMS; i++) {
+        int steps = grid->steps[i];
+        if (steps <= 1) {
+            continue;
+        }
+
+        int step = index % steps;
+        index /= steps;
+
+        float min = *gait_param(&grid->min, i);
+        float max = *gait_param(&grid->max, i);
+        *gait_param(gait, i) = min + (max - min) * step / (steps - 1);
+    }
+}
+
+/**
+ * Work stealing state
+ * Each worker owns a range of candidate indices packed as (end << 32 | begin) so that
+ * the owner (taking from the front) and thieves (taking half from the back) can update
+ * it with a single compare and swap.
+ */
+struct search_worker_s {
+    _Atomic uint64_t range;
+    struct hpod_gait_search_s* search;
+    struct hpod_gait_check_s* results;
+    struct search_worker_s* workers;
+    int id;
+    int count;
+    uint32_t steals;
+    int feasible;
+    pthread_t thread;
+} __attribute__((aligned(64)));
+
+#define RANGE_PACK(begin, end)  (((uint64_t)(end) << 32) | (uint32_t)(begin))
+#define RANGE_BEGIN(r)          ((uint32_t)(r))
+#define RANGE_END(r)            ((uint32_t)((r) >> 32))
+
+/**
+ * @brief Take the next candidate from a worker's own range, returns -1 if empty
+ */
+static int search_take(struct search_worker_s* w)
+{
+    uint64_t r = atomic_load(&w->range);
+
+    while (RANGE_BEGIN(r) < RANGE_END(r)) {
+        if (atomic_compare_exchange_weak(&w->range, &r, RANGE_PACK(RANGE_BEGIN(r) + 1, RANGE_END(r)))) {
+            return RANGE_BEGIN(r);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Steal half of the remaining range of another worker, returns 0 on success
+ */
+static int search_steal(struct search_worker_s* w)
+{
+    for (int i = 1; i < w->count; i++) {
+        struct search_worker_s* victim = &w->workers[(w->id + i) % w->count];
+        uint64_t r = atomic_load(&victim->range);
+
+        while (RANGE_BEGIN(r) < RANGE_END(r)) {
+            uint32_t take = (RANGE_END(r) - RANGE_BEGIN(r) + 1) / 2;
+            uint32_t split = RANGE_END(r) - take;
+
+            if (atomic_compare_exchange_weak(&victim->range, &r, RANGE_PACK(RANGE_BEGIN(r), split))) {
+                atomic_store(&w->range, RANGE_PACK(split, split + take));
+                w->steals++;
+                return 0;
+            }
+        }
+    }
+
+    return -1;
+}
+
+static void* search_worker(void* ctx)
+{
+    struct search_worker_s* w = (struct search_worker_s*) ctx;
+    struct hpod_gait_search_s* s = w->search;
+
+    // Run until own range is empty and there is nothing left to steal
+    do {
+        int index;
+        while ((index = search_take(w)) >= 0) {
+            struct hpod_gait_s gait;
+            HPOD_gait_grid_get(s->grid, index, &gait);
+
+            int res = HPOD_gait_check(s->hexapod, &gait, s->movements, s->movement_count,
+                                      s->slices, s->limits, &w->results[index]);
+            w->feasible += (res == 0);
+        }
+    } while (search_steal(w) == 0);
+
+    return NULL;
+}
+
+/**
+ * @brief Check every candidate of a gait grid in parallel
+ * Candidates are split evenly between worker threads, which steal from each other once
+ * their own candidates are complete (infeasible candidates exit early, so the work per
+ * range is uneven). results must have HPOD_gait_grid_size(search->grid) entries.
+ * If worker threads cannot be started their candidates are stolen by the calling thread.
+ * Returns the number of feasible candidates.
+ */
+int HPOD_gait_search(struct hpod_gait_search_s* search, struct hpod_gait_check_s* results)
+{
+    struct search_worker_s workers[HPOD_SEARCH_MAX_THREADS];
+    int size = HPOD_gait_grid_size(search->grid);
+    int count = search->threads;
+
+    if (count <= 0) {
+        count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    count = (count < 1) ? 1 : (count > HPOD_SEARCH_MAX_THREADS) ? HPOD_SEARCH_MAX_THREADS : count;
+    count = (count > size) ? ((size > 0) ? size : 1) : count;
+
+    for (int i = 0; i < count; i++) {
+        int begin = (int)((int64_t)size * i / count);
+        int end = (int)((int64_t)size * (i + 1) / count);
+
+        atomic_init(&workers[i].range, RANGE_PACK(begin, end));
+        workers[i].search = search;
+        workers[i].results = results;
+        workers[i].workers = workers;
+        workers[i].id = i;
+        workers[i].count = count;
+        workers[i].steals = 0;
+        workers[i].feasible = 0;
+    }
+
+    // Worker 0 runs on the calling thread
+    int started = 1;
+    for (; started < count; started++) {
+        if (pthread_create(&workers[started].thread, NULL, search_worker, &workers[started]) != 0) {
+            break;
+        }
+    }
+
+    search_worker(&workers[0]);
+
+    int feasible = 0;
+    search->steals = 0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && i < started) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        feasible += workers[i].feasible;
+        search->steals += workers[i].steals;
+    }
+
+    return feasible;
+}
@@ -0,0 +1,232 @@
+/**
+ * Libhexapod
+ * Hexapod gait lookup tables
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/gait_table.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+
+// Minimum slices for cubic interpolation neighbours to be distinct
+#define GAIT_TABLE_MIN_SLICES   4
+
+/**
+ * @brief Convert a phase into a slice index and fraction
+ * Phase wraps with a period of 2 as in HPOD_gait_calc
+ */
+static inline int gait_table_index(struct hpod_gait_table_s* table, float phase_scl, float* frac)
+{
+    float u = (phase_scl + 1.0f) * table->slices_per_phase;
+    float n = (float)table->slices;
+
+    u = u - n * floorf(u / n);
+
+    int i = (int)u;
+    *frac = u - (float)i;
+
+    // Guard rounding at the top of the range
+    if (i >= table->slices) {
+        i -= table->slices;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Catmull-Rom spline between b and c
+ */
+static inline float gait_table_cubic(float a, float b, float c, float d, float t)
+{
+    return b + 0.5f * t * (c - a + t * (2.0f * a - 5.0f * b + 4.0f * c - d + t * (3.0f * (b - c) + d - a)));
+}
+
+/**
+ * @brief Recompute precomputed angles from the sampled shape
+ */
+static int gait_table_solve(struct hpod_gait_table_s* table)
+{
+    int failed = 0;
+
+    for (int i = 0; i < table->slices; i++) {
+        struct hpod_vector3_s pos;
+        pos.x = table->shape[i].sin * table->kx + table->gait.offset.x;
+        pos.y = table->shape[i].sin * table->ky;
+        pos.z = table->shape[i].z;
+
+        struct hpod_gait_angles_s *a = &table->angles[i];
+        int res = (table->leg < 0) ? HPOD_leg_ik3(table->hexapod, &pos, &a->alpha, &a->beta, &a->theta)
+                  : HPOD_leg_ik3_n(table->hexapod, table->leg, &pos, &a->alpha, &a->beta, &a->theta);
+        if (res < 0) {
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+static int gait_table_init(struct hpod_gait_table_s* table, struct hexapod_s* hexapod, int leg,
+                           struct hpod_gait_s* gait, struct hpod_vector3_s* movement, int slices,
+                           struct hpod_gait_slice_s* shape, struct hpod_gait_angles_s* angles)
+{
+    if (slices < GAIT_TABLE_MIN_SLICES || shape == NULL) {
+        return -1;
+    }
+
+    table->hexapod = hexapod;
+    table->leg = leg;
+    table->gait = *gait;
+    table->slices = slices;
+    table->slices_per_phase = (float)slices / 2.0f;
+    table->shape = shape;
+    table->angles = NULL;
+
+    // Sample the gait shape with unit movement
+    struct hpod_vector3_s unit = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < slices; i++) {
+        float phase = -1.0f + 2.0f * (float)i / (float)slices;
+
+        struct hpod_vector3_s pos;
+        HPOD_gait_calc(hexapod, gait, &unit, phase, &pos);
+
+        shape[i].sin = sinf(phase * HPOD_PI);
+        shape[i].z = pos.z;
+    }
+
+    table->angles = angles;
+
+    return HPOD_gait_table_set_movement(table, movement);
+}
+
+/**
+ * @brief Build a gait table
+ * Samples the gait shape into shape (slices entries), and if angles is not NULL
+ * solves leg angles for each slice at the provided movement with the shared links.
+ * Returns 0 on success, -1 for invalid arguments or for angles when the legs do not
+ * share links (see HPOD_gait_table_init_n), or the number of slices with no IK solution.
+ */
+int HPOD_gait_table_init(struct hpod_gait_table_s* table, struct hexapod_s* hexapod,
+                         struct hpod_gait_s* gait, struct hpod_vector3_s* movement, int slices,
+                         struct hpod_gait_slice_s* shape, struct hpod_gait_angles_s* angles)
+{
+    if (angles != NULL && !hexapod->uniform) {
+        return -1;
+    }
+
+    return gait_table_init(table, hexapod, -1, gait, movement, slices, shape, angles);
+}
+
+/**
+ * @brief Build a gait table for a specific leg
+ * As HPOD_gait_table_init, with the stride rotated into the frame of the provided leg and
+ * angles solved with its links, so lookups match HPOD_gait_calc_leg without rotation
+ * (movement->z).
+ */
+int HPOD_gait_table_init_n(struct hpod_gait_table_s* table, struct hexapod_s* hexapod, int leg,
+                           struct hpod_gait_s* gait, struct hpod_vector3_s* movement, int slices,
+                           struct hpod_gait_slice_s* shape, struct hpod_gait_angles_s* angles)
+{
+    return gait_table_init(table, hexapod, leg, gait, movement, slices, shape, angles);
+}
+
+/**
+ * @brief Update the movement vector of a gait table
+ * Only rescales the sampled shape, precomputed angles (if enabled) are re-solved
+ * from the existing samples without re-evaluating the gait.
+ * Returns 0 on success or the number of slices with no IK solution.
+ */
+int HPOD_gait_table_set_movement(struct hpod_gait_table_s* table, struct hpod_vector3_s* movement)
+{
+    table->movement = *movement;
+    table->kx = table->gait.movement.x / 2 * movement->x;
+    table->ky = table->gait.movement.y / 2 * movement->y;
+
+    // Stride from straight outwards into the leg frame, as HPOD_gait_calc_leg
+    if (table->leg >= 0) {
+        struct hpod_leg_mount_s *mount = &table->hexapod->leg[table->leg].mount;
+        float kx = table->kx, ky = table->ky;
+        table->kx = mount->cos_yaw * kx + mount->sin_yaw * ky;
+        table->ky = mount->cos_yaw * ky - mount->sin_yaw * kx;
+    }
+
+    if (table->angles == NULL) {
+        return 0;
+    }
+
+    return gait_table_solve(table);
+}
+
+/**
+ * @brief Calculate the position of a limb from a gait table
+ * Equivalent to HPOD_gait_calc with the table gait and movement, or HPOD_gait_calc_leg
+ * without rotation for tables from HPOD_gait_table_init_n
+ */
+void HPOD_gait_table_calc(struct hpod_gait_table_s* table, float phase_scl, enum hpod_interp_e interp,
+                          struct hpod_vector3_s* leg_pos)
+{
+    const struct hpod_gait_slice_s *shape = table->shape;
+    const int n = table->slices;
+    float t;
+    float s, z;
+
+    int i = gait_table_index(table, phase_scl, &t);
+    int i1 = (i + 1 == n) ? 0 : i + 1;
+
+    if (interp == HPOD_INTERP_CUBIC) {
+        int i0 = (i == 0) ? n - 1 : i - 1;
+        int i2 = (i1 + 1 == n) ? 0 : i1 + 1;
+
+        s = gait_table_cubic(shape[i0].sin, shape[i].sin, shape[i1].sin, shape[i2].sin, t);
+        z = gait_table_cubic(shape[i0].z, shape[i].z, shape[i1].z, shape[i2].z, t);
+    } else {
+        s = shape[i].sin + (shape[i1].sin - shape[i].sin) * t;
+        z = shape[i].z + (shape[i1].z - shape[i].z) * t;
+    }
+
+    leg_pos->x = s * table->kx + table->gait.offset.x;
+    leg_pos->y = s * table->ky;
+    leg_pos->z = z;
+}
+
+/**
+ * @brief Fetch precomputed leg angles from a gait table
+ * Returns -1 if angles are not enabled for this table or are not valid at this phase
+ */
+int HPOD_gait_table_angles(struct hpod_gait_table_s* table, float phase_scl, enum hpod_interp_e interp,
+                           float* alpha, float* beta, float* theta)
+{
+    const struct hpod_gait_angles_s *a = table->angles;
+    const int n = table->slices;
+    float t;
+
+    if (a == NULL) {
+        return -1;
+    }
+
+    int i = gait_table_index(table, phase_scl, &t);
+    int i1 = (i + 1 == n) ? 0 : i + 1;
+
+    if (interp == HPOD_INTERP_CUBIC) {
+        int i0 = (i == 0) ? n - 1 : i - 1;
+        int i2 = (i1 + 1 == n) ? 0 : i1 + 1;
+
+        *alpha = gait_table_cubic(a[i0].alpha, a[i].alpha, a[i1].alpha, a[i2].alpha, t);
+        *beta = gait_table_cubic(a[i0].beta, a[i].beta, a[i1].beta, a[i2].beta, t);
+        *theta = gait_table_cubic(a[i0].theta, a[i].theta, a[i1].theta, a[i2].theta, t);
+    } else {
+        *alpha = a[i].alpha + (a[i1].alpha - a[i].alpha) * t;
+        *beta = a[i].beta + (a[i1].beta - a[i].beta) * t;
+        *theta = a[i].theta + (a[i1].theta - a[i].theta) * t;
+    }
+
+    if (isnan(*alpha) || isnan(*beta) || isnan(*theta)) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -8,28 +8,113 @@
  */
 
 #include "hexapod/hexapod.h"
+#include "hexapod/gait_search.h"
+#include "hexapod/gait_pattern.h"
 
 #include <stdint.h>
 #include <math.h>
 #include <stdio.h>
 
-// Hexapod leg offset instance
-struct leg_offset_s leg_offsets[6] = {
-    {  1, -1,  1 }, { -1, 1,  1 },
-    { -1, -1,  0 }, {  1, 1,  0 },
-    {  1, -1, -1 }, { -1, 1, -1 }
+// Default leg layout
+const struct leg_offset_s leg_offsets[6] = {
+    { -1,  1 }, { 1,  1 },
+    { -1,  0 }, { 1,  0 },
+    { -1, -1 }, { 1, -1 }
 };
 
+/**
+ * @brief Derive constant leg terms for a pair of links
+ */
+static void kinematics_init(struct hpod_kinematics_s *k, float len_ab, float len_bc)
+{
+    k->len_ab = len_ab;
+    k->len_bc = len_bc;
+    k->len_ab_sq = len_ab * len_ab;
+    k->len_bc_sq = len_bc * len_bc;
+    k->inv_len_ab_2 = 1.0f / (2 * len_ab);
+    k->inv_len_ab_bc_2 = 1.0f / (2 * len_ab * len_bc);
+
+    // Reach envelope of |AC|
+    k->reach_min = HPOD_FABS(len_ab - len_bc);
+    k->reach_max = len_ab + len_bc;
+    k->reach_min_sq = k->reach_min * k->reach_min;
+    k->reach_max_sq = k->reach_max * k->reach_max;
+}
+
 /**
  * @brief Initialise the hexapod instance
+ * Legs are taken from config->leg, or without config->legs, six legs are mounted at the
+ * corners and sides of the length x width body in the order of leg_offsets. Leg counts
+ * are limited to HPOD_MAX_LEGS.
  */
 void HPOD_init(struct hexapod_s* hexapod, struct hexapod_config_s* config)
 {
-    hexapod->config.width = config->width;
-    hexapod->config.length = config->length;
-    hexapod->config.offset_a = config->offset_a;
-    hexapod->config.len_ab = config->len_ab;
-    hexapod->config.len_bc = config->len_bc;
+    hexapod->config = *config;
+    kinematics_init(&hexapod->kinematics, config->len_ab, config->len_bc);
+
+    if (config->legs <= 0) {
+        hexapod->config.legs = 6;
+        for (int i = 0; i < 6; i++) {
+            struct hpod_leg_config_s leg = {leg_offsets[i].x * config->width / 2,
+                                            leg_offsets[i].y * config->length / 2
+                                           };
+            hexapod->config.leg[i] = leg;
+        }
+    }
+
+    hexapod->legs = HPOD_LIMIT_RANGE(0, HPOD_MAX_LEGS, hexapod->config.legs);
+    hexapod->uniform = 1;
+    hexapod->aligned = 1;
+
+    // Leg mounts in each leg frame, used to rotate feet about the body center
+    for (int i = 0; i < hexapod->legs; i++) {
+        struct hpod_leg_config_s *c = &hexapod->config.leg[i];
+        struct hpod_leg_s *leg = &hexapod->leg[i];
+        float len_ab = (c->len_ab != 0.0f) ? c->len_ab : config->len_ab;
+        float len_bc = (c->len_bc != 0.0f) ? c->len_bc : config->len_bc;
+
+        leg->mount.side = (c->x < 0.0f) ? -1.0f : 1.0f;
+        leg->mount.cos_yaw = cosf(c->yaw);
+        leg->mount.sin_yaw = sinf(c->yaw);
+        leg->mount.x = leg->mount.cos_yaw * leg->mount.side * c->x + leg->mount.sin_yaw * c->y;
+        leg->mount.y = leg->mount.cos_yaw * c->y - leg->mount.sin_yaw * leg->mount.side * c->x;
+
+        leg->offset_a = (c->offset_a != 0.0f) ? c->offset_a : config->offset_a;
+        kinematics_init(&leg->kinematics, len_ab, len_bc);
+
+        // Link uniformity is all the joint frame solvers need, mount yaw only changes the gait
+        hexapod->uniform &= (len_ab == config->len_ab && len_bc == config->len_bc
+                             && leg->offset_a == config->offset_a);
+        hexapod->aligned &= (c->yaw == 0.0f);
+    }
+}
+
+/**
+ * @brief 2 Joint Arm Inverse Kinematics with precomputed |AC|^2
+ * With clamp set the cosines are limited to [-1, 1], so targets inside the reach envelope
+ * always solve despite rounding (as in HPOD_leg_ik3_batch).
+ */
+static inline void leg_ik2_sq(struct hpod_kinematics_s *k, float d, float h, float len_ac_sq,
+                              int clamp, float* alpha, float* beta)
+{
+    // Calculate length between A & C
+    float len_ac = HPOD_SQRT(len_ac_sq);
+
+    // Calculate rotational offset from zero frame (h = 0)
+    float angle_dh = HPOD_ATAN2(h,  d);
+
+    // Split into two regular triangles & calculate length of shared face
+    float cos_a = (len_ac_sq + k->len_ab_sq - k->len_bc_sq) * k->inv_len_ab_2 / len_ac;
+    float cos_b = (k->len_ab_sq + k->len_bc_sq - len_ac_sq) * k->inv_len_ab_bc_2;
+
+    if (clamp) {
+        cos_a = fminf(fmaxf(cos_a, -1.0f), 1.0f);
+        cos_b = fminf(fmaxf(cos_b, -1.0f), 1.0f);
+    }
+
+    // Convert back into world frame
+    *alpha = acosf(cos_a) + angle_dh;
+    *beta = acosf(cos_b);
 }
 
 /**
@@ -53,48 +138,98 @@ void HPOD_init(struct hexapod_s* hexapod, struct hexapod_config_s* config)
  */
 void HPOD_leg_ik2(struct hexapod_s* hexapod, float d, float h, float* alpha, float* beta)
 {
-    // Calculate length between A & C
-    float len_ac = sqrt(pow(d, 2) + pow(h, 2));
+    leg_ik2_sq(&hexapod->kinematics, d, h, HPOD_SQ(d) + HPOD_SQ(h), 0, alpha, beta);
+}
 
-    // Calculate rotational offset from zero frame (h = 0)
-    float angle_dh = atan2(h,  d);
+/**
+ * @brief 3 Joint Arm Inverse Kinematics for a set of leg constants
+ */
+static inline int leg_ik3(struct hpod_kinematics_s *k, float offset_a, struct hpod_vector3_s *end_pos,
+                          float* alpha, float* beta, float* theta)
+{
+    // Calculate distance and angle from origin to point (x, y)
+    // Squares are single precision so the envelope test matches HPOD_leg_ik3_batch exactly
+    float len_xy = HPOD_SQRT(end_pos->x * end_pos->x + end_pos->y * end_pos->y);
+    float angle_xy = HPOD_ATAN2(end_pos->y, end_pos->x);
+
+    // Total distance in the leg plane (less offset between joints at A)
+    float d = len_xy - offset_a;
+    float len_ac_sq = d * d + end_pos->z * end_pos->z;
+
+    // Reject targets outside of the reach envelope (or at joint A) before solving
+    if (!(len_ac_sq >= k->reach_min_sq && len_ac_sq <= k->reach_max_sq && len_ac_sq > 0.0f)) {
+        *alpha = NAN;
+        *beta = NAN;
+        *theta = NAN;
+        return -1;
+    }
 
-    // Split into two regular triangles & calculate length of shared face
-    float angle_a = acosf((pow(len_ac, 2) + pow(hexapod->config.len_ab, 2) - pow(hexapod->config.len_bc, 2))
-                          / (2 * len_ac * hexapod->config.len_ab));
-    float angle_b = acosf((pow(hexapod->config.len_ab, 2) + pow(hexapod->config.len_bc, 2) - pow(len_ac, 2))
-                          / (2 * hexapod->config.len_ab * hexapod->config.len_bc));
+    // Process ik2 equation
+    leg_ik2_sq(k, d, end_pos->z, len_ac_sq, 1, alpha, beta);
 
-    // Convert back into world frame
-    *alpha = angle_a + angle_dh;
-    *beta = angle_b;
+    // Output angle theta
+    *theta = angle_xy;
+
+    // Check for valid solution
+    if (isnan(*alpha) || isnan(*beta) || isnan(*theta)) {
+        return -1;
+    }
+
+    return 0;
 }
 
 /**
  * @brief 3 Joint Arm Inverse Kinematics
  * Adds planar rotation theta at joint A (offset by hexapod.offset_a)
+ * Returns -1 with NaN angles for targets outside of the reach envelope
  * X direction is outwards from the hexapod, Y is forwards and backward
  * H is offset from zero (in line) position
  */
 int HPOD_leg_ik3(struct hexapod_s* hexapod, struct hpod_vector3_s *end_pos,
                  float* alpha, float* beta, float* theta)
 {
-    // Calculate distance and angle from origin to point (x, y)
-    float len_xy = sqrt(pow(end_pos->x, 2) + pow(end_pos->y, 2));
-    float angle_xy = atan2(end_pos->y, end_pos->x);
+    return leg_ik3(&hexapod->kinematics, hexapod->config.offset_a, end_pos, alpha, beta, theta);
+}
 
-    // Process ik2 equation with total distance (less offset between joints at A)
-    HPOD_leg_ik2(hexapod, len_xy - hexapod->config.offset_a, end_pos->z, alpha, beta);
+/**
+ * @brief 3 Joint Arm Inverse Kinematics for a specific leg
+ * As HPOD_leg_ik3, using the links of the provided leg
+ */
+int HPOD_leg_ik3_n(struct hexapod_s* hexapod, int leg, struct hpod_vector3_s *end_pos,
+                   float* alpha, float* beta, float* theta)
+{
+    struct hpod_leg_s *l = &hexapod->leg[leg];
 
-    // Output angle theta
-    *theta = angle_xy;
+    return leg_ik3(&l->kinematics, l->offset_a, end_pos, alpha, beta, theta);
+}
 
-    // Check for valid solution
-    if (isnan(*alpha) || isnan(*beta) || isnan(*theta)) {
-        return -1;
-    }
+static void leg_fk2(const struct hpod_kinematics_s *k, float alpha, float beta,
+                    float* x, float* h)
+{
+    // Joint B position
+    float b_x = k->len_ab * cosf(alpha);
+    float b_h = k->len_ab * sinf(alpha);
 
-    return 0;
+    // Joint C position
+    float world_beta = HPOD_PI - alpha - beta;
+    *x = b_x + k->len_bc * cosf(world_beta);
+    *h = b_h - k->len_bc * sinf(world_beta);
+}
+
+static void leg_fk3(const struct hpod_kinematics_s *k, float offset_a,
+                    float alpha, float beta, float theta, struct hpod_vector3_s *end_pos)
+{
+    // Joint A position
+    float a_x = cosf(theta) * offset_a;
+    float a_y = sinf(theta) * offset_a;
+
+    float c_d, c_h;
+
+    leg_fk2(k, alpha, beta, &c_d, &c_h);
+
+    end_pos->x = a_x + c_d * cosf(theta);
+    end_pos->y = a_y + c_d * sinf(theta);
+    end_pos->z = c_h;
 }
 
 /**
@@ -106,16 +241,18 @@ int HPOD_leg_ik3(struct hexapod_s* hexapod, struct hpod_vector3_s *end_pos,
 void HPOD_leg_fk2(struct hexapod_s* hexapod, float alpha, float beta,
                   float* x, float* h)
 {
-    // Joint B position
-    float b_x = hexapod->config.len_ab * cosf(alpha);
-    float b_h = hexapod->config.len_ab * sinf(alpha);
-
-    // Joint C position
-    float world_beta = M_PI - alpha - beta;
-    *x = b_x + hexapod->config.len_bc * cosf(world_beta);
-    *h = b_h - hexapod->config.len_bc * sinf(world_beta);
+    leg_fk2(&hexapod->kinematics, alpha, beta, x, h);
 }
 
+/**
+ * @brief 2 Joint Arm Forward Kinematics for a specific leg
+ * As HPOD_leg_fk2, using the links of the provided leg
+ */
+void HPOD_leg_fk2_n(struct hexapod_s* hexapod, int leg, float alpha, float beta,
+                    float* x, float* h)
+{
+    leg_fk2(&hexapod->leg[leg].kinematics, alpha, beta, x, h);
+}
 
 /**
  * @brief 3 Joint Arm Forward Kinematics
@@ -127,20 +264,19 @@ void HPOD_leg_fk2(struct hexapod_s* hexapod, float alpha, float beta,
 void HPOD_leg_fk3(struct hexapod_s* hexapod, float alpha, float beta, float theta,
                   struct hpod_vector3_s *end_pos)
 {
-    // Joint A position
-    float a_x = cosf(theta) * hexapod->config.offset_a;
-    float a_y = sinf(theta) * hexapod->config.offset_a;
-    float a_h = 0;
-
-    float c_d, c_h;
-
-    HPOD_leg_fk2(hexapod, alpha, beta, &c_d, &c_h);
+    leg_fk3(&hexapod->kinematics, hexapod->config.offset_a, alpha, beta, theta, end_pos);
+}
 
-    float len_ac = sqrt(pow(c_d, 2) + pow(c_h, 2));
+/**
+ * @brief 3 Joint Arm Forward Kinematics for a specific leg
+ * As HPOD_leg_fk3, using the links and offset_a of the provided leg
+ */
+void HPOD_leg_fk3_n(struct hexapod_s* hexapod, int leg, float alpha, float beta, float theta,
+                    struct hpod_vector3_s *end_pos)
+{
+    struct hpod_leg_s *l = &hexapod->leg[leg];
 
-    end_pos->x = a_x + c_d * cosf(theta);
-    end_pos->y = a_y + c_d * sinf(theta);
-    end_pos->z = c_h;
+    leg_fk3(&l->kinematics, l->offset_a, alpha, beta, theta, end_pos);
 }
 
 
@@ -183,10 +319,10 @@ void HPOD_body_transform_pitch(struct hexapod_s* hexapod, float pitch, int offse
     float world_z = world_pos->z - offset_y * sinf(pitch);
 
     // Calculate shared length for world and local frame
-    float len_ef = sqrt(pow(world_pos->y, 2) + pow(world_z, 2));
+    float len_ef = HPOD_SQRT(HPOD_SQ(world_pos->y) + HPOD_SQ(world_z));
 
     // Calculate the require angle in the world frame
-    float angle_feg = atan2(world_pos->y, world_z);
+    float angle_feg = HPOD_ATAN2(world_pos->y, world_z);
 
     // Calculate required angle in the local frame so that adb = pi/2
     float angle_feh = angle_feg + pitch;
@@ -212,10 +348,10 @@ void HPOD_body_transform_roll(struct hexapod_s* hexapod, float roll, int offset_
     float world_z = world_pos->z - offset_x * sinf(roll);
 
     // Calculate shared length for world and local frame
-    float len_ab = sqrt(pow(world_pos->x, 2) + pow(world_z, 2));
+    float len_ab = HPOD_SQRT(HPOD_SQ(world_pos->x) + HPOD_SQ(world_z));
 
     // Calculate the require angle in the world frame
-    float angle_bac = atan2(world_pos->x, world_z);
+    float angle_bac = HPOD_ATAN2(world_pos->x, world_z);
 
     // Calculate required angle in the local frame so that adb = pi/2
     float angle_bad = angle_bac + roll;
@@ -259,85 +395,130 @@ void HPOD_world_roll_pitch(struct hexapod_s* hexapod, float angle, int offset,
 
 float normalize_angle(float angle)
 {
-    float a = fmod(angle + M_PI, 2 * M_PI);
-    return a >= 0 ? (a - M_PI) : (a + M_PI);
+    float a = HPOD_FMOD(angle + HPOD_PI, 2 * HPOD_PI);
+    return a >= 0 ? (a - HPOD_PI) : (a + HPOD_PI);
 }
 
 /**
- * @brief Calculate the position of a limb for a provided gait with specified motion at a given walking phase
- * Phase is -1 to 1, with contact between -0.5 and 0.5 to help merge movements.
+ * @brief Gait translation and height, returning the stride sine for rotation
  */
-void HPOD_gait_calc(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
-                    float phase_scl, hpod_vector3_t* leg_pos)
+static inline float gait_calc(struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
+                              float phase_scl, hpod_vector3_t* leg_pos)
 {
-    float phase_scl_wrapped = fmod(phase_scl + 3.0, 2.0) - 1.0; 
-    float phase_rads = phase_scl_wrapped * M_PI;
+    float phase_scl_wrapped = HPOD_FMOD(phase_scl + 3.0f, 2.0f) - 1.0f;
+    float phase_rads = phase_scl_wrapped * HPOD_PI;
+    float stride = sinf(phase_rads);
 
     // Forward walk
-    leg_pos->x = sinf(phase_rads) * gait->movement.x / 2 * movement->x + gait->offset.x;
-    leg_pos->y = sinf(phase_rads) * gait->movement.y / 2 * movement->y;// + gait->offset.y;
+    leg_pos->x = stride * gait->movement.x / 2 * movement->x + gait->offset.x;
+    leg_pos->y = stride * gait->movement.y / 2 * movement->y;// + gait->offset.y;
 
     // Height morphing determined by height_scale as a fraction of the phase for the height to change over
-    if (fabs(phase_scl_wrapped) < (0.5)) {
+    if (HPOD_FABS(phase_scl_wrapped) < (0.5f)) {
         // Leg down state
         leg_pos->z = -gait->movement.z / 2 + gait->offset.z;
-    } else if (fabs(phase_scl_wrapped) > (0.5 + gait->height_scale)) {
+    } else if (HPOD_FABS(phase_scl_wrapped) > (0.5f + gait->height_scale)) {
         // Leg up state
         leg_pos->z = gait->movement.z / 2 + gait->offset.z;
-    } else if (phase_scl_wrapped > 0.0) {
+    } else if (phase_scl_wrapped > 0.0f) {
         // Transitioning down state
-        leg_pos->z = cosf((phase_scl_wrapped - 0.5 + gait->height_scale) / gait->height_scale * M_PI)
+        leg_pos->z = cosf((phase_scl_wrapped - 0.5f + gait->height_scale) / gait->height_scale * HPOD_PI)
                      * gait->movement.z / 2 + gait->offset.z;
     } else {
         // Transitioning up state
-        leg_pos->z = cosf((phase_scl_wrapped + 0.5 - gait->height_scale) / gait->height_scale * M_PI)
+        leg_pos->z = cosf((phase_scl_wrapped + 0.5f - gait->height_scale) / gait->height_scale * HPOD_PI)
                      * gait->movement.z / 2 + gait->offset.z;
     }
 
-    // TODO: how do I integrate rotation into this?
+    return stride;
 }
 
-#define CHECK_SLICES    100
+/**
+ * @brief Calculate the position of a limb for a provided gait with specified motion at a given walking phase
+ * Phase is -1 to 1, with contact between -0.5 and 0.5 to help merge movements.
+ * Rotation (movement->z) depends on the leg mount, see HPOD_gait_calc_leg.
+ */
+void HPOD_gait_calc(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
+                    float phase_scl, hpod_vector3_t* leg_pos)
+{
+    gait_calc(gait, movement, phase_scl, leg_pos);
+}
 
-int HPOD_gait_valid(struct hexapod_s* hexapod, struct hpod_gait_s *gait)
+/**
+ * @brief Calculate the position of a specific limb for a provided gait, including rotation
+ * As HPOD_gait_calc, with movement->z rotating the body by up to gait->yaw per stride.
+ * Feet sweep around the body center (counter clockwise during contact for positive
+ * movement->z, as positive movement->y sweeps them forwards), so combined movements walk
+ * an arc. Rotation uses the leg mounts cached by HPOD_init and a polynomial sin / cos of
+ * the stride angle, so it adds no trig calls. On legs with a mount yaw the stride is
+ * rotated into the leg frame, so every leg walks in the same body direction.
+ */
+void HPOD_gait_calc_leg(struct hexapod_s* hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
+                        float phase_scl, int leg, struct hpod_vector3_s* leg_pos)
 {
+    struct hpod_leg_mount_s *mount = &hexapod->leg[leg].mount;
 
-    struct hpod_vector3_s movements[2] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}};
-    struct hpod_vector3_s position;
+    float stride = gait_calc(gait, movement, phase_scl, leg_pos);
+    float angle = stride * gait->yaw / 2 * movement->z * mount->side;
 
-    float a, b, t;
+    // Stride from straight outwards into the leg frame
+    float stride_x = stride * gait->movement.x / 2 * movement->x;
+    float stride_y = leg_pos->y;
+    leg_pos->x = mount->cos_yaw * stride_x + mount->sin_yaw * stride_y + gait->offset.x;
+    leg_pos->y = mount->cos_yaw * stride_y - mount->sin_yaw * stride_x;
 
-    for (int m = 0; m < 2; m++) {
+    // Foot relative to the body center, in the leg frame (mirrored legs rotate the other way)
+    float foot_x = mount->x + leg_pos->x;
+    float foot_y = mount->y + leg_pos->y;
 
-        for (float i = 0; i < CHECK_SLICES; i++) {
-            float phase = i / (((float)CHECK_SLICES - 1) / 4) - 2.0;
+    // sin(a) and cos(a) - 1 to fourth order, exact zero displacement without rotation
+    float a_sq = angle * angle;
+    float sin_a = angle * (1.0f - a_sq / 6.0f * (1.0f - a_sq / 20.0f));
+    float cos_a_1 = -a_sq / 2.0f * (1.0f - a_sq / 12.0f);
 
-            HPOD_gait_calc(hexapod, gait, &movements[m], phase, &position);
+    leg_pos->x += cos_a_1 * foot_x - sin_a * foot_y;
+    leg_pos->y += sin_a * foot_x + cos_a_1 * foot_y;
+}
 
-            int res = HPOD_leg_ik3(hexapod, &position, &a, &b, &t);
-            if (res < 0) {
-                return -m;
-            }
-        }
-    }
+#define CHECK_SLICES    100
 
-    return 0;
+// Movements checked by HPOD_gait_valid, full scale on each axis and half scale arcs
+#define CHECK_MOVEMENTS 7
+
+/**
+ * @brief Check a gait can be solved for sideways, forward, rotating and arc movement
+ * Returns 0 if the gait is valid, -1 otherwise. Use HPOD_gait_check for the failing phase.
+ */
+int HPOD_gait_valid(struct hexapod_s* hexapod, struct hpod_gait_s *gait)
+{
+    struct hpod_vector3_s movements[CHECK_MOVEMENTS] = {
+        {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+        {0.5f, 0.0f, 0.5f}, {0.5f, 0.0f, -0.5f}, {0.0f, 0.5f, 0.5f}, {0.0f, 0.5f, -0.5f}
+    };
+    struct hpod_gait_check_s result;
+
+    return HPOD_gait_check(hexapod, gait, movements, CHECK_MOVEMENTS, CHECK_SLICES, NULL, &result);
 }
 
+/**
+ * @brief Calculate leg angles for every leg at a given walking phase
+ * outputs must have hexapod->legs entries.
+ */
 void HPOD_output_mix(struct hexapod_s *hexapod, struct hpod_gait_s *gait, struct hpod_vector3_s *movement,
-                     float phase_scl, float outputs[6][3])
+                     float phase_scl, float outputs[][3])
 {
     // Calculate the position of each leg
-    for (int i = 0; i < 6; i++) {
+    for (int i = 0; i < hexapod->legs; i++) {
 
         //Calculate Gait position
         struct hpod_vector3_s position;
-        HPOD_gait_calc(hexapod, gait, movement, phase_scl * leg_offsets[i].phase, &position);
+        float phase = HPOD_gait_pattern_phase(&gait->pattern, phase_scl, i);
+        HPOD_gait_calc_leg(hexapod, gait, movement, phase, i, &position);
 
-        // TODO: Transform based on body position
+        // Body pose transforms are applied by HPOD_pipeline
 
         // Calculate servo control for each leg
-        HPOD_leg_ik3(hexapod, &position, &outputs[i][0], &outputs[i][1], &outputs[i][2]);
+        HPOD_leg_ik3_n(hexapod, i, &position, &outputs[i][0], &outputs[i][1], &outputs[i][2]);
     }
 
 }
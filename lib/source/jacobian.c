@@ -0,0 +1,294 @@
+/**
+ * Libhexapod
+ * Hexapod leg Jacobian
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/jacobian.h"
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Leg plane partial derivatives
+ * With world_beta = pi - alpha - beta (as in HPOD_leg_fk2) the leg plane position is
+ *   d = len_ab * cos(alpha) - len_bc * cos(alpha + beta)
+ *   h = len_ab * sin(alpha) - len_bc * sin(alpha + beta)
+ * and the foot is at ((offset_a + d) cos(theta), (offset_a + d) sin(theta), h)
+ */
+struct leg_partials_s {
+    float d_a, d_b;     //!< dd/dalpha, dd/dbeta
+    float h_a, h_b;     //!< dh/dalpha, dh/dbeta
+    float r;            //!< Planar distance from the body joint (offset_a + d)
+};
+
+// Planar determinant below which the warm start solver falls back to the analytic IK
+#define IK_WARM_MIN_DET     1.0f
+
+// Initial foot error (mm) above which the warm start is skipped, well beyond a tick of gait motion
+#define IK_WARM_MAX_ERROR   10.0f
+
+static inline void leg_partials(const struct hpod_kinematics_s* k, float offset_a,
+                                float alpha, float beta, struct leg_partials_s* p)
+{
+    float sin_a = sinf(alpha), cos_a = cosf(alpha);
+    float sin_ab = sinf(alpha + beta), cos_ab = cosf(alpha + beta);
+
+    p->d_b = k->len_bc * sin_ab;
+    p->d_a = -k->len_ab * sin_a + p->d_b;
+    p->h_b = -k->len_bc * cos_ab;
+    p->h_a = k->len_ab * cos_a + p->h_b;
+
+    // dh/dalpha is the planar reach of the leg (d), and h = -dd/dalpha
+    p->r = offset_a + p->h_a;
+}
+
+static void leg_jacobian(const struct hpod_kinematics_s* k, float offset_a,
+                         float alpha, float beta, float theta, float jacobian[3][3])
+{
+    struct leg_partials_s p;
+    float sin_t = sinf(theta), cos_t = cosf(theta);
+
+    leg_partials(k, offset_a, alpha, beta, &p);
+
+    jacobian[0][0] = cos_t * p.d_a;
+    jacobian[0][1] = cos_t * p.d_b;
+    jacobian[0][2] = -sin_t * p.r;
+
+    jacobian[1][0] = sin_t * p.d_a;
+    jacobian[1][1] = sin_t * p.d_b;
+    jacobian[1][2] = cos_t * p.r;
+
+    jacobian[2][0] = p.h_a;
+    jacobian[2][1] = p.h_b;
+    jacobian[2][2] = 0.0f;
+}
+
+/**
+ * @brief 3 Joint Arm Jacobian
+ * Computes the analytic Jacobian of HPOD_leg_fk3 at the provided joint angles,
+ * jacobian[i][j] is the derivative of foot axis i (x, y, z) by joint j (alpha, beta, theta)
+ */
+void HPOD_leg_jacobian(struct hexapod_s* hexapod, float alpha, float beta, float theta,
+                       float jacobian[3][3])
+{
+    leg_jacobian(&hexapod->kinematics, hexapod->config.offset_a, alpha, beta, theta, jacobian);
+}
+
+/**
+ * @brief 3 Joint Arm Jacobian for a specific leg
+ * As HPOD_leg_jacobian, the Jacobian of HPOD_leg_fk3_n for the provided leg
+ */
+void HPOD_leg_jacobian_n(struct hexapod_s* hexapod, int leg, float alpha, float beta, float theta,
+                         float jacobian[3][3])
+{
+    struct hpod_leg_s* l = &hexapod->leg[leg];
+
+    leg_jacobian(&l->kinematics, l->offset_a, alpha, beta, theta, jacobian);
+}
+
+static int leg_ik3_velocity(const struct hpod_kinematics_s* k, float offset_a,
+                            float alpha, float beta, float theta,
+                            struct hpod_vector3_s* velocity, float damping,
+                            float* d_alpha, float* d_beta, float* d_theta)
+{
+    struct leg_partials_s p;
+    float sin_t = sinf(theta), cos_t = cosf(theta);
+    float damping_sq = damping * damping;
+
+    leg_partials(k, offset_a, alpha, beta, &p);
+
+    // Rotate the foot velocity into the leg plane
+    float v_d = cos_t * velocity->x + sin_t * velocity->y;
+    float v_t = -sin_t * velocity->x + cos_t * velocity->y;
+    float v_h = velocity->z;
+
+    // Planar determinant, equal to -len_ab * len_bc * sin(beta)
+    float det = p.d_a * p.h_b - p.d_b * p.h_a;
+
+    if (HPOD_FABS(det) >= damping_sq && HPOD_FABS(p.r) >= damping) {
+        *d_alpha = (p.h_b * v_d - p.d_b * v_h) / det;
+        *d_beta = (-p.h_a * v_d + p.d_a * v_h) / det;
+        *d_theta = v_t / p.r;
+
+        return HPOD_VELOCITY_EXACT;
+    }
+
+    // Damped least squares, q = J^T (J J^T + damping^2 I)^-1 v
+    float a = p.d_a * p.d_a + p.d_b * p.d_b + damping_sq;
+    float b = p.d_a * p.h_a + p.d_b * p.h_b;
+    float c = p.h_a * p.h_a + p.h_b * p.h_b + damping_sq;
+    float inv_det = 1.0f / (a * c - b * b);
+
+    float y_d = (c * v_d - b * v_h) * inv_det;
+    float y_h = (-b * v_d + a * v_h) * inv_det;
+
+    *d_alpha = p.d_a * y_d + p.h_a * y_h;
+    *d_beta = p.d_b * y_d + p.h_b * y_h;
+    *d_theta = p.r * v_t / (p.r * p.r + damping_sq);
+
+    return HPOD_VELOCITY_DAMPED;
+}
+
+/**
+ * @brief 3 Joint Arm Velocity Inverse Kinematics
+ * Solves joint velocities (rad/s) for a foot velocity (mm/s) at the current joint angles.
+ * The Jacobian is a rotation by theta of a block diagonal matrix, so the planar joints
+ * (alpha, beta) and theta are solved independently.
+ * Near a singularity (leg straight or folded, |dx/dbeta x dh/dalpha| < damping^2, or the foot
+ * within damping of the body joint axis) damped least squares is used, which limits joint
+ * velocities at the cost of tracking error. Returns the hpod_velocity_e solution type, or -1
+ * without writing outputs if the legs do not share links (see HPOD_leg_ik3_velocity_n).
+ */
+int HPOD_leg_ik3_velocity(struct hexapod_s* hexapod, float alpha, float beta, float theta,
+                          struct hpod_vector3_s* velocity, float damping,
+                          float* d_alpha, float* d_beta, float* d_theta)
+{
+    if (!hexapod->uniform) {
+        return -1;
+    }
+
+    return leg_ik3_velocity(&hexapod->kinematics, hexapod->config.offset_a, alpha, beta, theta,
+                            velocity, damping, d_alpha, d_beta, d_theta);
+}
+
+/**
+ * @brief 3 Joint Arm Velocity Inverse Kinematics for a specific leg
+ * As HPOD_leg_ik3_velocity, using the links and offset_a of the provided leg
+ */
+int HPOD_leg_ik3_velocity_n(struct hexapod_s* hexapod, int leg, float alpha, float beta, float theta,
+                            struct hpod_vector3_s* velocity, float damping,
+                            float* d_alpha, float* d_beta, float* d_theta)
+{
+    struct hpod_leg_s* l = &hexapod->leg[leg];
+
+    return leg_ik3_velocity(&l->kinematics, l->offset_a, alpha, beta, theta,
+                            velocity, damping, d_alpha, d_beta, d_theta);
+}
+
+/**
+ * @brief Initialise a warm start IK context
+ * The context solves with the shared links, the first solve with a new context always uses the
+ * analytic IK
+ */
+void HPOD_ik_context_init(struct hpod_ik_context_s* ctx, int max_iterations, float tolerance)
+{
+    ctx->leg = -1;
+    ctx->alpha = 0.0f;
+    ctx->beta = 0.0f;
+    ctx->theta = 0.0f;
+    ctx->valid = 0;
+    ctx->max_iterations = max_iterations;
+    ctx->tolerance = tolerance;
+    ctx->iterations = 0;
+    ctx->solves = 0;
+    ctx->fallbacks = 0;
+}
+
+/**
+ * @brief Initialise a warm start IK context for a specific leg
+ * As HPOD_ik_context_init, solving with the links and offset_a of the provided leg
+ */
+void HPOD_ik_context_init_n(struct hpod_ik_context_s* ctx, int leg, int max_iterations, float tolerance)
+{
+    HPOD_ik_context_init(ctx, max_iterations, tolerance);
+    ctx->leg = leg;
+}
+
+/**
+ * @brief Warm started 3 Joint Arm Inverse Kinematics
+ * Refines the previous solution with at most max_iterations Newton steps on HPOD_leg_fk3,
+ * stopping once the foot is within tolerance of the target, and falling back to HPOD_leg_ik3
+ * if there is no previous solution, the target is outside the reach envelope or has moved too
+ * far, the error grows, or the step limit is reached. Every accepted solution has been checked
+ * against FK, worst case cost is bounded by max_iterations + 1 FK evaluations plus one
+ * analytic solve. The number of Newton steps is left in ctx->iterations.
+ * Contexts from HPOD_ik_context_init_n solve with the links of their leg (and HPOD_leg_ik3_n),
+ * shared contexts return -1 with NaN outputs if the legs do not share links.
+ * Returns 0 on success or -1 (with NaN outputs) for unreachable targets, as HPOD_leg_ik3.
+ */
+int HPOD_leg_ik3_warm(struct hexapod_s* hexapod, struct hpod_ik_context_s* ctx,
+                      struct hpod_vector3_s* end_pos, float* alpha, float* beta, float* theta)
+{
+    float a = ctx->alpha, b = ctx->beta, t = ctx->theta;
+    float tolerance_sq = ctx->tolerance * ctx->tolerance;
+    float last_err_sq = INFINITY;
+
+    ctx->iterations = 0;
+    ctx->solves++;
+
+    if (ctx->leg < 0 && !hexapod->uniform) {
+        *alpha = NAN;
+        *beta = NAN;
+        *theta = NAN;
+        ctx->valid = 0;
+        return -1;
+    }
+
+    const struct hpod_kinematics_s* k = &hexapod->kinematics;
+    float offset_a = hexapod->config.offset_a;
+    if (ctx->leg >= 0) {
+        k = &hexapod->leg[ctx->leg].kinematics;
+        offset_a = hexapod->leg[ctx->leg].offset_a;
+    }
+
+    // Targets outside the reach envelope are left to the analytic IK, so both reject the same
+    // targets rather than accepting a foot within tolerance of an unreachable one
+    float d = sqrtf(end_pos->x * end_pos->x + end_pos->y * end_pos->y) - offset_a;
+    float len_ac_sq = d * d + end_pos->z * end_pos->z;
+    int reachable = (len_ac_sq >= k->reach_min_sq) && (len_ac_sq <= k->reach_max_sq) && (len_ac_sq > 0.0f);
+
+    for (int i = 0; ctx->valid && reachable && i <= ctx->max_iterations; i++) {
+        struct leg_partials_s p;
+        float sin_t = sinf(t), cos_t = cosf(t);
+
+        leg_partials(k, offset_a, a, b, &p);
+
+        // Foot position error, the partials also give d = dh/dalpha and h = -dd/dalpha
+        float e_x = end_pos->x - p.r * cos_t;
+        float e_y = end_pos->y - p.r * sin_t;
+        float e_h = end_pos->z + p.d_a;
+        float err_sq = e_x * e_x + e_y * e_y + e_h * e_h;
+
+        if (err_sq <= tolerance_sq) {
+            ctx->alpha = *alpha = a;
+            ctx->beta = *beta = b;
+            ctx->theta = *theta = t;
+            return 0;
+        }
+
+        float det = p.d_a * p.h_b - p.d_b * p.h_a;
+
+        // Target jumped, diverging, out of steps, or too close to a singularity for a stable step
+        if (err_sq >= last_err_sq || i == ctx->max_iterations
+            || (i == 0 && err_sq > IK_WARM_MAX_ERROR * IK_WARM_MAX_ERROR)
+            || HPOD_FABS(det) < IK_WARM_MIN_DET || HPOD_FABS(p.r) < IK_WARM_MIN_DET) {
+            break;
+        }
+        last_err_sq = err_sq;
+
+        // Newton step, as HPOD_leg_ik3_velocity without damping
+        float e_d = cos_t * e_x + sin_t * e_y;
+        float e_t = -sin_t * e_x + cos_t * e_y;
+
+        a += (p.h_b * e_d - p.d_b * e_h) / det;
+        b += (-p.h_a * e_d + p.d_a * e_h) / det;
+        t += e_t / p.r;
+
+        ctx->iterations++;
+    }
+
+    ctx->fallbacks++;
+
+    int res = (ctx->leg < 0) ? HPOD_leg_ik3(hexapod, end_pos, alpha, beta, theta)
+              : HPOD_leg_ik3_n(hexapod, ctx->leg, end_pos, alpha, beta, theta);
+
+    ctx->alpha = *alpha;
+    ctx->beta = *beta;
+    ctx->theta = *theta;
+    ctx->valid = (res == 0);
+
+    return res;
+}
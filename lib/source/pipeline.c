@@ -0,0 +1,63 @@
+/**
+ * Libhexapod
+ * Hexapod full body pipeline
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/pipeline.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+
+/**
+ * @brief Full body pipeline
+ * Computes servo outputs for every leg from a body transform, movement and walking phase,
+ * equivalent to HPOD_gait_calc_leg -> HPOD_body_pose_apply -> HPOD_leg_ik3_n -> HPOD_servo_scale
+ * for each leg, with leg phases from the gait pattern. Legs are processed one at a time
+ * through every stage so intermediate values stay in registers, and are only stored to the
+ * scratch struct for inspection.
+ *
+ * The transform is built from the body pose with HPOD_body_pose_init, so the pose sines and
+ * cosines are evaluated once per pose rather than once per call.
+ * out must have hexapod->legs entries. Unreachable legs output the servo offset, returns the
+ * number of unreachable legs.
+ */
+int HPOD_pipeline(struct hexapod_s *hexapod, struct hpod_gait_s *gait, struct hpod_servo_s *servo,
+                  struct hpod_body_transform_s *transform, struct hpod_vector3_s *movement, float phase_scl,
+                  struct hpod_pipeline_scratch_s *scratch, int out[][3])
+{
+    int failed = 0;
+
+    for (int i = 0; i < hexapod->legs; i++) {
+        struct hpod_vector3_s position, joint;
+        float alpha, beta, theta;
+
+        // Gait position in the neutral stance
+        float phase = HPOD_gait_pattern_phase(&gait->pattern, phase_scl, i);
+        HPOD_gait_calc_leg(hexapod, gait, movement, phase, i, &position);
+        scratch->gait_pos[i] = position;
+
+        // Held in the stance frame while the body moves
+        HPOD_body_pose_apply_leg(hexapod, transform, i, &position, &joint);
+        scratch->joint_pos[i] = joint;
+
+        int res = HPOD_leg_ik3_n(hexapod, i, &joint, &alpha, &beta, &theta);
+        scratch->angles[i][0] = alpha;
+        scratch->angles[i][1] = beta;
+        scratch->angles[i][2] = theta;
+        scratch->valid[i] = (res == 0);
+        failed += (res != 0);
+
+        // NaN angles from unreachable legs map to the servo offset
+        out[i][0] = HPOD_servo_scale(servo, alpha);
+        out[i][1] = HPOD_servo_scale(servo, beta);
+        out[i][2] = HPOD_servo_scale(servo, theta);
+    }
+
+    return failed;
+}
@@ -11,7 +11,23 @@
 #include <stdint.h>
 #include <math.h>
 
-#define SERVO_LIMIT_RANGE(min, max, val)   ((val < min) ? min : (val > max) ? max : val)
+// Float compares may raise FP exceptions, which stops GCC if-converting (and so vectorising)
+// the channel loops unless trapping math is disabled. Exceptions are not used by the library.
+#if defined(__GNUC__) && !defined(__clang__)
+#define SERVO_VECTORISE __attribute__((optimize("no-trapping-math")))
+#else
+#define SERVO_VECTORISE
+#endif
+
+// Trim, clamp (as compare / select, so it maps to vector min / max) and scale a channel.
+// NaN angles are replaced before conversion so the result is always defined.
+#define SERVO_TABLE_CHANNEL(table, i, angle, output) do {                   \
+        float _a = (angle) + (table)->trim[i];                              \
+        _a = ((angle) == (angle)) ? _a : 0.0f;                              \
+        _a = (_a < (table)->min[i]) ? (table)->min[i] : _a;                 \
+        _a = (_a > (table)->max[i]) ? (table)->max[i] : _a;                 \
+        (output) = (int) (_a * (table)->scale[i] + (table)->center[i]);     \
+    } while (0)
 
 /**
  * @brief Initialise servo adaptor
@@ -30,29 +46,116 @@ void HPOD_servo_init(struct hpod_servo_s *servo, float range_rads, int output_ra
  */
 int HPOD_servo_scale(struct hpod_servo_s *servo, float angle)
 {
-    int output;
+    // fmaxf / fminf return the limit for NaN, so the conversion below is always defined
+    float limited_angle = fminf(fmaxf(angle, -servo->range_rads), servo->range_rads);
+
+    int output = (int) (limited_angle / servo->scale + servo->output_offset);
 
     // Handle NAN values safely
-    if(isnan(angle)) {
-        output = servo->output_offset;
-        return output;
+    return (angle == angle) ? output : servo->output_offset;
+}
+
+/**
+ * @brief Mix servo angles to servo outputs, for legs rows of three joints
+ */
+void HPOD_servo_mix(struct hpod_servo_s *servo, int legs, float in[][3], int out[][3])
+{
+    for (int i = 0; i < legs; i++) {
+        for (int j = 0; j < 3; j++) {
+            out[i][j] = HPOD_servo_scale(servo, in[i][j]);
+        }
     }
+}
+
+/**
+ * @brief Initialise a calibration table for a leg count (limited to HPOD_MAX_LEGS)
+ * Every channel is set to the nominal servo scale, with soft limits at the servo travel
+ * (+- range_rads / 2).
+ */
+void HPOD_servo_table_init(struct hpod_servo_table_s *table, struct hpod_servo_s *servo, int legs)
+{
+    struct hpod_servo_cal_s cal = {
+        0.0f, 1, 1.0f, -servo->range_rads / 2, servo->range_rads / 2, servo->output_offset
+    };
+
+    table->legs = HPOD_LIMIT_RANGE(0, HPOD_MAX_LEGS, legs);
+
+    for (int i = 0; i < HPOD_SERVO_CHANNELS; i++) {
+        HPOD_servo_table_set(table, servo, i, &cal);
+    }
+}
+
+/**
+ * @brief Set the calibration for a single channel
+ */
+void HPOD_servo_table_set(struct hpod_servo_table_s *table, struct hpod_servo_s *servo, int channel,
+                          struct hpod_servo_cal_s *cal)
+{
+    table->trim[channel] = cal->trim;
+    table->min[channel] = cal->min;
+    table->max[channel] = cal->max;
+    table->scale[channel] = cal->direction * cal->gain / servo->scale;
+    table->center[channel] = cal->center;
+}
 
-    float limited_angle = SERVO_LIMIT_RANGE(-servo->range_rads, servo->range_rads, angle);
+/**
+ * @brief Fill an output array with channel centers, as the initial hold values for mixing
+ */
+void HPOD_servo_table_center(struct hpod_servo_table_s *table, int out[][3])
+{
+    for (int l = 0; l < table->legs; l++) {
+        for (int j = 0; j < 3; j++) {
+            out[l][j] = (int) table->center[l * 3 + j];
+        }
+    }
+}
 
-    output = (int) (limited_angle / servo->scale + servo->output_offset);
+/**
+ * @brief Mix the joint angles of every table leg to calibrated servo outputs
+ * Branch free over all channels so it can be vectorised. Angles are trimmed and clamped to
+ * the soft limits, NaN angles (unsolved legs) hold the existing value in out.
+ */
+SERVO_VECTORISE
+void HPOD_servo_table_mix(struct hpod_servo_table_s *table, float in[][3], int out[][3])
+{
+    for (int l = 0; l < table->legs; l++) {
+        for (int j = 0; j < 3; j++) {
+            const int i = l * 3 + j;
+            float a = in[l][j];
+            int output;
+            SERVO_TABLE_CHANNEL(table, i, a, output);
 
-    return output;
+            out[l][j] = (a == a) ? output : out[l][j];
+        }
+    }
 }
 
 /**
- * @brief Mix all servo angles to servo outputs
+ * @brief Mix all joint angles straight into a servo bus frame
+ * Writes each channel as a little endian uint16 at frame + channel * stride, so outputs can be
+ * placed between the per servo fields of a bus frame without an intermediate array.
+ * Counts are clamped to the field range (0 to 0xFFFF) rather than wrapping.
+ * As HPOD_servo_table_mix, NaN angles hold the value already in the frame.
  */
-void HPOD_servo_mix(struct hpod_servo_s *servo, float in[6][3], int out[6][3])
+SERVO_VECTORISE
+void HPOD_servo_table_pack_u16le(struct hpod_servo_table_s *table, float in[][3],
+                                 uint8_t *frame, int stride)
 {
-    for (int i = 0; i < 6; i++) {
+    for (int l = 0; l < table->legs; l++) {
         for (int j = 0; j < 3; j++) {
-            out[i][j] = HPOD_servo_scale(servo, in[i][j]);
+            const int i = l * 3 + j;
+            uint8_t *f = frame + i * stride;
+            float a = in[l][j];
+
+            int output;
+            SERVO_TABLE_CHANNEL(table, i, a, output);
+            int held = f[0] | (f[1] << 8);
+
+            output = (output < 0) ? 0 : output;
+            output = (output > 0xFFFF) ? 0xFFFF : output;
+            output = (a == a) ? output : held;
+            f[0] = (uint8_t) output;
+            f[1] = (uint8_t) (output >> 8);
         }
     }
 }
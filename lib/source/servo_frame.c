@@ -0,0 +1,217 @@
+/**
+ * Libhexapod
+ * Servo bus frame encoding
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/servo_frame.h"
+
+#include "hexapod/hexapod_defs.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+// Offset of the first position field
+#define DXL1_DATA_OFFSET        (HPOD_DXL1_HEADER_LENGTH + 1)
+#define SSC32_DATA_OFFSET       4
+
+static void dxl1_checksum(uint8_t *buffer, int length)
+{
+    uint8_t sum = 0;
+
+    // Checksum covers everything after the FF FF preamble
+    for (int i = 2; i < length - 1; i++) {
+        sum += buffer[i];
+    }
+
+    buffer[length - 1] = ~sum;
+}
+
+static void ssc32_digits(uint8_t *field, int value)
+{
+    value = HPOD_LIMIT_RANGE(0, 9999, value);
+
+    field[3] = '0' + value % 10;
+    field[2] = '0' + value / 10 % 10;
+    field[1] = '0' + value / 100 % 10;
+    field[0] = '0' + value / 1000;
+}
+
+/**
+ * @brief Initialise a servo frame encoder
+ * Lays out the frame for the provided format and leg count in buffer, with each channel
+ * (leg * 3 + joint, legs * 3 entries in ids) addressed to ids[channel] and set to the center
+ * output count.
+ * Returns the frame length, or -1 if the format, leg count or ids are invalid or the buffer
+ * is too small.
+ */
+int HPOD_servo_frame_init(struct hpod_servo_frame_s *frame, enum hpod_servo_format_e format, int legs,
+                          const uint8_t ids[], int center, uint8_t *buffer, int size)
+{
+    if (legs < 1 || legs > HPOD_MAX_LEGS) {
+        return -1;
+    }
+
+    const int channels = legs * 3;
+
+    switch (format) {
+    case HPOD_SERVO_FORMAT_DXL1:
+        if (size < HPOD_DXL1_FRAME_LENGTH(channels)) {
+            return -1;
+        }
+        for (int i = 0; i < channels; i++) {
+            if (ids[i] >= HPOD_DXL1_BROADCAST_ID) {
+                return -1;
+            }
+        }
+
+        buffer[0] = 0xFF;
+        buffer[1] = 0xFF;
+        buffer[2] = HPOD_DXL1_BROADCAST_ID;
+        buffer[3] = HPOD_DXL1_FRAME_LENGTH(channels) - 4;
+        buffer[4] = HPOD_DXL1_SYNC_WRITE;
+        buffer[5] = HPOD_DXL1_GOAL_POSITION;
+        buffer[6] = HPOD_DXL1_CHANNEL_LENGTH - 1;
+        for (int i = 0; i < channels; i++) {
+            buffer[HPOD_DXL1_HEADER_LENGTH + i * HPOD_DXL1_CHANNEL_LENGTH] = ids[i];
+        }
+
+        frame->length = HPOD_DXL1_FRAME_LENGTH(channels);
+        break;
+
+    case HPOD_SERVO_FORMAT_SSC32:
+        if (size < HPOD_SSC32_FRAME_LENGTH(channels)) {
+            return -1;
+        }
+        for (int i = 0; i < channels; i++) {
+            if (ids[i] > HPOD_SSC32_MAX_CHANNEL) {
+                return -1;
+            }
+        }
+
+        for (int i = 0; i < channels; i++) {
+            uint8_t *field = &buffer[i * HPOD_SSC32_CHANNEL_LENGTH];
+            field[0] = '#';
+            field[1] = '0' + ids[i] / 10;
+            field[2] = '0' + ids[i] % 10;
+            field[3] = 'P';
+        }
+        buffer[HPOD_SSC32_FRAME_LENGTH(channels) - 1] = '\r';
+
+        frame->length = HPOD_SSC32_FRAME_LENGTH(channels);
+        break;
+
+    default:
+        return -1;
+    }
+
+    frame->format = format;
+    frame->legs = legs;
+    frame->buffer = buffer;
+
+    for (int i = 0; i < channels; i++) {
+        frame->counts[i / 3][i % 3] = center;
+    }
+
+    return HPOD_servo_frame_encode(frame, frame->counts);
+}
+
+/**
+ * @brief Encode output counts into the frame
+ * Only position fields and the checksum are rewritten. Counts are clamped to the field
+ * range of the format (0-65535 for Dynamixel, 0-9999 for SSC-32).
+ * Returns the frame length.
+ */
+int HPOD_servo_frame_encode(struct hpod_servo_frame_s *frame, int counts[][3])
+{
+    uint8_t *buffer = frame->buffer;
+    const int channels = frame->legs * 3;
+
+    switch (frame->format) {
+    case HPOD_SERVO_FORMAT_DXL1:
+        for (int i = 0; i < channels; i++) {
+            uint8_t *field = &buffer[DXL1_DATA_OFFSET + i * HPOD_DXL1_CHANNEL_LENGTH];
+            int value = HPOD_LIMIT_RANGE(0, 0xFFFF, counts[i / 3][i % 3]);
+            field[0] = value & 0xFF;
+            field[1] = value >> 8;
+        }
+        dxl1_checksum(buffer, frame->length);
+        break;
+
+    case HPOD_SERVO_FORMAT_SSC32:
+        for (int i = 0; i < channels; i++) {
+            ssc32_digits(&buffer[SSC32_DATA_OFFSET + i * HPOD_SSC32_CHANNEL_LENGTH], counts[i / 3][i % 3]);
+        }
+        break;
+    }
+
+    return frame->length;
+}
+
+/**
+ * @brief Mix joint angles through a calibration table into the frame
+ * Dynamixel positions are packed directly into the frame with HPOD_servo_table_pack_u16le.
+ * NaN angles (unsolved legs) hold the previously encoded output.
+ * Returns the frame length, or -1 if the table and frame leg counts differ.
+ */
+int HPOD_servo_frame_encode_table(struct hpod_servo_frame_s *frame, struct hpod_servo_table_s *table,
+                                  float in[][3])
+{
+    if (table->legs != frame->legs) {
+        return -1;
+    }
+
+    switch (frame->format) {
+    case HPOD_SERVO_FORMAT_DXL1:
+        HPOD_servo_table_pack_u16le(table, in, frame->buffer + DXL1_DATA_OFFSET,
+                                    HPOD_DXL1_CHANNEL_LENGTH);
+        dxl1_checksum(frame->buffer, frame->length);
+        return frame->length;
+
+    case HPOD_SERVO_FORMAT_SSC32:
+        HPOD_servo_table_mix(table, in, frame->counts);
+        break;
+    }
+
+    return HPOD_servo_frame_encode(frame, frame->counts);
+}
+
+/**
+ * @brief Send the encoded frame with a single transport write
+ */
+int HPOD_servo_frame_send(struct hpod_servo_frame_s *frame, struct hpod_servo_transport_s *transport)
+{
+    return transport->write(transport->ctx, frame->buffer, frame->length);
+}
+
+static int fd_write(void *ctx, const uint8_t *data, int length)
+{
+    int fd = *(int *) ctx;
+
+    // Retry partial writes and interrupts, so a frame is never split by a signal
+    while (length > 0) {
+        ssize_t res = write(fd, data, length);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += res;
+        length -= res;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Create a transport writing to a file descriptor (serial port, pty or pipe)
+ * The fd is referenced, not copied, so it can be reopened without rebinding the transport.
+ */
+void HPOD_servo_transport_fd(struct hpod_servo_transport_s *transport, int *fd)
+{
+    transport->write = fd_write;
+    transport->ctx = fd;
+}
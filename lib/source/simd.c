@@ -0,0 +1,185 @@
+/**
+ * Libhexapod
+ * Hexapod vectorised kinematics
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/simd.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/fastmath.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HPOD_SIMD_X86
+#endif
+
+// 4 wide kernels, baseline SSE2 / NEON
+#define HPOD_VEC_WIDTH      4
+#define HPOD_VEC_SUFFIX     _x4
+#define HPOD_VEC_TARGET
+#include "simd_impl.h"
+#undef HPOD_VEC_WIDTH
+#undef HPOD_VEC_SUFFIX
+#undef HPOD_VEC_TARGET
+
+// 8 wide kernels, AVX2 on x86 otherwise split by the compiler
+#define HPOD_VEC_WIDTH      8
+#define HPOD_VEC_SUFFIX     _x8
+#ifdef HPOD_SIMD_X86
+#define HPOD_VEC_TARGET     __attribute__((target("avx2,fma")))
+#else
+#define HPOD_VEC_TARGET
+#endif
+#include "simd_impl.h"
+#undef HPOD_VEC_WIDTH
+#undef HPOD_VEC_SUFFIX
+#undef HPOD_VEC_TARGET
+
+typedef void (*hpod_ik2_kernel_f)(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                                  float* alpha, float* beta);
+typedef void (*hpod_fk2_kernel_f)(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                                  float* x, float* h);
+
+static void ik2_kernel_scalar(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                              float* alpha, float* beta)
+{
+    for (int i = 0; i < count; i++) {
+        HPOD_leg_ik2(hexapod, d[i], h[i], &alpha[i], &beta[i]);
+    }
+}
+
+static void fk2_kernel_scalar(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                              float* x, float* h)
+{
+    for (int i = 0; i < count; i++) {
+        HPOD_leg_fk2(hexapod, alpha[i], beta[i], &x[i], &h[i]);
+    }
+}
+
+static void ik2_kernel_auto(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                            float* alpha, float* beta);
+static void fk2_kernel_auto(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                            float* x, float* h);
+
+// Active kernels, resolved on first use unless selected
+// Atomic so threads may select or resolve them while others call them. A concurrent caller
+// runs either the old or the new kernel, so relaxed ordering is sufficient.
+static _Atomic hpod_ik2_kernel_f ik2_kernel = ik2_kernel_auto;
+static _Atomic hpod_fk2_kernel_f fk2_kernel = fk2_kernel_auto;
+
+static inline void kernels_store(hpod_ik2_kernel_f ik2, hpod_fk2_kernel_f fk2)
+{
+    atomic_store_explicit(&ik2_kernel, ik2, memory_order_relaxed);
+    atomic_store_explicit(&fk2_kernel, fk2, memory_order_relaxed);
+}
+
+static void ik2_kernel_auto(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                            float* alpha, float* beta)
+{
+    HPOD_simd_select(HPOD_SIMD_AUTO);
+    atomic_load_explicit(&ik2_kernel, memory_order_relaxed)(hexapod, count, d, h, alpha, beta);
+}
+
+static void fk2_kernel_auto(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                            float* x, float* h)
+{
+    HPOD_simd_select(HPOD_SIMD_AUTO);
+    atomic_load_explicit(&fk2_kernel, memory_order_relaxed)(hexapod, count, alpha, beta, x, h);
+}
+
+/**
+ * @brief Check whether a kernel set is supported by the running CPU
+ */
+int HPOD_simd_supported(enum hpod_simd_e mode)
+{
+    switch (mode) {
+    case HPOD_SIMD_AUTO:
+    case HPOD_SIMD_SCALAR:
+    case HPOD_SIMD_X4:
+        return 1;
+    case HPOD_SIMD_X8:
+#ifdef HPOD_SIMD_X86
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        return 1;
+#endif
+    }
+    return 0;
+}
+
+/**
+ * @brief Select the kernel set used by HPOD_leg_ik2_simd and HPOD_leg_fk2_simd
+ * HPOD_SIMD_AUTO picks the widest supported kernel, unsupported selections fall back
+ * to the 4 wide kernels. Safe to call while other threads use the kernels.
+ * Returns the selected kernel set.
+ */
+enum hpod_simd_e HPOD_simd_select(enum hpod_simd_e mode)
+{
+    if (mode == HPOD_SIMD_AUTO) {
+#ifdef HPOD_SIMD_X86
+        mode = HPOD_simd_supported(HPOD_SIMD_X8) ? HPOD_SIMD_X8 : HPOD_SIMD_X4;
+#else
+        mode = HPOD_SIMD_X4;
+#endif
+    } else if (!HPOD_simd_supported(mode)) {
+        mode = HPOD_SIMD_X4;
+    }
+
+    switch (mode) {
+    case HPOD_SIMD_SCALAR:
+        kernels_store(ik2_kernel_scalar, fk2_kernel_scalar);
+        break;
+    case HPOD_SIMD_X8:
+        kernels_store(ik2_kernel_x8, fk2_kernel_x8);
+        break;
+    default:
+        mode = HPOD_SIMD_X4;
+        kernels_store(ik2_kernel_x4, fk2_kernel_x4);
+        break;
+    }
+
+    return mode;
+}
+
+/**
+ * @brief Vectorised 2 Joint Arm Inverse Kinematics
+ * Equivalent to HPOD_leg_ik2 for each of count (d, h) pairs, unreachable
+ * targets produce NaN angles. Kernels use the shared leg geometry, so returns -1 without
+ * solving for hexapods without uniform legs.
+ */
+int HPOD_leg_ik2_simd(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                      float* alpha, float* beta)
+{
+    if (!hexapod->uniform) {
+        return -1;
+    }
+
+    atomic_load_explicit(&ik2_kernel, memory_order_relaxed)(hexapod, count, d, h, alpha, beta);
+
+    return 0;
+}
+
+/**
+ * @brief Vectorised 2 Joint Arm Forward Kinematics
+ * Equivalent to HPOD_leg_fk2 for each of count (alpha, beta) pairs. Returns -1 without
+ * solving for hexapods without uniform legs, as HPOD_leg_ik2_simd.
+ */
+int HPOD_leg_fk2_simd(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                      float* x, float* h)
+{
+    if (!hexapod->uniform) {
+        return -1;
+    }
+
+    atomic_load_explicit(&fk2_kernel, memory_order_relaxed)(hexapod, count, alpha, beta, x, h);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * Libhexapod
+ * Hexapod vector kernel template
+ * Included by simd.c once per vector width, with HPOD_VEC_WIDTH, HPOD_VEC_SUFFIX
+ * and HPOD_VEC_TARGET defined. Uses GCC / clang vector extensions so the same
+ * source maps to SSE, AVX2 or NEON.
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#define VEC_CAT_(a, b)  a##b
+#define VEC_CAT(a, b)   VEC_CAT_(a, b)
+#define VEC_FN(name)    VEC_CAT(name, HPOD_VEC_SUFFIX)
+
+#define vf VEC_FN(vf)
+#define vi VEC_FN(vi)
+
+typedef float vf __attribute__((vector_size(HPOD_VEC_WIDTH * sizeof(float))));
+typedef int32_t vi __attribute__((vector_size(HPOD_VEC_WIDTH * sizeof(int32_t))));
+
+// Lane select, a where mask is set else b
+static inline HPOD_VEC_TARGET vf VEC_FN(vsel)(vi mask, vf a, vf b)
+{
+    return (vf)((mask & (vi)a) | (~mask & (vi)b));
+}
+
+static inline HPOD_VEC_TARGET vf VEC_FN(vabs)(vf a)
+{
+    return (vf)((vi)a & 0x7fffffff);
+}
+
+static inline HPOD_VEC_TARGET vf VEC_FN(vsqrt)(vf x)
+{
+    vf y = (vf)(HPOD_FAST_RSQRT_MAGIC - ((vi)x >> 1));
+
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+
+    return x * y;
+}
+
+static inline HPOD_VEC_TARGET vf VEC_FN(vacos)(vf x)
+{
+    vf a = VEC_FN(vabs)(x);
+
+    vf p = a * HPOD_FAST_ACOS_C7 + HPOD_FAST_ACOS_C6;
+    p = p * a + HPOD_FAST_ACOS_C5;
+    p = p * a + HPOD_FAST_ACOS_C4;
+    p = p * a + HPOD_FAST_ACOS_C3;
+    p = p * a + HPOD_FAST_ACOS_C2;
+    p = p * a + HPOD_FAST_ACOS_C1;
+    p = p * a + HPOD_FAST_ACOS_C0;
+
+    vf r = VEC_FN(vsqrt)(1.0f - a) * p;
+    r = VEC_FN(vsel)(x < 0.0f, HPOD_FAST_PI - r, r);
+
+    // NaN outside of the domain (also catches NaN inputs)
+    return VEC_FN(vsel)(a <= 1.0f, r, r * 0.0f + NAN);
+}
+
+static inline HPOD_VEC_TARGET vf VEC_FN(vatan2)(vf y, vf x)
+{
+    vf ax = VEC_FN(vabs)(x);
+    vf ay = VEC_FN(vabs)(y);
+
+    vi swap = ay > ax;
+    vf mn = VEC_FN(vsel)(swap, ax, ay);
+    vf mx = VEC_FN(vsel)(swap, ay, ax);
+    mx = VEC_FN(vsel)(mx > 1e-30f, mx, mx * 0.0f + 1e-30f);
+
+    vf a = mn / mx;
+    vf s = a * a;
+
+    vf p = s * HPOD_FAST_ATAN_C11 + HPOD_FAST_ATAN_C9;
+    p = p * s + HPOD_FAST_ATAN_C7;
+    p = p * s + HPOD_FAST_ATAN_C5;
+    p = p * s + HPOD_FAST_ATAN_C3;
+    p = p * s + HPOD_FAST_ATAN_C1;
+
+    vf r = p * a;
+    r = VEC_FN(vsel)(swap, HPOD_FAST_PI_2 - r, r);
+    r = VEC_FN(vsel)(x < 0.0f, HPOD_FAST_PI - r, r);
+    return VEC_FN(vsel)(y < 0.0f, -r, r);
+}
+
+static inline HPOD_VEC_TARGET vf VEC_FN(vsin)(vf x)
+{
+    vf k = (x * HPOD_FAST_INV_2PI + HPOD_FAST_ROUND_MAGIC) - HPOD_FAST_ROUND_MAGIC;
+    x = x - k * HPOD_FAST_2PI;
+
+    x = VEC_FN(vsel)(x > HPOD_FAST_PI_2, HPOD_FAST_PI - x, x);
+    x = VEC_FN(vsel)(x < -HPOD_FAST_PI_2, -HPOD_FAST_PI - x, x);
+
+    vf s = x * x;
+
+    vf p = s * HPOD_FAST_SIN_C11 + HPOD_FAST_SIN_C9;
+    p = p * s + HPOD_FAST_SIN_C7;
+    p = p * s + HPOD_FAST_SIN_C5;
+    p = p * s + HPOD_FAST_SIN_C3;
+
+    return x + x * s * p;
+}
+
+static inline HPOD_VEC_TARGET vf VEC_FN(vcos)(vf x)
+{
+    return VEC_FN(vsin)(x + HPOD_FAST_PI_2);
+}
+
+static inline HPOD_VEC_TARGET void VEC_FN(ik2_block)(const struct hexapod_s* hexapod, vf d, vf h,
+                                                       vf* alpha, vf* beta)
+{
+    const struct hpod_kinematics_s *k = &hexapod->kinematics;
+
+    vf len_ac_sq = d * d + h * h;
+    vf len_ac = VEC_FN(vsqrt)(len_ac_sq);
+
+    vf angle_dh = VEC_FN(vatan2)(h, d);
+
+    vf cos_a = (len_ac_sq + (k->len_ab_sq - k->len_bc_sq)) * k->inv_len_ab_2 / len_ac;
+    vf cos_b = ((k->len_ab_sq + k->len_bc_sq) - len_ac_sq) * k->inv_len_ab_bc_2;
+
+    *alpha = VEC_FN(vacos)(cos_a) + angle_dh;
+    *beta = VEC_FN(vacos)(cos_b);
+}
+
+static inline HPOD_VEC_TARGET void VEC_FN(fk2_block)(const struct hexapod_s* hexapod, vf alpha, vf beta,
+                                                       vf* x, vf* h)
+{
+    const float len_ab = hexapod->config.len_ab;
+    const float len_bc = hexapod->config.len_bc;
+
+    vf world_beta = HPOD_FAST_PI - alpha - beta;
+
+    *x = len_ab * VEC_FN(vcos)(alpha) + len_bc * VEC_FN(vcos)(world_beta);
+    *h = len_ab * VEC_FN(vsin)(alpha) - len_bc * VEC_FN(vsin)(world_beta);
+}
+
+HPOD_VEC_TARGET void VEC_FN(ik2_kernel)(struct hexapod_s* hexapod, int count, const float* d, const float* h,
+                                        float* alpha, float* beta)
+{
+    const int width = HPOD_VEC_WIDTH;
+    vf vd, vh, va, vb;
+    int i;
+
+    for (i = 0; i + width <= count; i += width) {
+        memcpy(&vd, &d[i], sizeof(vf));
+        memcpy(&vh, &h[i], sizeof(vf));
+
+        VEC_FN(ik2_block)(hexapod, vd, vh, &va, &vb);
+
+        memcpy(&alpha[i], &va, sizeof(vf));
+        memcpy(&beta[i], &vb, sizeof(vf));
+    }
+
+    // Pad the remainder into a partial vector
+    int rem = count - i;
+    if (rem > 0) {
+        memset(&vd, 0, sizeof(vf));
+        memset(&vh, 0, sizeof(vf));
+        memcpy(&vd, &d[i], rem * sizeof(float));
+        memcpy(&vh, &h[i], rem * sizeof(float));
+
+        VEC_FN(ik2_block)(hexapod, vd, vh, &va, &vb);
+
+        memcpy(&alpha[i], &va, rem * sizeof(float));
+        memcpy(&beta[i], &vb, rem * sizeof(float));
+    }
+}
+
+HPOD_VEC_TARGET void VEC_FN(fk2_kernel)(struct hexapod_s* hexapod, int count, const float* alpha, const float* beta,
+                                        float* x, float* h)
+{
+    const int width = HPOD_VEC_WIDTH;
+    vf va, vb, vx, vh;
+    int i;
+
+    for (i = 0; i + width <= count; i += width) {
+        memcpy(&va, &alpha[i], sizeof(vf));
+        memcpy(&vb, &beta[i], sizeof(vf));
+
+        VEC_FN(fk2_block)(hexapod, va, vb, &vx, &vh);
+
+        memcpy(&x[i], &vx, sizeof(vf));
+        memcpy(&h[i], &vh, sizeof(vf));
+    }
+
+    int rem = count - i;
+    if (rem > 0) {
+        memset(&va, 0, sizeof(vf));
+        memset(&vb, 0, sizeof(vf));
+        memcpy(&va, &alpha[i], rem * sizeof(float));
+        memcpy(&vb, &beta[i], rem * sizeof(float));
+
+        VEC_FN(fk2_block)(hexapod, va, vb, &vx, &vh);
+
+        memcpy(&x[i], &vx, rem * sizeof(float));
+        memcpy(&h[i], &vh, rem * sizeof(float));
+    }
+}
+
+#undef vf
+#undef vi
+#undef VEC_FN
+#undef VEC_CAT
+#undef VEC_CAT_
@@ -0,0 +1,288 @@
+/**
+ * Libhexapod
+ * Hexapod leg workspace map
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "hexapod/workspace.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+
+#define N                   HPOD_WORKSPACE_NODES
+#define WORKSPACE_PAD       2           // Grid nodes outside the reach envelope on each side
+#define MARGIN_STEPS        4           // Margin units per grid cell
+#define MARGIN_SAT          127
+#define DIAG                1.41421356f
+
+/**
+ * @brief Check a leg plane position is solvable within the alpha and beta limits
+ * Leg -1 solves with the shared links
+ */
+static int workspace_feasible(struct hexapod_s* hexapod, int leg, struct hpod_joint_limits_s* limits,
+                              float r, float z)
+{
+    struct hpod_vector3_s pos = {r, 0.0f, z};
+    float a, b, t;
+
+    int res = (leg < 0) ? HPOD_leg_ik3(hexapod, &pos, &a, &b, &t)
+              : HPOD_leg_ik3_n(hexapod, leg, &pos, &a, &b, &t);
+    if (res < 0) {
+        return 0;
+    }
+
+    if (limits != NULL) {
+        return (a >= limits->min[0]) && (a <= limits->max[0]) && (b >= limits->min[1]) && (b <= limits->max[1]);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Two pass 8-neighbour chamfer distance transform (in cells) from seed nodes at zero
+ */
+static void workspace_chamfer(float dist[N][N])
+{
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+            float d = dist[j][i];
+            if (i > 0) d = fminf(d, dist[j][i - 1] + 1.0f);
+            if (j > 0) d = fminf(d, dist[j - 1][i] + 1.0f);
+            if (i > 0 && j > 0) d = fminf(d, dist[j - 1][i - 1] + DIAG);
+            if (i < N - 1 && j > 0) d = fminf(d, dist[j - 1][i + 1] + DIAG);
+            dist[j][i] = d;
+        }
+    }
+
+    for (int j = N - 1; j >= 0; j--) {
+        for (int i = N - 1; i >= 0; i--) {
+            float d = dist[j][i];
+            if (i < N - 1) d = fminf(d, dist[j][i + 1] + 1.0f);
+            if (j < N - 1) d = fminf(d, dist[j + 1][i] + 1.0f);
+            if (i < N - 1 && j < N - 1) d = fminf(d, dist[j + 1][i + 1] + DIAG);
+            if (i > 0 && j < N - 1) d = fminf(d, dist[j + 1][i - 1] + DIAG);
+            dist[j][i] = d;
+        }
+    }
+}
+
+static int8_t workspace_quantise(float cells)
+{
+    float m = roundf(cells * MARGIN_STEPS);
+    return (int8_t) HPOD_LIMIT_RANGE(-MARGIN_SAT, MARGIN_SAT, m);
+}
+
+static void workspace_build(struct hpod_workspace_s* ws, struct hexapod_s* hexapod, int leg,
+                            struct hpod_joint_limits_s* limits)
+{
+    float dist[N][N];
+    uint8_t feasible[N][N];
+
+    const struct hpod_kinematics_s* k = &hexapod->kinematics;
+    float offset_a = hexapod->config.offset_a;
+    if (leg >= 0) {
+        k = &hexapod->leg[leg].kinematics;
+        offset_a = hexapod->leg[leg].offset_a;
+    }
+
+    memset(ws, 0, sizeof(struct hpod_workspace_s));
+    ws->magic = HPOD_WORKSPACE_MAGIC;
+    ws->version = HPOD_WORKSPACE_VERSION;
+
+    // Square cells covering planar radius 0..offset_a + reach_max and height +-reach_max
+    float reach = k->reach_max;
+    float span = fmaxf(offset_a + reach, 2 * reach);
+    ws->cell = span / (N - 1 - 2 * WORKSPACE_PAD);
+    ws->inv_cell = 1.0f / ws->cell;
+    ws->r_min = -WORKSPACE_PAD * ws->cell;
+    ws->z_min = -reach - WORKSPACE_PAD * ws->cell;
+    ws->margin_scale = ws->cell / MARGIN_STEPS;
+
+    if (limits != NULL) {
+        ws->theta_limited = 1;
+        ws->theta_min_sin = sinf(limits->min[2]);
+        ws->theta_min_cos = cosf(limits->min[2]);
+        ws->theta_max_sin = sinf(limits->max[2]);
+        ws->theta_max_cos = cosf(limits->max[2]);
+    }
+
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+            feasible[j][i] = workspace_feasible(hexapod, leg, limits, ws->r_min + i * ws->cell, ws->z_min + j * ws->cell);
+        }
+    }
+
+    // Distance from feasible nodes to the nearest infeasible node
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+            dist[j][i] = feasible[j][i] ? INFINITY : 0.0f;
+        }
+    }
+    workspace_chamfer(dist);
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+            if (feasible[j][i]) {
+                ws->margin[j][i] = workspace_quantise(dist[j][i] - 0.5f);
+            }
+        }
+    }
+
+    // Distance from infeasible nodes to the nearest feasible node
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+            dist[j][i] = feasible[j][i] ? 0.0f : INFINITY;
+        }
+    }
+    workspace_chamfer(dist);
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) {
+            if (!feasible[j][i]) {
+                ws->margin[j][i] = workspace_quantise(-(dist[j][i] - 0.5f));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Build a workspace map for a hexapod leg
+ * Feasibility is sampled with HPOD_leg_ik3 at each grid node (and the alpha / beta limits
+ * if limits is not NULL), then converted to a signed distance with a chamfer transform, so
+ * margins are accurate to around one grid cell plus 8% of the distance to the boundary.
+ * Theta limits are kept analytically.
+ * Uses around 64kB of stack, so maps for small targets should be built offline and loaded
+ * with HPOD_workspace_deserialise.
+ * Returns 0 on success, or -1 without building the map if the legs do not share links
+ * (see HPOD_workspace_build_n).
+ */
+int HPOD_workspace_build(struct hpod_workspace_s* ws, struct hexapod_s* hexapod,
+                         struct hpod_joint_limits_s* limits)
+{
+    if (!hexapod->uniform) {
+        return -1;
+    }
+
+    workspace_build(ws, hexapod, -1, limits);
+
+    return 0;
+}
+
+/**
+ * @brief Build a workspace map for a specific leg
+ * As HPOD_workspace_build, sampling HPOD_leg_ik3_n with the links of the provided leg
+ */
+int HPOD_workspace_build_n(struct hpod_workspace_s* ws, struct hexapod_s* hexapod, int leg,
+                           struct hpod_joint_limits_s* limits)
+{
+    workspace_build(ws, hexapod, leg, limits);
+
+    return 0;
+}
+
+/**
+ * @brief Fetch the signed distance (mm) from a foot position to the workspace boundary
+ * Positive values are inside the workspace. The leg plane margin is bilinearly interpolated
+ * from the four surrounding grid nodes.
+ */
+float HPOD_workspace_margin(struct hpod_workspace_s* ws, struct hpod_vector3_s* pos)
+{
+    float r = HPOD_SQRT(pos->x * pos->x + pos->y * pos->y);
+
+    float u = (r - ws->r_min) * ws->inv_cell;
+    float v = (pos->z - ws->z_min) * ws->inv_cell;
+
+    if (isnan(u) || isnan(v)) {
+        return -MARGIN_SAT * ws->margin_scale;
+    }
+
+    // Positions outside of the grid use the edge margin less the distance to the edge
+    float cu = HPOD_LIMIT_RANGE(0.0f, N - 1.001f, u);
+    float cv = HPOD_LIMIT_RANGE(0.0f, N - 1.001f, v);
+    float outside = HPOD_SQRT((u - cu) * (u - cu) + (v - cv) * (v - cv)) * ws->cell;
+
+    int i = (int) cu, j = (int) cv;
+    float fu = cu - i, fv = cv - j;
+
+    float m0 = ws->margin[j][i] + (ws->margin[j][i + 1] - ws->margin[j][i]) * fu;
+    float m1 = ws->margin[j + 1][i] + (ws->margin[j + 1][i + 1] - ws->margin[j + 1][i]) * fu;
+    float margin = (m0 + (m1 - m0) * fv) * ws->margin_scale - outside;
+
+    // Distance to the theta limit planes
+    if (ws->theta_limited) {
+        float upper = pos->x * ws->theta_max_sin - pos->y * ws->theta_max_cos;
+        float lower = pos->y * ws->theta_min_cos - pos->x * ws->theta_min_sin;
+        margin = fminf(margin, fminf(upper, lower));
+    }
+
+    return margin;
+}
+
+/**
+ * @brief Check whether a foot position is inside the workspace
+ */
+int HPOD_workspace_reachable(struct hpod_workspace_s* ws, struct hpod_vector3_s* pos)
+{
+    return HPOD_workspace_margin(ws, pos) >= 0.0f;
+}
+
+static uint32_t workspace_checksum(const uint8_t* data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Serialise a workspace map to a buffer
+ * The format is the in memory layout of hpod_workspace_s, so maps are only portable
+ * between targets with the same endianness and float format.
+ * Returns the number of bytes written, or -1 if the buffer is too small.
+ */
+int HPOD_workspace_serialise(struct hpod_workspace_s* ws, uint8_t* buffer, int length)
+{
+    if (length < (int) sizeof(struct hpod_workspace_s)) {
+        return -1;
+    }
+
+    ws->checksum = workspace_checksum((const uint8_t*) ws, offsetof(struct hpod_workspace_s, checksum));
+    memcpy(buffer, ws, sizeof(struct hpod_workspace_s));
+
+    return sizeof(struct hpod_workspace_s);
+}
+
+/**
+ * @brief Load a workspace map from a buffer
+ * Returns 0 on success, or -1 if the buffer is too short or the magic, version or
+ * checksum do not match.
+ */
+int HPOD_workspace_deserialise(struct hpod_workspace_s* ws, const uint8_t* buffer, int length)
+{
+    struct hpod_workspace_s tmp;
+
+    if (length < (int) sizeof(struct hpod_workspace_s)) {
+        return -1;
+    }
+
+    memcpy(&tmp, buffer, sizeof(struct hpod_workspace_s));
+
+    if (tmp.magic != HPOD_WORKSPACE_MAGIC || tmp.version != HPOD_WORKSPACE_VERSION) {
+        return -1;
+    }
+
+    if (tmp.checksum != workspace_checksum(buffer, offsetof(struct hpod_workspace_s, checksum))) {
+        return -1;
+    }
+
+    memcpy(ws, &tmp, sizeof(struct hpod_workspace_s));
+
+    return 0;
+}
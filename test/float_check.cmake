@@ -0,0 +1,41 @@
+# Libhexapod float-only check
+# https://github.com/ryankurte/libhexapod
+# Copyright 2017 Ryan Kurte
+#
+# Fails if any double precision operations are found in the provided objects
+# Usage: cmake -DNM=nm -DOBJDUMP=objdump -DOBJECTS="a.o:b.o" -P float_check.cmake
+
+# Double precision libm functions (the float variants have an f suffix)
+set(DOUBLE_SYMBOLS sqrt pow fmod fabs atan atan2 acos asin sin cos tan exp log floor ceil round)
+
+# Double precision x86 SSE / AVX instructions (movsd excluded as it is also a plain 64-bit move)
+set(DOUBLE_INSTRUCTIONS "[ \t]v?(add|sub|mul|div|sqrt|min|max)sd[ \t]|[ \t]v?cvt(ss2sd|sd2ss|si2sd|tsd2si)[ \t]")
+
+set(FAILED 0)
+string(REPLACE ":" ";" OBJECTS "${OBJECTS}")
+
+foreach(OBJECT ${OBJECTS})
+    get_filename_component(NAME ${OBJECT} NAME)
+
+    execute_process(COMMAND ${NM} -u ${OBJECT} OUTPUT_VARIABLE UNDEFINED)
+    foreach(SYMBOL ${DOUBLE_SYMBOLS})
+        if(UNDEFINED MATCHES "[ \t]${SYMBOL}(@[^\n]*)?\n")
+            message(SEND_ERROR "${NAME}: calls double precision ${SYMBOL}()")
+            set(FAILED 1)
+        endif()
+    endforeach()
+
+    if(OBJDUMP)
+        execute_process(COMMAND ${OBJDUMP} -d ${OBJECT} OUTPUT_VARIABLE DISASSEMBLY)
+        string(REGEX MATCHALL "${DOUBLE_INSTRUCTIONS}" MATCHES "${DISASSEMBLY}")
+        if(MATCHES)
+            list(REMOVE_DUPLICATES MATCHES)
+            message(SEND_ERROR "${NAME}: contains double precision instructions ${MATCHES}")
+            set(FAILED 1)
+        endif()
+    endif()
+endforeach()
+
+if(FAILED)
+    message(FATAL_ERROR "Double precision operations found in float-only build")
+endif()
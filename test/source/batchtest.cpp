@@ -0,0 +1,179 @@
+/**
+ * Libhexapod
+ * Hexapod Batch Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/batch.h"
+
+#define BATCH_SIZE      64
+#define FLOAT_ERROR     0.01
+
+class BatchTest : public ::testing::Test
+{
+protected:
+    BatchTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+    }
+
+    virtual ~BatchTest()
+    {
+
+    }
+    struct hexapod_s hexy;
+};
+
+TEST_F(BatchTest, MatchesScalarIK3)
+{
+    float x[BATCH_SIZE], y[BATCH_SIZE], z[BATCH_SIZE];
+    float alpha[BATCH_SIZE], beta[BATCH_SIZE], theta[BATCH_SIZE];
+    uint8_t valid[BATCH_SIZE];
+
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        x[i] = hexy.config.offset_a + hexy.config.len_bc + hexy.config.len_ab / 2 * sinf(i * 0.1f);
+        y[i] = -hexy.config.length / 4 + hexy.config.length / 2 / BATCH_SIZE * i;
+        z[i] = -hexy.config.len_bc / 4 + hexy.config.len_bc / 2 / BATCH_SIZE * i;
+    }
+
+    int solved = HPOD_leg_ik3_batch(&hexy, BATCH_SIZE, x, y, z, alpha, beta, theta, valid);
+    ASSERT_EQ(BATCH_SIZE, solved);
+
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        struct hpod_vector3_s pos = {x[i], y[i], z[i]};
+        float a, b, t;
+
+        int res = HPOD_leg_ik3(&hexy, &pos, &a, &b, &t);
+        ASSERT_EQ(0, res);
+        ASSERT_EQ(1, valid[i]);
+
+        ASSERT_NEAR(a, alpha[i], FLOAT_ERROR);
+        ASSERT_NEAR(b, beta[i], FLOAT_ERROR);
+        ASSERT_NEAR(t, theta[i], FLOAT_ERROR);
+    }
+}
+
+TEST_F(BatchTest, FlagsUnreachable)
+{
+    // Out of reach, inside minimum reach, and a reachable control point
+    float reach = hexy.config.offset_a + hexy.config.len_ab + hexy.config.len_bc;
+    float x[3] = {reach + 10, hexy.config.offset_a, hexy.config.offset_a + hexy.config.len_bc};
+    float y[3] = {0, 0, 0};
+    float z[3] = {0, 0, -20};
+    float alpha[3], beta[3], theta[3];
+    uint8_t valid[3];
+
+    int solved = HPOD_leg_ik3_batch(&hexy, 3, x, y, z, alpha, beta, theta, valid);
+    ASSERT_EQ(1, solved);
+
+    ASSERT_EQ(0, valid[0]);
+    ASSERT_TRUE(isnan(alpha[0]));
+    ASSERT_EQ(0, valid[1]);
+    ASSERT_TRUE(isnan(beta[1]));
+    ASSERT_EQ(1, valid[2]);
+    ASSERT_FALSE(isnan(alpha[2]));
+}
+
+TEST_F(BatchTest, PerLegLinks)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    float x[BATCH_SIZE], y[BATCH_SIZE], z[BATCH_SIZE];
+    float alpha[BATCH_SIZE], beta[BATCH_SIZE], theta[BATCH_SIZE];
+    uint8_t valid[BATCH_SIZE];
+
+    // Four legs, one with a longer foreleg
+    config.legs = 4;
+    for (int i = 0; i < 4; i++) {
+        config.leg[i].x = (i % 2) ? 50.0f : -50.0f;
+        config.leg[i].y = (i / 2) ? -100.0f : 100.0f;
+    }
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        x[i] = hexy.config.offset_a + 60 + 3.0f * i;
+        y[i] = 0;
+        z[i] = -40;
+    }
+
+    // Mount yaw alone leaves the joint frame solve unchanged
+    for (int i = 0; i < 4; i++) {
+        config.leg[i].yaw = (i / 2) ? -0.4f : 0.4f;
+    }
+    HPOD_init(&hexy, &config);
+    ASSERT_LT(0, HPOD_leg_ik3_batch(&hexy, BATCH_SIZE, x, y, z, alpha, beta, theta, valid));
+
+    config.leg[3].len_bc = 190;
+    HPOD_init(&hexy, &config);
+
+    // The shared geometry does not describe every leg
+    ASSERT_EQ(-1, HPOD_leg_ik3_batch(&hexy, BATCH_SIZE, x, y, z, alpha, beta, theta, valid));
+
+    for (int leg = 0; leg < 4; leg++) {
+        int solved = HPOD_leg_ik3_batch_n(&hexy, leg, BATCH_SIZE, x, y, z, alpha, beta, theta, valid);
+        int expected = 0;
+
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            struct hpod_vector3_s pos = {x[i], y[i], z[i]};
+            float a, b, t;
+
+            int res = HPOD_leg_ik3_n(&hexy, leg, &pos, &a, &b, &t);
+            ASSERT_EQ(res == 0, valid[i]);
+            expected += (res == 0);
+
+            if (valid[i]) {
+                ASSERT_NEAR(a, alpha[i], FLOAT_ERROR);
+                ASSERT_NEAR(b, beta[i], FLOAT_ERROR);
+            }
+        }
+        ASSERT_EQ(expected, solved);
+    }
+
+    // The longer foreleg reaches further
+    HPOD_leg_ik3_batch_n(&hexy, 0, BATCH_SIZE, x, y, z, alpha, beta, theta, valid);
+    int short_solved = valid[BATCH_SIZE - 1];
+    HPOD_leg_ik3_batch_n(&hexy, 3, BATCH_SIZE, x, y, z, alpha, beta, theta, valid);
+    ASSERT_EQ(0, short_solved);
+    ASSERT_EQ(1, valid[BATCH_SIZE - 1]);
+}
+
+TEST_F(BatchTest, AgreesWithScalarAtBoundary)
+{
+    // Targets within a few ulps of the inner and outer reach limits, where rounding can
+    // push the cosine rule outside [-1, 1]
+    float x[BATCH_SIZE], y[BATCH_SIZE], z[BATCH_SIZE];
+    float alpha[BATCH_SIZE], beta[BATCH_SIZE], theta[BATCH_SIZE];
+    uint8_t valid[BATCH_SIZE];
+
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        float reach = (i % 2) ? hexy.kinematics.reach_max : hexy.kinematics.reach_min;
+        float len_ac = reach * (1.0f + (i / 2 % 8 - 4) * 1e-7f);
+        float angle = 0.1f * i - 3.0f;
+
+        x[i] = (hexy.config.offset_a + len_ac * cosf(angle)) * cosf(0.05f * i);
+        y[i] = (hexy.config.offset_a + len_ac * cosf(angle)) * sinf(0.05f * i);
+        z[i] = len_ac * sinf(angle);
+    }
+
+    HPOD_leg_ik3_batch(&hexy, BATCH_SIZE, x, y, z, alpha, beta, theta, valid);
+
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        struct hpod_vector3_s pos = {x[i], y[i], z[i]};
+        float a, b, t;
+
+        int res = HPOD_leg_ik3(&hexy, &pos, &a, &b, &t);
+        ASSERT_EQ(res == 0, valid[i]) << "target " << i;
+
+        if (valid[i]) {
+            ASSERT_FALSE(isnan(alpha[i]) || isnan(beta[i]) || isnan(theta[i]));
+            ASSERT_NEAR(a, alpha[i], FLOAT_ERROR);
+            ASSERT_NEAR(b, beta[i], FLOAT_ERROR);
+        }
+    }
+}
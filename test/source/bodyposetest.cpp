@@ -0,0 +1,190 @@
+/**
+ * Libhexapod
+ * Hexapod Body Pose Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/body_pose.h"
+
+#define FLOAT_ERROR     0.001
+#define POSE_SLICES     32
+
+class BodyPoseTest : public ::testing::Test
+{
+protected:
+    BodyPoseTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+
+        // Feet spread around the neutral stance
+        for (int i = 0; i < 6; i++) {
+            feet[i] = {120.0f + 5 * i, -30.0f + 10 * i, -90.0f + 3 * i};
+        }
+    }
+
+    virtual ~BodyPoseTest()
+    {
+    }
+
+    float distance(struct hpod_vector3_s a, struct hpod_vector3_s b)
+    {
+        return sqrtf((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_vector3_s feet[6];
+    struct hpod_vector3_s joints[6];
+    struct hpod_body_transform_s transform;
+};
+
+TEST_F(BodyPoseTest, NeutralIsIdentity)
+{
+    struct hpod_body_pose_s pose = HPOD_DEFAULT_BODY_POSE;
+    struct hpod_vector3_s hips[6];
+
+    HPOD_body_pose_init(&transform, &pose);
+    HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+    HPOD_body_pose_hips(&hexy, &transform, hips);
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_NEAR(feet[i].x, joints[i].x, FLOAT_ERROR);
+        ASSERT_NEAR(feet[i].y, joints[i].y, FLOAT_ERROR);
+        ASSERT_NEAR(feet[i].z, joints[i].z, FLOAT_ERROR);
+
+        ASSERT_NEAR(hexy.leg[i].mount.side * hexy.leg[i].mount.x, hips[i].x, FLOAT_ERROR);
+        ASSERT_NEAR(hexy.leg[i].mount.y, hips[i].y, FLOAT_ERROR);
+        ASSERT_NEAR(0.0, hips[i].z, FLOAT_ERROR);
+    }
+}
+
+TEST_F(BodyPoseTest, TranslationAndYaw)
+{
+    // Raising the body lowers the feet in every leg frame, sideways moves are mirrored
+    struct hpod_body_pose_s pose = {{10.0, 20.0, 30.0}, 0.0, 0.0, 0.0};
+    HPOD_body_pose_init(&transform, &pose);
+    HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_NEAR(feet[i].x - hexy.leg[i].mount.side * 10.0, joints[i].x, FLOAT_ERROR);
+        ASSERT_NEAR(feet[i].y - 20.0, joints[i].y, FLOAT_ERROR);
+        ASSERT_NEAR(feet[i].z - 30.0, joints[i].z, FLOAT_ERROR);
+    }
+
+    // Turning a quarter anticlockwise, the front right hip ends up at (-100, 50)
+    struct hpod_vector3_s under_hips[6] = {};
+    struct hpod_vector3_s hips[6];
+    pose = HPOD_DEFAULT_BODY_POSE;
+    pose.yaw = M_PI / 2;
+    HPOD_body_pose_init(&transform, &pose);
+    HPOD_body_pose_apply(&hexy, &transform, under_hips, joints);
+    HPOD_body_pose_hips(&hexy, &transform, hips);
+
+    ASSERT_NEAR(-100.0, hips[1].x, FLOAT_ERROR);
+    ASSERT_NEAR(50.0, hips[1].y, FLOAT_ERROR);
+    ASSERT_NEAR(50.0, joints[1].x, FLOAT_ERROR);
+    ASSERT_NEAR(-150.0, joints[1].y, FLOAT_ERROR);
+    ASSERT_NEAR(0.0, joints[1].z, FLOAT_ERROR);
+}
+
+TEST_F(BodyPoseTest, MatchesBodyTransformRotation)
+{
+    struct hpod_vector3_s zero[6] = {};
+    struct hpod_vector3_s origin[6];
+
+    for (int s = 0; s < POSE_SLICES; s++) {
+        struct hpod_body_pose_s pose = HPOD_DEFAULT_BODY_POSE;
+        pose.roll = (M_PI / 4) * s / POSE_SLICES - M_PI / 8;
+        pose.pitch = M_PI / 8 - (M_PI / 6) * s / POSE_SLICES;
+
+        HPOD_body_pose_init(&transform, &pose);
+        HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+        HPOD_body_pose_apply(&hexy, &transform, zero, origin);
+
+        // With zero offsets HPOD_body_transform rotates about the hip, roll mirrored per side
+        for (int i = 0; i < 6; i++) {
+            struct hpod_vector3_s expected;
+            HPOD_body_transform(&hexy, hexy.leg[i].mount.side * pose.roll, pose.pitch, 0, 0, &feet[i], &expected);
+
+            ASSERT_NEAR(expected.x, joints[i].x - origin[i].x, FLOAT_ERROR);
+            ASSERT_NEAR(expected.y, joints[i].y - origin[i].y, FLOAT_ERROR);
+            ASSERT_NEAR(expected.z, joints[i].z - origin[i].z, FLOAT_ERROR);
+        }
+    }
+}
+
+TEST_F(BodyPoseTest, MatchesBodyTransformOffsets)
+{
+    for (int s = 1; s <= POSE_SLICES; s++) {
+        float angle = (M_PI / 8) * s / POSE_SLICES;
+
+        // HPOD_body_transform raises the hip by offset * sin(angle) but does not move it
+        // horizontally, so differs from the rigid transform by offset * (1 - cos(angle))
+        for (int i = 0; i < 6; i++) {
+            struct hpod_body_pose_s pose = HPOD_DEFAULT_BODY_POSE;
+            struct hpod_vector3_s expected;
+            float offset_x = hexy.config.width / 2;
+            float offset_y = hexy.leg[i].mount.y;
+
+            pose.pitch = angle;
+            HPOD_body_pose_init(&transform, &pose);
+            HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+            HPOD_body_transform(&hexy, 0.0, angle, 0, offset_y, &feet[i], &expected);
+            ASSERT_NEAR(fabs(offset_y) * (1 - cos(angle)), distance(expected, joints[i]), FLOAT_ERROR);
+
+            pose.pitch = 0.0;
+            pose.roll = angle;
+            HPOD_body_pose_init(&transform, &pose);
+            HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+            HPOD_body_transform(&hexy, hexy.leg[i].mount.side * angle, 0.0, offset_x, 0, &feet[i], &expected);
+            ASSERT_NEAR(offset_x * (1 - cos(angle)), distance(expected, joints[i]), FLOAT_ERROR);
+        }
+    }
+}
+
+TEST_F(BodyPoseTest, RigidTransform)
+{
+    struct hpod_body_pose_s pose = {{-15.0, 25.0, 40.0}, 0.2, -0.15, 0.3};
+    struct hpod_vector3_s hips[6];
+
+    HPOD_body_pose_init(&transform, &pose);
+    HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+    HPOD_body_pose_hips(&hexy, &transform, hips);
+
+    // Rotation is orthonormal
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            float dot = 0;
+            for (int k = 0; k < 3; k++) {
+                dot += transform.rotation[k][a] * transform.rotation[k][b];
+            }
+            ASSERT_NEAR(a == b ? 1.0 : 0.0, dot, FLOAT_ERROR);
+        }
+    }
+
+    // Hip to foot distances are preserved
+    for (int i = 0; i < 6; i++) {
+        struct hpod_leg_mount_s* mount = &hexy.leg[i].mount;
+        struct hpod_vector3_s stance = {mount->side * (mount->x + feet[i].x), mount->y + feet[i].y, feet[i].z};
+        struct hpod_vector3_s origin = {0, 0, 0};
+
+        ASSERT_NEAR(distance(stance, hips[i]), distance(joints[i], origin), FLOAT_ERROR);
+
+        // And the joint frame target reaches the same foot through IK and FK
+        float alpha, beta, theta;
+        struct hpod_vector3_s pos;
+        ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &joints[i], &alpha, &beta, &theta));
+        HPOD_leg_fk3(&hexy, alpha, beta, theta, &pos);
+        ASSERT_NEAR(joints[i].x, pos.x, 0.1);
+        ASSERT_NEAR(joints[i].y, pos.y, 0.1);
+        ASSERT_NEAR(joints[i].z, pos.z, 0.1);
+    }
+}
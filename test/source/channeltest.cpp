@@ -0,0 +1,206 @@
+/**
+ * Libhexapod
+ * Hexapod Channel Unit Tests
+ * The stress tests are intended to be run under ThreadSanitizer (cmake -DHPOD_TSAN=ON)
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <thread>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/channel.h"
+
+#define STRESS_ITERATIONS   100000
+
+// Fill every command field from a sequence number so torn reads can be detected
+static void command_fill(struct hpod_command_s *command, int n)
+{
+    command->movement = {(float) n, (float) n, (float) n};
+    command->pose = {{(float) n, (float) n, (float) n}, (float) n, (float) n, (float) n};
+    command->gait.movement = {(float) n, (float) n, (float) n};
+    command->gait.offset = {(float) n, (float) n, (float) n};
+    command->gait.height_scale = n;
+    command->cycle_rate = n;
+}
+
+static int command_check(struct hpod_command_s *command)
+{
+    float n = command->cycle_rate;
+    return command->movement.x == n && command->movement.y == n && command->movement.z == n &&
+           command->pose.roll == n && command->pose.pitch == n && command->pose.yaw == n &&
+           command->pose.position.z == n &&
+           command->gait.movement.x == n && command->gait.movement.z == n &&
+           command->gait.offset.x == n && command->gait.offset.z == n &&
+           command->gait.height_scale == n;
+}
+
+static void sample_fill(struct hpod_telemetry_s *sample, int n)
+{
+    sample->tick = n;
+    sample->time_ns = n;
+    sample->phase = n;
+    for (int i = 0; i < HPOD_MAX_LEGS; i++) {
+        for (int j = 0; j < 3; j++) {
+            sample->angles[i][j] = n;
+            sample->out[i][j] = n;
+        }
+        sample->valid[i] = n & 0xFF;
+    }
+}
+
+static int sample_check(struct hpod_telemetry_s *sample, int n)
+{
+    int ok = sample->tick == (uint64_t) n && sample->time_ns == (uint64_t) n && sample->phase == n;
+    for (int i = 0; i < HPOD_MAX_LEGS; i++) {
+        for (int j = 0; j < 3; j++) {
+            ok &= sample->angles[i][j] == n && sample->out[i][j] == n;
+        }
+        ok &= sample->valid[i] == (n & 0xFF);
+    }
+    return ok;
+}
+
+class ChannelTest : public ::testing::Test
+{
+protected:
+    ChannelTest()
+    {
+        command_fill(&initial, 0);
+        HPOD_mailbox_init(&mailbox, &initial);
+        HPOD_telemetry_init(&ring);
+    }
+
+    virtual ~ChannelTest()
+    {
+    }
+
+    struct hpod_command_s initial;
+    struct hpod_mailbox_s mailbox;
+    struct hpod_telemetry_ring_s ring;
+};
+
+TEST_F(ChannelTest, MailboxLatestWins)
+{
+    struct hpod_command_s command;
+    int updated;
+
+    struct hpod_command_s *latest = HPOD_mailbox_fetch(&mailbox, &updated);
+    ASSERT_EQ(0, updated);
+    ASSERT_EQ(0.0f, latest->cycle_rate);
+
+    for (int i = 1; i <= 5; i++) {
+        command_fill(&command, i);
+        HPOD_mailbox_publish(&mailbox, &command);
+    }
+
+    latest = HPOD_mailbox_fetch(&mailbox, &updated);
+    ASSERT_EQ(1, updated);
+    ASSERT_EQ(5.0f, latest->cycle_rate);
+    ASSERT_TRUE(command_check(latest));
+
+    // The fetched command is stable until the next fetch
+    command_fill(&command, 6);
+    HPOD_mailbox_publish(&mailbox, &command);
+    ASSERT_EQ(5.0f, latest->cycle_rate);
+
+    latest = HPOD_mailbox_fetch(&mailbox, &updated);
+    ASSERT_EQ(1, updated);
+    ASSERT_EQ(6.0f, latest->cycle_rate);
+
+    latest = HPOD_mailbox_fetch(&mailbox, &updated);
+    ASSERT_EQ(0, updated);
+    ASSERT_EQ(6.0f, latest->cycle_rate);
+}
+
+TEST_F(ChannelTest, TelemetryOrderAndOverflow)
+{
+    struct hpod_telemetry_s sample;
+
+    ASSERT_EQ(-1, HPOD_telemetry_pop(&ring, &sample));
+
+    for (int i = 0; i < HPOD_TELEMETRY_SLOTS; i++) {
+        struct hpod_telemetry_s *slot = HPOD_telemetry_claim(&ring);
+        ASSERT_TRUE(slot != NULL);
+        sample_fill(slot, i);
+        HPOD_telemetry_commit(&ring);
+    }
+
+    ASSERT_TRUE(HPOD_telemetry_claim(&ring) == NULL);
+    ASSERT_EQ(1u, HPOD_telemetry_dropped(&ring));
+
+    // Space is released as samples are consumed
+    ASSERT_EQ(0, HPOD_telemetry_pop(&ring, &sample));
+    ASSERT_TRUE(sample_check(&sample, 0));
+    ASSERT_TRUE(HPOD_telemetry_claim(&ring) != NULL);
+
+    for (int i = 1; i < HPOD_TELEMETRY_SLOTS; i++) {
+        ASSERT_EQ(0, HPOD_telemetry_pop(&ring, &sample));
+        ASSERT_TRUE(sample_check(&sample, i));
+    }
+    ASSERT_EQ(-1, HPOD_telemetry_pop(&ring, &sample));
+}
+
+TEST_F(ChannelTest, MailboxStress)
+{
+    std::thread producer([this]() {
+        struct hpod_command_s command;
+        for (int i = 1; i <= STRESS_ITERATIONS; i++) {
+            command_fill(&command, i);
+            HPOD_mailbox_publish(&mailbox, &command);
+        }
+    });
+
+    // Commands must never be torn or go backwards
+    float last = 0;
+    int torn = 0, reversed = 0;
+    while (last < STRESS_ITERATIONS) {
+        struct hpod_command_s *command = HPOD_mailbox_fetch(&mailbox, NULL);
+        torn += !command_check(command);
+        reversed += command->cycle_rate < last;
+        last = command->cycle_rate;
+        std::this_thread::yield();
+    }
+
+    producer.join();
+
+    ASSERT_EQ(0, torn);
+    ASSERT_EQ(0, reversed);
+}
+
+TEST_F(ChannelTest, TelemetryStress)
+{
+    std::thread producer([this]() {
+        for (int i = 0; i < STRESS_ITERATIONS; i++) {
+            struct hpod_telemetry_s *slot;
+            while ((slot = HPOD_telemetry_claim(&ring)) == NULL) {
+                std::this_thread::yield();
+            }
+            sample_fill(slot, i);
+            HPOD_telemetry_commit(&ring);
+        }
+    });
+
+    // Every sample arrives intact and in order
+    int received = 0, corrupt = 0;
+    while (received < STRESS_ITERATIONS) {
+        struct hpod_telemetry_s sample;
+        if (HPOD_telemetry_pop(&ring, &sample) != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        corrupt += !sample_check(&sample, received);
+        received++;
+    }
+
+    producer.join();
+
+    ASSERT_EQ(0, corrupt);
+}
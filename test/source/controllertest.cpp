@@ -0,0 +1,204 @@
+/**
+ * Libhexapod
+ * Hexapod Controller Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/servo.h"
+#include "hexapod/pipeline.h"
+#include "hexapod/controller.h"
+
+#define FLOAT_ERROR     0.0001
+#define NS_PER_MS       1000000ULL
+
+struct output_capture_s {
+    int calls;
+    int out[6][3];
+};
+
+static void capture_output(void *ctx, struct hpod_pipeline_scratch_s *scratch, int out[][3])
+{
+    struct output_capture_s *capture = (struct output_capture_s *) ctx;
+    capture->calls++;
+    memcpy(capture->out, out, sizeof(capture->out));
+}
+
+class ControllerTest : public ::testing::Test
+{
+protected:
+    ControllerTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+        HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+
+        ctrl_config.period_ns = NS_PER_MS;
+        ctrl_config.priority = 0;
+        ctrl_config.cpu = -1;
+        ctrl_config.output = capture_output;
+        ctrl_config.output_ctx = &capture;
+        HPOD_controller_init(&ctrl, &hexy, &gait, &servo, &ctrl_config);
+
+        command.movement = {0.0, 1.0, 0.0};
+        command.pose = HPOD_DEFAULT_BODY_POSE;
+        command.gait = gait;
+        command.cycle_rate = 1.0f;
+    }
+
+    virtual ~ControllerTest()
+    {
+        HPOD_controller_stop(&ctrl);
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_servo_s servo;
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_controller_config_s ctrl_config;
+    struct hpod_controller_s ctrl;
+    struct hpod_command_s command;
+    struct output_capture_s capture = {};
+};
+
+TEST_F(ControllerTest, PhaseFollowsTime)
+{
+    struct hpod_controller_stats_s stats;
+    HPOD_controller_command(&ctrl, &command);
+
+    // One gait cycle per second advances phase by 2 per second
+    ASSERT_EQ(0, HPOD_controller_step(&ctrl, 1000 * NS_PER_MS));
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_NEAR(0.0, stats.phase, FLOAT_ERROR);
+
+    ASSERT_EQ(0, HPOD_controller_step(&ctrl, 1250 * NS_PER_MS));
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_NEAR(0.5, stats.phase, FLOAT_ERROR);
+
+    // Wraps into -1 to 1
+    ASSERT_EQ(0, HPOD_controller_step(&ctrl, 1750 * NS_PER_MS));
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_NEAR(-0.5, stats.phase, FLOAT_ERROR);
+
+    // Rate changes apply from the next tick
+    command.cycle_rate = 0.5f;
+    HPOD_controller_command(&ctrl, &command);
+    ASSERT_EQ(0, HPOD_controller_step(&ctrl, 2250 * NS_PER_MS));
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_NEAR(0.0, stats.phase, FLOAT_ERROR);
+
+    ASSERT_EQ(4u, stats.ticks);
+    ASSERT_EQ(4, capture.calls);
+    ASSERT_EQ(2u, stats.commands);
+}
+
+TEST_F(ControllerTest, OutputMatchesPipeline)
+{
+    struct hpod_pipeline_scratch_s scratch;
+    struct hpod_body_transform_s transform;
+    int expected[6][3];
+
+    command.pose.pitch = 0.1f;
+    HPOD_controller_command(&ctrl, &command);
+
+    HPOD_controller_step(&ctrl, 1000 * NS_PER_MS);
+    HPOD_controller_step(&ctrl, 1100 * NS_PER_MS);
+
+    HPOD_body_pose_init(&transform, &command.pose);
+    HPOD_pipeline(&hexy, &gait, &servo, &transform, &command.movement, 0.2f, &scratch, expected);
+
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 3; j++) {
+            ASSERT_NEAR(expected[i][j], capture.out[i][j], 1);
+        }
+    }
+}
+
+TEST_F(ControllerTest, Telemetry)
+{
+    struct hpod_telemetry_s sample;
+    struct hpod_controller_stats_s stats;
+
+    HPOD_controller_command(&ctrl, &command);
+    ASSERT_EQ(-1, HPOD_controller_telemetry(&ctrl, &sample));
+
+    for (int i = 0; i < HPOD_TELEMETRY_SLOTS + 10; i++) {
+        HPOD_controller_step(&ctrl, (1000 + i) * NS_PER_MS);
+    }
+
+    // Samples arrive in order, overflow is dropped rather than overwriting
+    for (int i = 0; i < HPOD_TELEMETRY_SLOTS; i++) {
+        ASSERT_EQ(0, HPOD_controller_telemetry(&ctrl, &sample));
+        ASSERT_EQ((uint64_t) i, sample.tick);
+        ASSERT_EQ((1000 + i) * NS_PER_MS, sample.time_ns);
+    }
+    ASSERT_EQ(-1, HPOD_controller_telemetry(&ctrl, &sample));
+
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_EQ(10u, stats.telemetry_dropped);
+
+    HPOD_controller_step(&ctrl, 2000 * NS_PER_MS);
+    ASSERT_EQ(0, HPOD_controller_telemetry(&ctrl, &sample));
+    ASSERT_EQ(capture.out[0][0], sample.out[0][0]);
+    ASSERT_EQ(1, sample.valid[5]);
+}
+
+TEST_F(ControllerTest, CountsFailures)
+{
+    struct hpod_controller_stats_s stats;
+
+    command.pose.position.z = 1000.0f;
+    HPOD_controller_command(&ctrl, &command);
+
+    ASSERT_EQ(6, HPOD_controller_step(&ctrl, 1000 * NS_PER_MS));
+    ASSERT_EQ(6, HPOD_controller_step(&ctrl, 1001 * NS_PER_MS));
+
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_EQ(12u, stats.ik_failures);
+}
+
+TEST_F(ControllerTest, RunsAtRate)
+{
+    struct hpod_controller_stats_s stats;
+
+    // Realtime scheduling is used where permitted, the controller falls back otherwise
+    ctrl.config.priority = 10;
+    HPOD_controller_command(&ctrl, &command);
+
+    ASSERT_EQ(0, HPOD_controller_start(&ctrl));
+    usleep(100000);
+
+    // Snapshots may be taken while running
+    HPOD_controller_stats(&ctrl, &stats);
+    ASSERT_GT(stats.ticks, 0u);
+
+    HPOD_controller_stop(&ctrl);
+    HPOD_controller_stats(&ctrl, &stats);
+
+    // Every period is either executed or accounted for as skipped
+    ASSERT_GT(stats.ticks, 50u);
+    ASSERT_LT(stats.ticks, 150u);
+    ASSERT_EQ(stats.ticks, (uint64_t) capture.calls);
+    ASSERT_LE(stats.ticks + stats.skipped, 120u);
+
+    uint64_t histogram = 0;
+    for (int i = 0; i < HPOD_JITTER_BINS; i++) {
+        histogram += stats.jitter[i];
+    }
+    ASSERT_EQ(stats.ticks, histogram);
+
+    for (int i = 0; i < HPOD_CONTROLLER_STAGES; i++) {
+        ASSERT_LE(stats.stage[i].last, stats.stage[i].max);
+        ASSERT_LE(stats.stage[i].max, stats.stage[i].total);
+    }
+    ASSERT_GT(stats.stage[HPOD_STAGE_KINEMATICS].total, 0u);
+    ASSERT_EQ(0u, stats.ik_failures);
+}
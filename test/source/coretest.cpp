@@ -9,8 +9,15 @@
 #include "gtest/gtest.h"
 
 #include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
 
 #include "hexapod/hexapod.h"
+#include "hexapod/simd.h"
+#include "hexapod/fastmath.h"
 
 class HexTest : public ::testing::Test
 {
@@ -38,9 +45,73 @@ TEST_F(HexTest, ValidGait)
 #define SWEEP_SIZE      100
 #define FLOAT_ERROR     0.01
 
-TEST_F(HexTest, DISABLED_IK2SweepX)
+TEST_F(HexTest, GaitCalcLegWithoutRotation)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, -1.0, 0.0};
+
+    for (int i = 0; i < 6; i++) {
+        for (float phase = -1.0; phase < 1.0; phase += 0.1) {
+            struct hpod_vector3_s expected, actual;
+            HPOD_gait_calc(&hexy, &gait, &movement, phase, &expected);
+            HPOD_gait_calc_leg(&hexy, &gait, &movement, phase, i, &actual);
+
+            ASSERT_EQ(expected.x, actual.x);
+            ASSERT_EQ(expected.y, actual.y);
+            ASSERT_EQ(expected.z, actual.z);
+        }
+    }
+}
+
+TEST_F(HexTest, GaitCalcLegRotation)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s still = {0.0, 0.0, 0.0};
+    struct hpod_vector3_s turn = {0.0, 0.0, 1.0};
+    float phase = 0.25;
+
+    for (int i = 0; i < 6; i++) {
+        struct hpod_leg_mount_s *mount = &hexy.leg[i].mount;
+        struct hpod_vector3_s neutral, rotated;
+        HPOD_gait_calc(&hexy, &gait, &still, phase, &neutral);
+        HPOD_gait_calc_leg(&hexy, &gait, &turn, phase, i, &rotated);
+
+        // Feet relative to the body center
+        float nx = mount->x + neutral.x, ny = mount->y + neutral.y;
+        float rx = mount->x + rotated.x, ry = mount->y + rotated.y;
+
+        // Feet sweep an arc about the body center, by the same body angle for every leg
+        ASSERT_NEAR(sqrtf(nx * nx + ny * ny), sqrtf(rx * rx + ry * ry), FLOAT_ERROR);
+        float angle = (atan2f(ry, rx) - atan2f(ny, nx)) * mount->side;
+        ASSERT_NEAR(sinf(phase * M_PI) * gait.yaw / 2, angle, 0.0001);
+        ASSERT_EQ(neutral.z, rotated.z);
+    }
+
+    // Turning on the spot moves feet forwards on the right side and backwards on the left
+    for (int i = 0; i < 6; i++) {
+        struct hpod_vector3_s pos;
+        HPOD_gait_calc_leg(&hexy, &gait, &turn, phase, i, &pos);
+        ASSERT_GT(pos.y * hexy.leg[i].mount.side, 0.0);
+    }
+}
+
+TEST_F(HexTest, GaitArcSolvable)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s arc = {0.0, 0.5, 0.5};
+
+    for (int i = 0; i < 6; i++) {
+        for (float phase = -1.0; phase < 1.0; phase += 0.05) {
+            struct hpod_vector3_s pos;
+            float alpha, beta, theta;
+            HPOD_gait_calc_leg(&hexy, &gait, &arc, phase, i, &pos);
+            ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+        }
+    }
+}
+
+TEST_F(HexTest, IK2SweepX)
 {
-    //TODO: make this test less fragile
     float alpha, beta, _x, _h;
 
     float h_error = 0.0;
@@ -48,8 +119,12 @@ TEST_F(HexTest, DISABLED_IK2SweepX)
 
     float h = 0;
 
+    // Sweep inside the reach envelope, targets closer than the minimum reach have no solution
+    float reach_min = hexy.kinematics.reach_min + 10;
+    float reach_max = hexy.kinematics.reach_max - 10;
+
     for (int i = 0; i < SWEEP_SIZE; i++) {
-        float x = hexy.config.offset_a + 10 + hexy.config.len_bc / SWEEP_SIZE * i;
+        float x = reach_min + (reach_max - reach_min) / SWEEP_SIZE * i;
 
         HPOD_leg_ik2(&hexy, x, h, &alpha, &beta);
         HPOD_leg_fk2(&hexy, alpha, beta, &_x, &_h);
@@ -89,7 +164,8 @@ TEST_F(HexTest, IK2SweepXH)
     float x_error = 0.0;
 
     for (int i = 0; i < SWEEP_SIZE; i++) {
-        float x = hexy.config.offset_a + 10 + hexy.config.len_bc / SWEEP_SIZE * i;
+        // Start outside the minimum reach of the leg (|len_ab - len_bc|)
+        float x = hexy.config.offset_a + 30 + hexy.config.len_bc / SWEEP_SIZE * i;
         float h = -hexy.config.len_bc / 4 + hexy.config.len_bc / 2 / SWEEP_SIZE * i;
 
         HPOD_leg_ik2(&hexy, x, h, &alpha, &beta);
@@ -126,6 +202,173 @@ TEST_F(HexTest, IK3SweepY)
     }
 }
 
+TEST_F(HexTest, InitKinematics)
+{
+    struct hpod_kinematics_s *k = &hexy.kinematics;
+
+    ASSERT_NEAR(hexy.config.len_ab * hexy.config.len_ab, k->len_ab_sq, FLOAT_ERROR);
+    ASSERT_NEAR(hexy.config.len_bc * hexy.config.len_bc, k->len_bc_sq, FLOAT_ERROR);
+    ASSERT_NEAR(hexy.config.len_ab, k->len_ab, FLOAT_ERROR);
+    ASSERT_NEAR(hexy.config.len_bc, k->len_bc, FLOAT_ERROR);
+    ASSERT_NEAR(1.0 / (2 * hexy.config.len_ab * hexy.config.len_bc), k->inv_len_ab_bc_2, 1e-9);
+    ASSERT_NEAR(fabs(hexy.config.len_ab - hexy.config.len_bc), k->reach_min, FLOAT_ERROR);
+    ASSERT_NEAR(hexy.config.len_ab + hexy.config.len_bc, k->reach_max, FLOAT_ERROR);
+}
+
+// Eight legs on a round body, swept evenly front to back with the leg frames facing outwards
+static void octopod_config(struct hexapod_config_s* config)
+{
+    *config = HPOD_DEFAULT_CONFIG;
+    config->legs = 8;
+
+    for (int i = 0; i < 8; i++) {
+        float angle = (67.5f - 45.0f * (i / 2)) * M_PI / 180;
+        config->leg[i].x = (i % 2 ? 100.0f : -100.0f) * cosf(angle);
+        config->leg[i].y = 100.0f * sinf(angle);
+        config->leg[i].yaw = angle;
+    }
+}
+
+// Leg frame foot position in the body frame
+static void leg_to_body(struct hexapod_s* hexy, int leg, struct hpod_vector3_s* pos, float body[2])
+{
+    struct hpod_leg_mount_s* mount = &hexy->leg[leg].mount;
+    float x = mount->x + pos->x, y = mount->y + pos->y;
+
+    body[0] = mount->side * (mount->cos_yaw * x - mount->sin_yaw * y);
+    body[1] = mount->sin_yaw * x + mount->cos_yaw * y;
+}
+
+TEST_F(HexTest, InitDefaultLayout)
+{
+    ASSERT_EQ(6, hexy.legs);
+    ASSERT_EQ(1, hexy.uniform);
+    ASSERT_EQ(1, hexy.aligned);
+    ASSERT_EQ(0, (uintptr_t)&hexy.leg[1] % HPOD_CACHE_LINE);
+    static_assert(sizeof(struct hpod_leg_s) == HPOD_CACHE_LINE, "one cache line per leg");
+
+    for (int i = 0; i < 6; i++) {
+        struct hpod_leg_s* leg = &hexy.leg[i];
+        ASSERT_EQ(hexy.config.width / 2, leg->mount.x);
+        ASSERT_EQ(leg_offsets[i].y * hexy.config.length / 2, leg->mount.y);
+        ASSERT_EQ(leg_offsets[i].x, leg->mount.side);
+        ASSERT_EQ(1.0f, leg->mount.cos_yaw);
+        ASSERT_EQ(0.0f, leg->mount.sin_yaw);
+        ASSERT_EQ(hexy.config.offset_a, leg->offset_a);
+        ASSERT_EQ(0, memcmp(&hexy.kinematics, &leg->kinematics, sizeof(struct hpod_kinematics_s)));
+    }
+}
+
+TEST_F(HexTest, InitLegLayout)
+{
+    struct hexapod_config_s config;
+    octopod_config(&config);
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+
+    ASSERT_EQ(8, hexy.legs);
+    ASSERT_EQ(0, hexy.uniform);
+    ASSERT_EQ(0, hexy.aligned);
+
+    // Mounts return to the configured body positions
+    for (int i = 0; i < 8; i++) {
+        struct hpod_vector3_s origin = {0, 0, 0};
+        float body[2];
+        leg_to_body(&hexy, i, &origin, body);
+        ASSERT_NEAR(config.leg[i].x, body[0], FLOAT_ERROR);
+        ASSERT_NEAR(config.leg[i].y, body[1], FLOAT_ERROR);
+        ASSERT_EQ(i % 2 ? 1.0f : -1.0f, hexy.leg[i].mount.side);
+    }
+
+    // Links are per leg, unset links use the shared config
+    float alpha, beta, theta;
+    struct hpod_vector3_s pos = {hexy.config.offset_a + 240.0f, 0.0f, 0.0f};
+    ASSERT_EQ(0, HPOD_leg_ik3_n(&hexy, 5, &pos, &alpha, &beta, &theta));
+    ASSERT_EQ(-1, HPOD_leg_ik3_n(&hexy, 4, &pos, &alpha, &beta, &theta));
+    ASSERT_EQ(-1, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+    ASSERT_EQ(hexy.config.offset_a, hexy.leg[5].offset_a);
+}
+
+TEST_F(HexTest, FK3LegLinks)
+{
+    struct hexapod_config_s config;
+    octopod_config(&config);
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+
+    // Per leg FK inverts the per leg IK, the shared FK does not
+    for (int i = 0; i < SWEEP_SIZE; i++) {
+        float alpha, beta, theta;
+        struct hpod_vector3_s desired_pos = {hexy.config.offset_a + 160.0f + i * 0.5f, 20.0f, -30.0f};
+        struct hpod_vector3_s actual_pos, shared_pos;
+
+        ASSERT_EQ(0, HPOD_leg_ik3_n(&hexy, 5, &desired_pos, &alpha, &beta, &theta));
+        HPOD_leg_fk3_n(&hexy, 5, alpha, beta, theta, &actual_pos);
+        HPOD_leg_fk3(&hexy, alpha, beta, theta, &shared_pos);
+
+        ASSERT_NEAR(desired_pos.x, actual_pos.x, FLOAT_ERROR);
+        ASSERT_NEAR(desired_pos.y, actual_pos.y, FLOAT_ERROR);
+        ASSERT_NEAR(desired_pos.z, actual_pos.z, FLOAT_ERROR);
+        ASSERT_GT(fabs(desired_pos.x - shared_pos.x) + fabs(desired_pos.z - shared_pos.z), 1.0);
+    }
+}
+
+TEST_F(HexTest, GaitLegLayout)
+{
+    struct hexapod_config_s config;
+    octopod_config(&config);
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    float outputs[8][3];
+
+    // Swept legs see forward strides partly along the leg, so need a shorter stride
+    gait.movement = {60.0, 100.0, 20.0};
+
+    // Feet stride straight forwards in the body frame whatever the mount yaw
+    for (int i = 0; i < 8; i++) {
+        struct hpod_vector3_s a, b;
+        float body_a[2], body_b[2];
+        HPOD_gait_calc_leg(&hexy, &gait, &movement, -0.25, i, &a);
+        HPOD_gait_calc_leg(&hexy, &gait, &movement, 0.25, i, &b);
+        leg_to_body(&hexy, i, &a, body_a);
+        leg_to_body(&hexy, i, &b, body_b);
+
+        ASSERT_NEAR(0.0, body_b[0] - body_a[0], FLOAT_ERROR);
+        ASSERT_NEAR(gait.movement.y * sinf(M_PI / 4), body_b[1] - body_a[1], FLOAT_ERROR);
+    }
+
+    // Every leg is solved
+    HPOD_output_mix(&hexy, &gait, &movement, 0.3, outputs);
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 3; j++) {
+            ASSERT_FALSE(isnan(outputs[i][j]));
+        }
+    }
+    ASSERT_EQ(0, HPOD_gait_valid(&hexy, &gait));
+}
+
+TEST_F(HexTest, IK3ReachEnvelope)
+{
+    float alpha, beta, theta;
+    struct hpod_vector3_s pos;
+
+    // Beyond maximum reach
+    pos.x = hexy.config.offset_a + hexy.kinematics.reach_max + 1; pos.y = 0; pos.z = 0;
+    ASSERT_EQ(-1, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+    ASSERT_TRUE(isnan(alpha) && isnan(beta) && isnan(theta));
+
+    // Inside minimum reach
+    pos.x = hexy.config.offset_a + hexy.kinematics.reach_min - 1; pos.y = 0; pos.z = 0;
+    ASSERT_EQ(-1, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+
+    // Just inside either boundary
+    pos.x = hexy.config.offset_a + hexy.kinematics.reach_max - 1;
+    ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+    pos.x = hexy.config.offset_a + hexy.kinematics.reach_min + 1;
+    ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+}
 
 TEST_F(HexTest, BodyTransformNeutral)
 {
@@ -219,21 +462,22 @@ TEST_F(HexTest, BodyTransformRoll)
 }
 
 
-TEST_F(HexTest, DISABLED_BodyTransformPitchRoll)
+TEST_F(HexTest, BodyTransformPitchRoll)
 {
     float roll, pitch;
     struct hpod_vector3_s world_pos;
     struct hpod_vector3_s joint_pos;
 
-    // X, Y and H change with roll with zero offsets
+    // X, Y and H change with roll with zero offsets, pitch is applied before roll
     roll = M_PI / 8; pitch = M_PI / 9;
     world_pos.x = 0; world_pos.y = 10; world_pos.z = 30;
 
     HPOD_body_transform(&hexy, roll, pitch, 0, 0, &world_pos, &joint_pos);
 
-    ASSERT_NEAR(world_pos.y * sin(pitch), joint_pos.y, FLOAT_ERROR);
-    ASSERT_NEAR(world_pos.z * sin(roll), joint_pos.x, FLOAT_ERROR);
-    ASSERT_NEAR(world_pos.z * cos(roll) * cos(pitch), joint_pos.z, FLOAT_ERROR);
+    float pitch_z = world_pos.z * cos(pitch) - world_pos.y * sin(pitch);
+    ASSERT_NEAR(world_pos.y * cos(pitch) + world_pos.z * sin(pitch), joint_pos.y, FLOAT_ERROR);
+    ASSERT_NEAR(pitch_z * sin(roll), joint_pos.x, FLOAT_ERROR);
+    ASSERT_NEAR(pitch_z * cos(roll), joint_pos.z, FLOAT_ERROR);
 
     // H changes with pitch and offset Y where Y is zero
     roll = 0.0; pitch = M_PI / 8;
@@ -255,3 +499,172 @@ TEST_F(HexTest, DISABLED_BodyTransformPitchRoll)
     ASSERT_NEAR(world_pos.x, joint_pos.x, FLOAT_ERROR);
 }
 
+TEST(FastMath, ErrorBounds)
+{
+    float acos_error = 0, atan2_error = 0, sin_error = 0, sqrt_error = 0;
+
+    for (int i = 0; i <= 100000; i++) {
+        float x = -1.0f + 2.0f * i / 100000;
+        acos_error = fmaxf(acos_error, fabs(HPOD_fast_acosf(x) - acos(x)));
+
+        float a = -8 * M_PI + 16 * M_PI * i / 100000;
+        sin_error = fmaxf(sin_error, fabs(HPOD_fast_sinf(a) - sin(a)));
+        sin_error = fmaxf(sin_error, fabs(HPOD_fast_cosf(a) - cos(a)));
+
+        float v = 1e-3f + 1e5f * i / 100000;
+        sqrt_error = fmaxf(sqrt_error, fabs(HPOD_fast_sqrtf(v) - sqrt(v)) / sqrt(v));
+    }
+
+    for (int i = 0; i <= 400; i++) {
+        for (int j = 0; j <= 400; j++) {
+            float y = -200.0f + i, x = -200.0f + j;
+            float e = fabs(HPOD_fast_atan2f(y, x) - atan2(y, x));
+            // Both sides of the branch cut are the same angle
+            atan2_error = fmaxf(atan2_error, fminf(e, fabs(e - 2 * M_PI)));
+        }
+    }
+
+    ASSERT_LT(acos_error, HPOD_FAST_ACOS_MAX_ERROR);
+    ASSERT_LT(atan2_error, HPOD_FAST_ATAN2_MAX_ERROR);
+    ASSERT_LT(sin_error, HPOD_FAST_SIN_MAX_ERROR);
+    ASSERT_LT(sqrt_error, HPOD_FAST_SQRT_MAX_REL_ERROR);
+    ASSERT_TRUE(isnan(HPOD_fast_acosf(1.01f)));
+}
+
+class SimdTest : public HexTest, public ::testing::WithParamInterface<enum hpod_simd_e>
+{
+protected:
+    void SetUp()
+    {
+        if (!HPOD_simd_supported(GetParam())) {
+            GTEST_SKIP();
+        }
+        ASSERT_EQ(GetParam(), HPOD_simd_select(GetParam()));
+    }
+
+    void TearDown()
+    {
+        HPOD_simd_select(HPOD_SIMD_AUTO);
+    }
+};
+
+TEST_P(SimdTest, IK2MatchesScalar)
+{
+    // Odd count to exercise partial vectors
+    const int count = SWEEP_SIZE + 3;
+    float d[count], h[count], alpha[count], beta[count];
+
+    for (int i = 0; i < count; i++) {
+        d[i] = hexy.config.offset_a + 30 + hexy.config.len_bc / count * i;
+        h[i] = -hexy.config.len_bc / 4 + hexy.config.len_bc / 2 / count * i;
+    }
+
+    ASSERT_EQ(0, HPOD_leg_ik2_simd(&hexy, count, d, h, alpha, beta));
+
+    for (int i = 0; i < count; i++) {
+        float a, b;
+        HPOD_leg_ik2(&hexy, d[i], h[i], &a, &b);
+
+        ASSERT_NEAR(a, alpha[i], FLOAT_ERROR);
+        ASSERT_NEAR(b, beta[i], FLOAT_ERROR);
+    }
+}
+
+TEST_P(SimdTest, IK2Unreachable)
+{
+    float reach = hexy.config.len_ab + hexy.config.len_bc;
+    float d[3] = {reach + 10, 0, reach / 2};
+    float h[3] = {0, 10, 0};
+    float alpha[3], beta[3];
+
+    HPOD_leg_ik2_simd(&hexy, 3, d, h, alpha, beta);
+
+    ASSERT_TRUE(isnan(alpha[0]) || isnan(beta[0]));
+    ASSERT_TRUE(isnan(alpha[1]) || isnan(beta[1]));
+    ASSERT_FALSE(isnan(alpha[2]) || isnan(beta[2]));
+}
+
+TEST_P(SimdTest, FK2MatchesScalar)
+{
+    const int count = SWEEP_SIZE + 5;
+    float alpha[count], beta[count], x[count], h[count];
+
+    for (int i = 0; i < count; i++) {
+        alpha[i] = -M_PI / 2 + M_PI / count * i;
+        beta[i] = M_PI / 8 + M_PI * 3 / 4 / count * i;
+    }
+
+    ASSERT_EQ(0, HPOD_leg_fk2_simd(&hexy, count, alpha, beta, x, h));
+
+    for (int i = 0; i < count; i++) {
+        float _x, _h;
+        HPOD_leg_fk2(&hexy, alpha[i], beta[i], &_x, &_h);
+
+        ASSERT_NEAR(_x, x[i], FLOAT_ERROR);
+        ASSERT_NEAR(_h, h[i], FLOAT_ERROR);
+    }
+}
+
+TEST_P(SimdTest, AcceptsMountYaw)
+{
+    // Mount yaw does not change the joint frame, so splayed legs with shared links are solved
+    struct hexapod_config_s config;
+    octopod_config(&config);
+    HPOD_init(&hexy, &config);
+    ASSERT_EQ(1, hexy.uniform);
+    ASSERT_EQ(0, hexy.aligned);
+
+    float d[1] = {hexy.config.offset_a + 30}, h[1] = {0}, alpha[1], beta[1], a, b;
+    ASSERT_EQ(0, HPOD_leg_ik2_simd(&hexy, 1, d, h, alpha, beta));
+    HPOD_leg_ik2(&hexy, d[0], h[0], &a, &b);
+    ASSERT_NEAR(a, alpha[0], FLOAT_ERROR);
+    ASSERT_NEAR(b, beta[0], FLOAT_ERROR);
+    ASSERT_EQ(0, HPOD_leg_fk2_simd(&hexy, 1, alpha, beta, d, h));
+}
+
+TEST_P(SimdTest, RejectsPerLegLinks)
+{
+    // Kernels only hold the shared links
+    struct hexapod_config_s config;
+    octopod_config(&config);
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+
+    float d[1] = {hexy.config.offset_a + 30}, h[1] = {0}, alpha[1], beta[1];
+    ASSERT_EQ(-1, HPOD_leg_ik2_simd(&hexy, 1, d, h, alpha, beta));
+    ASSERT_EQ(-1, HPOD_leg_fk2_simd(&hexy, 1, alpha, beta, d, h));
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, SimdTest,
+                         ::testing::Values(HPOD_SIMD_SCALAR, HPOD_SIMD_X4, HPOD_SIMD_X8));
+
+TEST_F(HexTest, SimdConcurrentSelect)
+{
+    // Kernels are used while another thread reselects them (run under ThreadSanitizer)
+    const int count = SWEEP_SIZE;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([this, t]() {
+            float d[count], h[count], alpha[count], beta[count];
+            for (int i = 0; i < count; i++) {
+                d[i] = hexy.config.offset_a + 30 + hexy.config.len_bc / count * i;
+                h[i] = 0;
+            }
+
+            for (int n = 0; n < 200; n++) {
+                if (t == 0) {
+                    HPOD_simd_select((n % 2) ? HPOD_SIMD_SCALAR : HPOD_SIMD_AUTO);
+                }
+                HPOD_leg_ik2_simd(&hexy, count, d, h, alpha, beta);
+                HPOD_leg_fk2_simd(&hexy, count, alpha, beta, d, h);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    HPOD_simd_select(HPOD_SIMD_AUTO);
+}
@@ -0,0 +1,215 @@
+/**
+ * Libhexapod
+ * Hexapod C++ API Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/hexapod.hpp"
+#include "hexapod/fixed.h"
+
+#define FLOAT_ERROR     0.001
+#define FIXED_ERROR     0.05
+#define CPP_SLICES      100
+
+using hpod::Q16;
+
+// Geometry and mounts are compile time constants
+static_assert(hpod::Hexapod<float>::mount(0).side == -1.0f, "front left mount");
+static_assert(hpod::Hexapod<float>::mount(5).y == -100.0f, "rear right mount");
+static_assert(hpod::Hexapod<Q16>::mount(3).x.raw == 50 * HPOD_Q16_ONE, "fixed mount");
+static_assert((hpod::Vec3<float> {1, 2, 3} + hpod::Vec3<float> {1, 1, 1}).z == 4.0f, "vector add");
+
+// Four legged layout with a trotting schedule
+struct QuadGeometry {
+    static constexpr float length = 160;
+    static constexpr float width = 80;
+    static constexpr float offset_a = 45;
+    static constexpr float len_ab = 80;
+    static constexpr float len_bc = 150;
+};
+typedef hpod::PhaseSchedule<2, 1, 0, 1, 1, 0> Trot;
+
+class CppTest : public ::testing::Test
+{
+protected:
+    CppTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+        HPOD_fx_init(&fx, &config);
+    }
+
+    virtual ~CppTest()
+    {
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_fx_s fx;
+    struct hpod_gait_s c_gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s c_movement = {0.5, 1.0, 0.5};
+};
+
+TEST_F(CppTest, MountsMatchInit)
+{
+    for (int i = 0; i < 6; i++) {
+        hpod::Mount<float> mount = hpod::Hexapod<float>::mount(i);
+        ASSERT_EQ(hexy.leg[i].mount.x, mount.x);
+        ASSERT_EQ(hexy.leg[i].mount.y, mount.y);
+        ASSERT_EQ(hexy.leg[i].mount.side, mount.side);
+    }
+
+    struct hexapod_config_s config = hpod::geometry_config<hpod::DefaultGeometry>();
+    ASSERT_EQ(hexy.config.offset_a, config.offset_a);
+    ASSERT_EQ(hexy.config.len_bc, config.len_bc);
+}
+
+TEST_F(CppTest, KinematicsMatchC)
+{
+    hpod::Hexapod<float> hex_f;
+    hpod::Hexapod<double> hex_d;
+
+    for (int i = 0; i < CPP_SLICES; i++) {
+        struct hpod_vector3_s target = {100.0f + i, -80.0f + 1.6f * i, -120.0f + i};
+        float alpha, beta, theta;
+        int res = HPOD_leg_ik3(&hexy, &target, &alpha, &beta, &theta);
+
+        auto angles_f = hex_f.ik(hpod::Vec3<float>::from(target));
+        auto angles_d = hex_d.ik(hpod::Vec3<double>::from(target));
+        ASSERT_EQ(res == 0, angles_f.has_value());
+        ASSERT_EQ(res == 0, angles_d.has_value());
+        if (res != 0) {
+            continue;
+        }
+
+        ASSERT_NEAR(alpha, angles_f->alpha, FLOAT_ERROR);
+        ASSERT_NEAR(beta, angles_f->beta, FLOAT_ERROR);
+        ASSERT_NEAR(theta, angles_f->theta, FLOAT_ERROR);
+        ASSERT_NEAR(alpha, angles_d->alpha, FLOAT_ERROR);
+
+        // Forward kinematics round trip
+        struct hpod_vector3_s c_pos;
+        HPOD_leg_fk3(&hexy, alpha, beta, theta, &c_pos);
+        hpod::Vec3<float> pos = hex_f.fk(*angles_f);
+        ASSERT_NEAR(c_pos.x, pos.x, FLOAT_ERROR * 100);
+        ASSERT_NEAR(target.y, pos.y, FLOAT_ERROR * 100);
+        ASSERT_NEAR(target.z, pos.z, FLOAT_ERROR * 100);
+    }
+
+    // Unreachable targets have no solution
+    ASSERT_FALSE(hex_f.ik({1000.0f, 0.0f, 0.0f}).has_value());
+}
+
+TEST_F(CppTest, FixedMatchesC)
+{
+    hpod::Hexapod<Q16> hex_q;
+
+    for (int i = 0; i < CPP_SLICES; i++) {
+        struct hpod_fx_vector3_s target = {HPOD_Q16_FROM_FLOAT(100.0f + i), HPOD_Q16_FROM_FLOAT(-80.0f + 1.6f * i),
+                                           HPOD_Q16_FROM_FLOAT(-120.0f + i)
+                                          };
+        hpod_q16_t alpha, beta, theta;
+        int res = HPOD_fx_leg_ik3(&fx, &target, &alpha, &beta, &theta);
+
+        auto angles = hex_q.ik({Q16::from_raw(target.x), Q16::from_raw(target.y), Q16::from_raw(target.z)});
+        ASSERT_EQ(res == 0, angles.has_value());
+        if (res != 0) {
+            continue;
+        }
+
+        ASSERT_EQ(alpha, angles->alpha.raw);
+        ASSERT_EQ(beta, angles->beta.raw);
+        ASSERT_EQ(theta, angles->theta.raw);
+
+        hpod::Vec3<Q16> pos = hex_q.fk(*angles);
+        ASSERT_NEAR(HPOD_Q16_TO_FLOAT(target.y), (float)pos.y, FIXED_ERROR);
+    }
+}
+
+TEST_F(CppTest, GaitMatchesC)
+{
+    typedef hpod::Hexapod<float> Hex;
+    typedef hpod::Hexapod<Q16> HexQ;
+    hpod::Gait<float> gait = hpod::Gait<float>::from(c_gait);
+    hpod::Gait<Q16> gait_q = hpod::Gait<Q16>::from(c_gait);
+    hpod::Vec3<float> movement = hpod::Vec3<float>::from(c_movement);
+    hpod::Vec3<Q16> movement_q = hpod::Vec3<Q16>::from(c_movement);
+
+    for (int i = 0; i < CPP_SLICES; i++) {
+        float phase = 2.0f * i / CPP_SLICES - 1.0f;
+        struct hpod_vector3_s expected;
+
+        HPOD_gait_calc(&hexy, &c_gait, &c_movement, phase, &expected);
+        hpod::Vec3<float> actual = Hex::gait(gait, movement, phase);
+        ASSERT_NEAR(expected.x, actual.x, FLOAT_ERROR);
+        ASSERT_NEAR(expected.y, actual.y, FLOAT_ERROR);
+        ASSERT_NEAR(expected.z, actual.z, FLOAT_ERROR);
+
+        HPOD_gait_calc_leg(&hexy, &c_gait, &c_movement, phase, 4, &expected);
+        actual = Hex::gait_leg<4>(gait, movement, phase);
+        ASSERT_NEAR(expected.x, actual.x, FLOAT_ERROR);
+        ASSERT_NEAR(expected.y, actual.y, FLOAT_ERROR);
+        ASSERT_NEAR(expected.z, actual.z, FLOAT_ERROR);
+
+        hpod::Vec3<Q16> actual_q = HexQ::gait_leg<4>(gait_q, movement_q, Q16(phase));
+        ASSERT_NEAR(expected.x, (float)actual_q.x, FIXED_ERROR);
+        ASSERT_NEAR(expected.y, (float)actual_q.y, FIXED_ERROR);
+        ASSERT_NEAR(expected.z, (float)actual_q.z, FIXED_ERROR);
+    }
+}
+
+TEST_F(CppTest, OutputMatchesC)
+{
+    hpod::Hexapod<float> hex_f;
+    hpod::Hexapod<Q16> hex_q;
+    hpod::Gait<float> gait = hpod::Gait<float>::from(c_gait);
+    hpod::Gait<Q16> gait_q = hpod::Gait<Q16>::from(c_gait);
+    hpod::Vec3<float> movement = hpod::Vec3<float>::from(c_movement);
+    hpod::Vec3<Q16> movement_q = hpod::Vec3<Q16>::from(c_movement);
+
+    for (int i = 0; i < CPP_SLICES; i++) {
+        float phase = 2.0f * i / CPP_SLICES - 1.0f;
+        float expected[6][3];
+
+        HPOD_output_mix(&hexy, &c_gait, &c_movement, phase, expected);
+        auto actual = hex_f.output(gait, movement, phase);
+        auto actual_q = hex_q.output(gait_q, movement_q, Q16(phase));
+
+        for (int j = 0; j < 6; j++) {
+            ASSERT_TRUE(actual[j].has_value());
+            ASSERT_NEAR(expected[j][0], actual[j]->alpha, FLOAT_ERROR);
+            ASSERT_NEAR(expected[j][1], actual[j]->beta, FLOAT_ERROR);
+            ASSERT_NEAR(expected[j][2], actual[j]->theta, FLOAT_ERROR);
+
+            ASSERT_TRUE(actual_q[j].has_value());
+            ASSERT_NEAR(expected[j][0], (float)actual_q[j]->alpha, FIXED_ERROR);
+            ASSERT_NEAR(expected[j][2], (float)actual_q[j]->theta, FIXED_ERROR);
+        }
+    }
+}
+
+TEST_F(CppTest, LegCountAndSchedule)
+{
+    typedef hpod::Hexapod<float, QuadGeometry, 4> Quad;
+    Quad quad;
+    hpod::Gait<float> gait = hpod::Gait<float>::from(c_gait);
+
+    static_assert(Quad::mount(2).y == -80.0f, "rear mount");
+    static_assert(std::tuple_size<decltype(quad.output<Trot>(gait, {}, 0.0f))>::value == 4, "four legs");
+
+    // Diagonal pairs share a phase, so their planar angles mirror front to back
+    auto angles = quad.output<Trot>(gait, {0.0f, 1.0f, 0.0f}, 0.25f);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(angles[i].has_value());
+    }
+    ASSERT_NEAR(angles[0]->theta, angles[3]->theta, FLOAT_ERROR);
+    ASSERT_NEAR(angles[1]->theta, angles[2]->theta, FLOAT_ERROR);
+    ASSERT_NEAR(angles[0]->theta, -angles[1]->theta, FLOAT_ERROR);
+}
@@ -0,0 +1,184 @@
+/**
+ * Libhexapod
+ * Hexapod Fixed Point Unit Tests
+ * Checks the fixed point backend against the floating point implementation
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/servo.h"
+#include "hexapod/fixed.h"
+
+#define SWEEP_SIZE      100
+#define ANGLE_ERROR     0.001
+#define POS_ERROR       0.05
+
+class FixedTest : public ::testing::Test
+{
+protected:
+    FixedTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+        HPOD_fx_init(&fx, &config);
+
+        HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+        HPOD_fx_servo_init(&fx_servo, &servo);
+    }
+
+    virtual ~FixedTest()
+    {
+
+    }
+
+    static struct hpod_fx_vector3_s to_fx(struct hpod_vector3_s* v)
+    {
+        struct hpod_fx_vector3_s f;
+        f.x = HPOD_Q16_FROM_FLOAT(v->x);
+        f.y = HPOD_Q16_FROM_FLOAT(v->y);
+        f.z = HPOD_Q16_FROM_FLOAT(v->z);
+        return f;
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_fx_s fx;
+    struct hpod_servo_s servo;
+    struct hpod_fx_servo_s fx_servo;
+};
+
+TEST_F(FixedTest, SinCos)
+{
+    for (int i = 0; i <= 1000; i++) {
+        float a = -4 * M_PI + 8 * M_PI * i / 1000;
+        hpod_q16_t s, c;
+
+        HPOD_fx_sincos(HPOD_Q16_FROM_FLOAT(a), &s, &c);
+
+        ASSERT_NEAR(sinf(a), HPOD_Q16_TO_FLOAT(s), 1e-4);
+        ASSERT_NEAR(cosf(a), HPOD_Q16_TO_FLOAT(c), 1e-4);
+    }
+}
+
+TEST_F(FixedTest, Atan2)
+{
+    for (int i = 0; i <= 100; i++) {
+        for (int j = 0; j <= 100; j++) {
+            float y = -200.0f + 4 * i + 0.5f, x = -200.0f + 4 * j + 0.5f;
+            hpod_q16_t a = HPOD_fx_atan2(HPOD_Q16_FROM_FLOAT(y), HPOD_Q16_FROM_FLOAT(x));
+
+            ASSERT_NEAR(atan2f(y, x), HPOD_Q16_TO_FLOAT(a), 1e-4);
+        }
+    }
+}
+
+TEST_F(FixedTest, IK3MatchesFloat)
+{
+    for (int i = 0; i < SWEEP_SIZE; i++) {
+        struct hpod_vector3_s pos;
+        pos.x = hexy.config.offset_a + hexy.config.len_bc + hexy.config.len_ab / 2 * sinf(i * 0.1f);
+        pos.y = hexy.config.length / 4 * cosf(i * 0.07f);
+        pos.z = -hexy.config.len_bc / 4 * sinf(i * 0.13f);
+
+        float alpha, beta, theta;
+        ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+
+        struct hpod_fx_vector3_s fx_pos = to_fx(&pos);
+        hpod_q16_t a, b, t;
+        ASSERT_EQ(0, HPOD_fx_leg_ik3(&fx, &fx_pos, &a, &b, &t));
+
+        ASSERT_NEAR(alpha, HPOD_Q16_TO_FLOAT(a), ANGLE_ERROR);
+        ASSERT_NEAR(beta, HPOD_Q16_TO_FLOAT(b), ANGLE_ERROR);
+        ASSERT_NEAR(theta, HPOD_Q16_TO_FLOAT(t), ANGLE_ERROR);
+    }
+}
+
+TEST_F(FixedTest, IK3Unreachable)
+{
+    struct hpod_vector3_s pos = {hexy.config.offset_a + hexy.kinematics.reach_max + 1, 0, 0};
+    struct hpod_fx_vector3_s fx_pos = to_fx(&pos);
+    hpod_q16_t a, b, t;
+    int out[3];
+
+    ASSERT_EQ(-1, HPOD_fx_leg_ik3(&fx, &fx_pos, &a, &b, &t));
+    ASSERT_EQ(-1, HPOD_fx_leg_ik3_servo(&fx, &fx_servo, &fx_pos, out));
+    ASSERT_EQ(512, out[0]);
+}
+
+TEST_F(FixedTest, FK3MatchesFloat)
+{
+    for (int i = 0; i < SWEEP_SIZE; i++) {
+        float alpha = M_PI / 4 * sinf(i * 0.1f);
+        float beta = M_PI / 2 + M_PI / 4 * sinf(i * 0.13f);
+        float theta = M_PI / 4 * cosf(i * 0.07f);
+
+        struct hpod_vector3_s expected;
+        HPOD_leg_fk3(&hexy, alpha, beta, theta, &expected);
+
+        struct hpod_fx_vector3_s actual;
+        HPOD_fx_leg_fk3(&fx, HPOD_Q16_FROM_FLOAT(alpha), HPOD_Q16_FROM_FLOAT(beta),
+                        HPOD_Q16_FROM_FLOAT(theta), &actual);
+
+        ASSERT_NEAR(expected.x, HPOD_Q16_TO_FLOAT(actual.x), POS_ERROR);
+        ASSERT_NEAR(expected.y, HPOD_Q16_TO_FLOAT(actual.y), POS_ERROR);
+        ASSERT_NEAR(expected.z, HPOD_Q16_TO_FLOAT(actual.z), POS_ERROR);
+    }
+}
+
+TEST_F(FixedTest, GaitMatchesFloat)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_fx_gait_s fx_gait;
+    HPOD_fx_gait_init(&fx_gait, &gait);
+
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+    struct hpod_fx_vector3_s fx_movement = to_fx(&movement);
+
+    for (int i = 0; i < 4 * SWEEP_SIZE; i++) {
+        float phase = -2.0f + 4.0f * i / (4 * SWEEP_SIZE);
+
+        struct hpod_vector3_s expected;
+        HPOD_gait_calc(&hexy, &gait, &movement, phase, &expected);
+
+        struct hpod_fx_vector3_s actual;
+        HPOD_fx_gait_calc(&fx_gait, &fx_movement, HPOD_Q16_FROM_FLOAT(phase), &actual);
+
+        ASSERT_NEAR(expected.x, HPOD_Q16_TO_FLOAT(actual.x), POS_ERROR);
+        ASSERT_NEAR(expected.y, HPOD_Q16_TO_FLOAT(actual.y), POS_ERROR);
+        ASSERT_NEAR(expected.z, HPOD_Q16_TO_FLOAT(actual.z), POS_ERROR);
+    }
+}
+
+TEST_F(FixedTest, ServoMatchesFloat)
+{
+    for (int i = 0; i <= 1000; i++) {
+        float angle = -4.0f + 8.0f * i / 1000;
+
+        int expected = HPOD_servo_scale(&servo, angle);
+        int actual = HPOD_fx_servo_scale(&fx_servo, HPOD_Q16_FROM_FLOAT(angle));
+
+        ASSERT_NEAR(expected, actual, 1);
+    }
+}
+
+TEST_F(FixedTest, IK3ServoMatchesFloat)
+{
+    struct hpod_vector3_s pos = {hexy.config.offset_a + hexy.config.len_bc, 20, -30};
+    float angles[3];
+    ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &angles[0], &angles[1], &angles[2]));
+
+    struct hpod_fx_vector3_s fx_pos = to_fx(&pos);
+    int out[3];
+    ASSERT_EQ(0, HPOD_fx_leg_ik3_servo(&fx, &fx_servo, &fx_pos, out));
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_NEAR(HPOD_servo_scale(&servo, angles[i]), out[i], 1);
+    }
+}
+
@@ -0,0 +1,194 @@
+/**
+ * Libhexapod
+ * Hexapod Gait Blend Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+#include "hexapod/gait_table.h"
+#include "hexapod/gait_blend.h"
+
+#define FLOAT_ERROR     0.0001
+#define BLEND_SLICES    256
+#define BLEND_STEP      (1.0f / 256)
+
+class GaitBlendTest : public ::testing::Test
+{
+protected:
+    GaitBlendTest() : shape_a(BLEND_SLICES), shape_b(BLEND_SLICES)
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+
+        gait_b.movement = {80.0, 160.0, 30.0};
+        gait_b.offset = {140.0, 0.0, -80.0};
+        gait_b.height_scale = 0.15;
+        gait_b.yaw = 0.3;
+
+        HPOD_gait_table_init(&table_a, &hexy, &gait_a, &movement_a, BLEND_SLICES, shape_a.data(), NULL);
+        HPOD_gait_table_init(&table_b, &hexy, &gait_b, &movement_b, BLEND_SLICES, shape_b.data(), NULL);
+    }
+
+    virtual ~GaitBlendTest()
+    {
+    }
+
+    // Walk steps of BLEND_STEP phase from phase 0, starting a blend to table b at step start
+    std::vector<struct hpod_vector3_s> walk(int steps, int start, float cycles)
+    {
+        std::vector<struct hpod_vector3_s> positions(steps);
+        struct hpod_gait_blend_s blend;
+
+        HPOD_gait_blend_init(&blend, &table_a, 0.0f);
+
+        for (int i = 0; i < steps; i++) {
+            float phase = i * BLEND_STEP;
+            phase = phase - 2.0f * floorf((phase + 1.0f) / 2.0f);
+
+            if (i == start) {
+                HPOD_gait_blend_start(&blend, &table_b, cycles);
+            }
+
+            HPOD_gait_blend_update(&blend, phase);
+            HPOD_gait_blend_calc(&blend, phase, HPOD_INTERP_CUBIC, &positions[i]);
+        }
+
+        return positions;
+    }
+
+    // Maximum third difference of position (jerk per step^3) over a walk
+    float max_jerk(std::vector<struct hpod_vector3_s>& p)
+    {
+        float max = 0;
+        for (unsigned int i = 0; i + 3 < p.size(); i++) {
+            float jx = p[i + 3].x - 3 * p[i + 2].x + 3 * p[i + 1].x - p[i].x;
+            float jy = p[i + 3].y - 3 * p[i + 2].y + 3 * p[i + 1].y - p[i].y;
+            float jz = p[i + 3].z - 3 * p[i + 2].z + 3 * p[i + 1].z - p[i].z;
+            max = fmaxf(max, sqrtf(jx * jx + jy * jy + jz * jz));
+        }
+        return max;
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_gait_s gait_a = HPOD_DEFAULT_GAIT;
+    struct hpod_gait_s gait_b = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement_a = {0.0, 1.0, 0.0};
+    struct hpod_vector3_s movement_b = {0.5, -1.0, 0.0};
+    std::vector<struct hpod_gait_slice_s> shape_a, shape_b;
+    struct hpod_gait_table_s table_a, table_b;
+};
+
+TEST_F(GaitBlendTest, SteadyMatchesTable)
+{
+    struct hpod_gait_blend_s blend;
+    HPOD_gait_blend_init(&blend, &table_a, 0.0f);
+
+    for (int i = 0; i < 100; i++) {
+        float phase = -1.0f + 2.0f * i / 100;
+        struct hpod_vector3_s expected, actual;
+
+        ASSERT_EQ(0, HPOD_gait_blend_update(&blend, phase));
+        HPOD_gait_table_calc(&table_a, phase, HPOD_INTERP_LINEAR, &expected);
+        HPOD_gait_blend_calc(&blend, phase, HPOD_INTERP_LINEAR, &actual);
+
+        ASSERT_EQ(expected.x, actual.x);
+        ASSERT_EQ(expected.y, actual.y);
+        ASSERT_EQ(expected.z, actual.z);
+    }
+}
+
+TEST_F(GaitBlendTest, CompletesAfterCycles)
+{
+    struct hpod_gait_blend_s blend;
+    HPOD_gait_blend_init(&blend, &table_a, 0.0f);
+    ASSERT_EQ(0, HPOD_gait_blend_start(&blend, &table_b, 1.5f));
+
+    // Only two gaits may be held at once
+    ASSERT_EQ(-1, HPOD_gait_blend_start(&blend, &table_a, 1.0f));
+
+    // 1.5 cycles is 3 units of phase, crossing the wrap
+    float weight = 0;
+    float phase = 0;
+    int steps = 0;
+    do {
+        ASSERT_GE(blend.weight, weight);
+        weight = blend.weight;
+        phase += 0.01f;
+        phase = phase - 2.0f * floorf((phase + 1.0f) / 2.0f);
+        steps++;
+    } while (HPOD_gait_blend_update(&blend, phase));
+    ASSERT_NEAR(300, steps, 1);
+    ASSERT_EQ(&table_b, blend.from);
+
+    // Once steady the blend follows the target table
+    struct hpod_vector3_s expected, actual;
+    HPOD_gait_table_calc(&table_b, 0.3f, HPOD_INTERP_LINEAR, &expected);
+    HPOD_gait_blend_calc(&blend, 0.3f, HPOD_INTERP_LINEAR, &actual);
+    ASSERT_NEAR(expected.x, actual.x, FLOAT_ERROR);
+    ASSERT_NEAR(expected.y, actual.y, FLOAT_ERROR);
+
+    // Zero length transitions switch immediately
+    ASSERT_EQ(0, HPOD_gait_blend_start(&blend, &table_a, 0.0f));
+    ASSERT_EQ(&table_a, blend.from);
+}
+
+TEST_F(GaitBlendTest, BoundedJerk)
+{
+    const int steps = 8 * 2 * 256;
+    const int start = 2 * 256 + 77;
+
+    // Reference jerk of each gait walking steadily
+    std::vector<struct hpod_vector3_s> steady_a = walk(steps, steps, 2.0f);
+    std::vector<struct hpod_vector3_s> steady_b = walk(steps, 0, 0.0f);
+    float reference = fmaxf(max_jerk(steady_a), max_jerk(steady_b));
+
+    // Blending over two cycles stays within the steady state jerk
+    std::vector<struct hpod_vector3_s> blended = walk(steps, start, 2.0f);
+    float blend_jerk = max_jerk(blended);
+    ASSERT_LE(blend_jerk, reference * 1.1f);
+
+    // Whereas switching mid stride does not
+    std::vector<struct hpod_vector3_s> switched = walk(steps, start, 0.0f);
+    ASSERT_GT(max_jerk(switched), reference * 10.0f);
+
+    // The blend begins on gait a and ends on gait b
+    ASSERT_NEAR(steady_a[start].x, blended[start].x, FLOAT_ERROR);
+    ASSERT_NEAR(steady_b[steps - 1].x, blended[steps - 1].x, FLOAT_ERROR);
+    ASSERT_NEAR(steady_b[steps - 1].y, blended[steps - 1].y, FLOAT_ERROR);
+}
+
+TEST_F(GaitBlendTest, ValidThroughout)
+{
+    ASSERT_EQ(0, HPOD_gait_valid(&hexy, &gait_a));
+    ASSERT_EQ(0, HPOD_gait_valid(&hexy, &gait_b));
+
+    struct hpod_gait_blend_s blend;
+    HPOD_gait_blend_init(&blend, &table_a, 0.0f);
+    HPOD_gait_blend_start(&blend, &table_b, 1.0f);
+
+    int steps = 0;
+    float phase = 0.0f;
+    while (HPOD_gait_blend_update(&blend, phase)) {
+        for (int i = 0; i < 6; i++) {
+            struct hpod_vector3_s pos;
+            float alpha, beta, theta;
+
+            HPOD_gait_blend_calc(&blend, HPOD_gait_pattern_phase(&gait_a.pattern, phase, i), HPOD_INTERP_CUBIC, &pos);
+            ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+        }
+
+        phase += BLEND_STEP;
+        phase = phase - 2.0f * floorf((phase + 1.0f) / 2.0f);
+        steps++;
+    }
+    ASSERT_GT(steps, 500);
+}
@@ -0,0 +1,247 @@
+/**
+ * Libhexapod
+ * Hexapod Gait Pattern Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+#include "hexapod/gait_pattern.hpp"
+
+#define FLOAT_ERROR         0.0001
+#define PATTERN_SLICES      240
+
+// Schedules fold to constants
+static_assert(hpod::Tripod::offset(1) == 1.0f, "tripod offset");
+static_assert(hpod::Wave::duty() == 5.0f / 6, "wave duty");
+
+class GaitPatternTest : public ::testing::Test
+{
+protected:
+    GaitPatternTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+    }
+
+    virtual ~GaitPatternTest()
+    {
+    }
+
+    void expect_pattern(const struct hpod_gait_pattern_s& expected, const struct hpod_gait_pattern_s& actual)
+    {
+        for (int i = 0; i < 6; i++) {
+            ASSERT_FLOAT_EQ(expected.offset[i], actual.offset[i]);
+        }
+        ASSERT_FLOAT_EQ(expected.duty, actual.duty);
+    }
+
+    template <typename Schedule>
+    void expect_schedule(const struct hpod_gait_pattern_s& pattern)
+    {
+        expect_pattern(pattern, Schedule::pattern());
+
+        for (int s = 0; s < PATTERN_SLICES; s++) {
+            float phase = 2.0f * s / PATTERN_SLICES - 1.0f;
+            std::array<float, 6> phases = Schedule::phases(phase);
+            for (int i = 0; i < 6; i++) {
+                ASSERT_NEAR(HPOD_gait_pattern_phase(&pattern, phase, i), phases[i], FLOAT_ERROR);
+            }
+        }
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+};
+
+TEST_F(GaitPatternTest, DefaultIsTripod)
+{
+    expect_pattern(hpod_gait_patterns[HPOD_PATTERN_TRIPOD], gait.pattern);
+}
+
+TEST_F(GaitPatternTest, SchedulesMatchTable)
+{
+    expect_schedule<hpod::Tripod>(hpod_gait_patterns[HPOD_PATTERN_TRIPOD]);
+    expect_schedule<hpod::Ripple>(hpod_gait_patterns[HPOD_PATTERN_RIPPLE]);
+    expect_schedule<hpod::Wave>(hpod_gait_patterns[HPOD_PATTERN_WAVE]);
+
+    struct hpod_gait_pattern_s custom;
+    ASSERT_EQ(0, HPOD_gait_pattern_init(&custom, HPOD_PATTERN_WAVE, 11.0f / 12));
+    expect_schedule<hpod::WaveDuty<12, 11>>(custom);
+    ASSERT_EQ(0, HPOD_gait_pattern_init(&custom, HPOD_PATTERN_TRIPOD, 0.75f));
+    expect_schedule<hpod::TripodDuty<4, 3>>(custom);
+}
+
+TEST_F(GaitPatternTest, ContactFollowsDuty)
+{
+    int min_contacts[HPOD_PATTERN_COUNT] = {3, 4, 5};
+
+    for (int p = 0; p < HPOD_PATTERN_COUNT; p++) {
+        const struct hpod_gait_pattern_s* pattern = &hpod_gait_patterns[p];
+        int leg_contacts[6] = {0};
+
+        for (int s = 0; s < PATTERN_SLICES; s++) {
+            float phase = 2.0f * s / PATTERN_SLICES - 1.0f + 0.001f;
+            uint8_t contact[6];
+            ASSERT_EQ(min_contacts[p], HPOD_gait_pattern_contacts(pattern, phase, 6, contact));
+
+            for (int i = 0; i < 6; i++) {
+                leg_contacts[i] += contact[i];
+
+                // Contact maps onto the contact half of the gait
+                float leg_phase = HPOD_gait_pattern_phase(pattern, phase, i);
+                ASSERT_EQ(contact[i], fabsf(leg_phase) <= 0.5f);
+            }
+        }
+
+        for (int i = 0; i < 6; i++) {
+            ASSERT_NEAR(pattern->duty * PATTERN_SLICES, leg_contacts[i], 1);
+        }
+    }
+}
+
+TEST_F(GaitPatternTest, DutyLimits)
+{
+    struct hpod_gait_pattern_s pattern = hpod_gait_patterns[HPOD_PATTERN_RIPPLE];
+
+    // Invalid duty factors are rejected without modifying the pattern
+    ASSERT_EQ(-1, HPOD_gait_pattern_init(&pattern, HPOD_PATTERN_TRIPOD, 0.0f));
+    ASSERT_EQ(-1, HPOD_gait_pattern_init(&pattern, HPOD_PATTERN_TRIPOD, 1.0f));
+    ASSERT_EQ(-1, HPOD_gait_pattern_init(&pattern, HPOD_PATTERN_TRIPOD, NAN));
+    ASSERT_EQ(-1, HPOD_gait_pattern_init(&pattern, HPOD_PATTERN_COUNT, 0.5f));
+    expect_pattern(hpod_gait_patterns[HPOD_PATTERN_RIPPLE], pattern);
+
+    // Patterns written directly are limited, so phases stay defined and legs still step
+    for (float duty : {-0.5f, 0.0f, 1.0f, 1.5f}) {
+        pattern.duty = duty;
+        int contacts = 0;
+
+        for (int s = 0; s <= PATTERN_SLICES; s++) {
+            float phase_scl = 2.0f * s / PATTERN_SLICES - 1.0f;
+            uint8_t contact[6];
+
+            for (int i = 0; i < 6; i++) {
+                float phase = HPOD_gait_pattern_phase(&pattern, phase_scl, i);
+                ASSERT_FALSE(isnan(phase)) << "duty " << duty;
+                ASSERT_LE(fabs(phase), 1.0f);
+            }
+            contacts += HPOD_gait_pattern_contacts(&pattern, phase_scl, 6, contact);
+        }
+
+        ASSERT_GT(contacts, 0) << "duty " << duty;
+        ASSERT_LT(contacts, 6 * (PATTERN_SLICES + 1)) << "duty " << duty;
+    }
+}
+
+TEST_F(GaitPatternTest, PhaseWarpIsContinuous)
+{
+    const struct hpod_gait_pattern_s* pattern = &hpod_gait_patterns[HPOD_PATTERN_RIPPLE];
+
+    for (int i = 0; i < 6; i++) {
+        float last = HPOD_gait_pattern_phase(pattern, -1.0f, i);
+        int wraps = 0;
+
+        for (int s = 1; s <= PATTERN_SLICES; s++) {
+            float phase = HPOD_gait_pattern_phase(pattern, 2.0f * s / PATTERN_SLICES - 1.0f, i);
+            float delta = phase - last;
+            if (delta < -1.0f) {
+                delta += 2.0f;
+                wraps++;
+            }
+
+            // Contact is stretched by 1 / (2 * duty), swing compressed by 1 / (2 * (1 - duty))
+            ASSERT_GT(delta, 0.0f);
+            ASSERT_LT(delta, 2.0f / PATTERN_SLICES * 0.5f / (1.0f - pattern->duty) + FLOAT_ERROR);
+            last = phase;
+        }
+        ASSERT_EQ(1, wraps);
+    }
+}
+
+TEST_F(GaitPatternTest, TripodAlternates)
+{
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    float ground = -gait.movement.z / 2 + gait.offset.z;
+
+    // Exactly one tripod is on the ground at every phase outside the transitions
+    for (int s = 0; s < PATTERN_SLICES; s++) {
+        float phase = 2.0f * s / PATTERN_SLICES - 1.0f + 0.001f;
+        int down[2] = {0, 0};
+
+        for (int i = 0; i < 6; i++) {
+            struct hpod_vector3_s pos;
+            HPOD_gait_calc_leg(&hexy, &gait, &movement, HPOD_gait_pattern_phase(&gait.pattern, phase, i), i, &pos);
+            down[(int)gait.pattern.offset[i]] += fabsf(pos.z - ground) < FLOAT_ERROR;
+        }
+
+        ASSERT_EQ(3, down[0] + down[1]);
+        ASSERT_TRUE(down[0] == 0 || down[1] == 0);
+    }
+}
+
+TEST_F(GaitPatternTest, StabilityMargin)
+{
+    struct hpod_vector3_s still = {0.0, 0.0, 0.0};
+    struct hpod_vector3_s forward = {0.0, 0.5, 0.0};
+    float margins[HPOD_PATTERN_COUNT];
+
+    for (int p = 0; p < HPOD_PATTERN_COUNT; p++) {
+        gait.pattern = hpod_gait_patterns[p];
+
+        // Stepping in place is stable for every pattern
+        ASSERT_GT(HPOD_gait_stability(&hexy, &gait, &still, PATTERN_SLICES, NULL), 0.0f);
+
+        margins[p] = HPOD_gait_stability(&hexy, &gait, &forward, PATTERN_SLICES, NULL);
+    }
+
+    // More legs on the ground gives a larger margin (for strides within the leg spacing)
+    ASSERT_LT(margins[HPOD_PATTERN_TRIPOD], margins[HPOD_PATTERN_RIPPLE]);
+    ASSERT_LT(margins[HPOD_PATTERN_RIPPLE], margins[HPOD_PATTERN_WAVE]);
+
+    // The C++ schedule evaluates the same margin
+    float min_phase = NAN;
+    gait.pattern = hpod_gait_patterns[HPOD_PATTERN_TRIPOD];
+    float tripod = HPOD_gait_stability(&hexy, &gait, &still, PATTERN_SLICES, &min_phase);
+    ASSERT_FALSE(isnan(min_phase));
+    ASSERT_NEAR(tripod, hpod::Tripod::stability(&hexy, gait, &still, PATTERN_SLICES), FLOAT_ERROR);
+
+    // Raising the duty factor trades speed for margin
+    HPOD_gait_pattern_init(&gait.pattern, HPOD_PATTERN_TRIPOD, 0.75f);
+    ASSERT_GT(HPOD_gait_stability(&hexy, &gait, &forward, PATTERN_SLICES, NULL), margins[HPOD_PATTERN_TRIPOD]);
+}
+
+TEST_F(GaitPatternTest, StabilityLegLayout)
+{
+    // Octopod on a rectangular body, alternating zig-zag groups of four
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hpod_gait_pattern_s alternating = {{0.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0}, 0.5};
+    struct hpod_vector3_s forward = {0.0, 0.5, 0.0};
+    uint8_t contact[HPOD_MAX_LEGS];
+
+    config.legs = 8;
+    for (int i = 0; i < 8; i++) {
+        config.leg[i].x = (i % 2) ? 50.0f : -50.0f;
+        config.leg[i].y = 150.0f - 100.0f * (i / 2);
+    }
+    HPOD_init(&hexy, &config);
+    gait.pattern = alternating;
+
+    for (int i = 0; i < PATTERN_SLICES; i++) {
+        float phase = (2.0f * i + 1.0f) / PATTERN_SLICES - 1.0f;
+        ASSERT_EQ(4, HPOD_gait_pattern_contacts(&gait.pattern, phase, 8, contact));
+    }
+
+    ASSERT_GT(HPOD_gait_stability(&hexy, &gait, &forward, PATTERN_SLICES, NULL), 0.0f);
+
+    // The same groups on the first six legs lose the rear pair
+    config.legs = 6;
+    HPOD_init(&hexy, &config);
+    ASSERT_LT(HPOD_gait_stability(&hexy, &gait, &forward, PATTERN_SLICES, NULL), 0.0f);
+}
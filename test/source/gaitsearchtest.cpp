@@ -0,0 +1,209 @@
+/**
+ * Libhexapod
+ * Hexapod Gait Search Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_search.h"
+
+#define CHECK_SLICES    64
+
+class GaitSearchTest : public ::testing::Test
+{
+protected:
+    GaitSearchTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+    }
+
+    virtual ~GaitSearchTest()
+    {
+
+    }
+
+    // Grid around the default gait, with both feasible and infeasible candidates
+    void default_grid(struct hpod_gait_grid_s* grid)
+    {
+        struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+        grid->min = gait;
+        grid->max = gait;
+        grid->min.movement.x = 50;  grid->max.movement.x = 250;
+        grid->min.movement.y = 100; grid->max.movement.y = 400;
+        grid->min.offset.z = -120;  grid->max.offset.z = -20;
+        int steps[HPOD_GAIT_PARAMS] = {5, 7, 1, 1, 1, 6, 1, 1};
+        for (int i = 0; i < HPOD_GAIT_PARAMS; i++) {
+            grid->steps[i] = steps[i];
+        }
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_vector3_s movements[2] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}};
+};
+
+TEST_F(GaitSearchTest, InvalidGait)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    gait.movement.x = 1000;
+
+    // Failures on the first movement were previously reported as valid
+    ASSERT_EQ(-1, HPOD_gait_valid(&hexy, &gait));
+}
+
+TEST_F(GaitSearchTest, ReportsFirstFailingPhase)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_gait_check_s result;
+    gait.movement.y = 500;
+
+    ASSERT_EQ(-1, HPOD_gait_check(&hexy, &gait, movements, 2, CHECK_SLICES, NULL, &result));
+    ASSERT_EQ(0, result.feasible);
+    ASSERT_EQ(1, result.fail_movement);
+    ASSERT_FALSE(isnan(result.fail_phase));
+    ASSERT_LT(result.reach_margin, 0.0f);
+
+    // The failing phase is unsolvable, the slice before it is not
+    struct hpod_vector3_s pos;
+    float a, b, t;
+    HPOD_gait_calc(&hexy, &gait, &movements[1], result.fail_phase, &pos);
+    ASSERT_EQ(-1, HPOD_leg_ik3(&hexy, &pos, &a, &b, &t));
+
+    HPOD_gait_calc(&hexy, &gait, &movements[1], result.fail_phase - 2.0f / CHECK_SLICES, &pos);
+    ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &a, &b, &t));
+}
+
+TEST_F(GaitSearchTest, ReportsFailingLeg)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_gait_check_s result;
+    struct hpod_vector3_s turn[2] = {{0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+
+    // Without rotation a single leg is checked
+    ASSERT_EQ(0, HPOD_gait_check(&hexy, &gait, turn, 1, CHECK_SLICES, NULL, &result));
+    ASSERT_EQ(-1, result.fail_leg);
+    ASSERT_EQ(CHECK_SLICES, result.slices_checked);
+
+    // Rotation checks every leg, corner legs sweep furthest
+    ASSERT_EQ(0, HPOD_gait_check(&hexy, &gait, turn, 2, CHECK_SLICES, NULL, &result));
+    ASSERT_EQ(7 * CHECK_SLICES, result.slices_checked);
+
+    // Excessive rotation sweeps theta beyond the limits that forward walking fits within
+    struct hpod_joint_limits_s limits = {{-M_PI, -M_PI, -1.0}, {M_PI, M_PI, 1.0}};
+    ASSERT_EQ(0, HPOD_gait_check(&hexy, &gait, turn, 2, CHECK_SLICES, &limits, &result));
+
+    gait.yaw = 2.0;
+    ASSERT_EQ(-1, HPOD_gait_check(&hexy, &gait, turn, 2, CHECK_SLICES, &limits, &result));
+    ASSERT_EQ(1, result.fail_movement);
+    ASSERT_NE(-1, result.fail_leg);
+    ASSERT_LT(result.joint_margin[2], 0.0f);
+}
+
+TEST_F(GaitSearchTest, MountYawChecksEveryLeg)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_gait_check_s result;
+    struct hpod_vector3_s forward = {0.0, 1.0, 0.0};
+
+    // Corner legs splayed outwards, with the shared links
+    config.legs = 6;
+    for (int i = 0; i < 6; i++) {
+        config.leg[i].x = leg_offsets[i].x * config.width / 2;
+        config.leg[i].y = leg_offsets[i].y * config.length / 2;
+        config.leg[i].yaw = leg_offsets[i].y * M_PI / 6;
+    }
+    HPOD_init(&hexy, &config);
+    ASSERT_EQ(1, hexy.uniform);
+    ASSERT_EQ(0, hexy.aligned);
+
+    // Strides differ in each leg frame, so a single leg does not represent the others
+    ASSERT_EQ(0, HPOD_gait_check(&hexy, &gait, &forward, 1, CHECK_SLICES, NULL, &result));
+    ASSERT_EQ(6 * CHECK_SLICES, result.slices_checked);
+}
+
+TEST_F(GaitSearchTest, JointLimits)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_gait_check_s result;
+
+    struct hpod_joint_limits_s limits = {{-M_PI, -M_PI, -M_PI}, {M_PI, M_PI, M_PI}};
+    ASSERT_EQ(0, HPOD_gait_check(&hexy, &gait, movements, 2, CHECK_SLICES, &limits, &result));
+    ASSERT_EQ(1, result.feasible);
+    ASSERT_EQ(2 * CHECK_SLICES, result.slices_checked);
+    ASSERT_GT(result.reach_margin, 0.0f);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_GT(result.joint_margin[i], 0.0f);
+    }
+
+    // Forward walking sweeps theta, so a tight theta limit fails
+    limits.min[2] = -0.1f;
+    limits.max[2] = 0.1f;
+    ASSERT_EQ(-1, HPOD_gait_check(&hexy, &gait, movements, 2, CHECK_SLICES, &limits, &result));
+    ASSERT_EQ(1, result.fail_movement);
+    ASSERT_LT(result.joint_margin[2], 0.0f);
+}
+
+TEST_F(GaitSearchTest, Grid)
+{
+    struct hpod_gait_grid_s grid;
+    default_grid(&grid);
+    ASSERT_EQ(5 * 7 * 6, HPOD_gait_grid_size(&grid));
+
+    struct hpod_gait_s gait;
+    HPOD_gait_grid_get(&grid, 0, &gait);
+    ASSERT_FLOAT_EQ(grid.min.movement.x, gait.movement.x);
+    ASSERT_FLOAT_EQ(grid.min.offset.z, gait.offset.z);
+
+    HPOD_gait_grid_get(&grid, HPOD_gait_grid_size(&grid) - 1, &gait);
+    ASSERT_FLOAT_EQ(grid.max.movement.x, gait.movement.x);
+    ASSERT_FLOAT_EQ(grid.max.movement.y, gait.movement.y);
+    ASSERT_FLOAT_EQ(grid.max.offset.z, gait.offset.z);
+    ASSERT_FLOAT_EQ(grid.min.height_scale, gait.height_scale);
+
+    // movement.x varies fastest
+    HPOD_gait_grid_get(&grid, 1, &gait);
+    ASSERT_FLOAT_EQ(100, gait.movement.x);
+    ASSERT_FLOAT_EQ(grid.min.movement.y, gait.movement.y);
+}
+
+TEST_F(GaitSearchTest, ParallelMatchesSerial)
+{
+    struct hpod_gait_grid_s grid;
+    default_grid(&grid);
+    int size = HPOD_gait_grid_size(&grid);
+
+    // Serial reference
+    std::vector<struct hpod_gait_check_s> expected(size);
+    int expected_feasible = 0;
+    for (int i = 0; i < size; i++) {
+        struct hpod_gait_s gait;
+        HPOD_gait_grid_get(&grid, i, &gait);
+        expected_feasible += (HPOD_gait_check(&hexy, &gait, movements, 2, CHECK_SLICES, NULL, &expected[i]) == 0);
+    }
+    ASSERT_GT(expected_feasible, 0);
+    ASSERT_LT(expected_feasible, size);
+
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        struct hpod_gait_search_s search = {&hexy, &grid, NULL, movements, 2, CHECK_SLICES, threads, 0};
+        std::vector<struct hpod_gait_check_s> results(size);
+
+        ASSERT_EQ(expected_feasible, HPOD_gait_search(&search, results.data()));
+
+        for (int i = 0; i < size; i++) {
+            ASSERT_EQ(expected[i].feasible, results[i].feasible);
+            ASSERT_EQ(expected[i].fail_movement, results[i].fail_movement);
+            ASSERT_EQ(expected[i].slices_checked, results[i].slices_checked);
+            ASSERT_FLOAT_EQ(expected[i].reach_margin, results[i].reach_margin);
+        }
+    }
+}
+
@@ -0,0 +1,197 @@
+/**
+ * Libhexapod
+ * Hexapod Gait Table Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_table.h"
+
+#define TABLE_SLICES    256
+#define CHECK_SAMPLES   10000
+#define FLOAT_ERROR     0.01
+
+class GaitTableTest : public ::testing::Test
+{
+protected:
+    GaitTableTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+    }
+
+    virtual ~GaitTableTest()
+    {
+
+    }
+
+    // Maximum position error of the table against HPOD_gait_calc over one cycle
+    float max_error(struct hpod_gait_table_s* table, enum hpod_interp_e interp)
+    {
+        float error = 0;
+
+        for (int i = 0; i < CHECK_SAMPLES; i++) {
+            float phase = -1.0f + 2.0f * i / CHECK_SAMPLES;
+            struct hpod_vector3_s expected, actual;
+
+            HPOD_gait_calc(&hexy, &gait, &movement, phase, &expected);
+            HPOD_gait_table_calc(table, phase, interp, &actual);
+
+            error = fmaxf(error, fabsf(expected.x - actual.x));
+            error = fmaxf(error, fabsf(expected.y - actual.y));
+            error = fmaxf(error, fabsf(expected.z - actual.z));
+        }
+
+        return error;
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+    struct hpod_gait_slice_s shape[TABLE_SLICES];
+    struct hpod_gait_angles_s angles[TABLE_SLICES];
+};
+
+TEST_F(GaitTableTest, InvalidArguments)
+{
+    struct hpod_gait_table_s table;
+    ASSERT_EQ(-1, HPOD_gait_table_init(&table, &hexy, &gait, &movement, 2, shape, NULL));
+    ASSERT_EQ(-1, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, NULL, NULL));
+}
+
+TEST_F(GaitTableTest, ExactAtSlices)
+{
+    struct hpod_gait_table_s table;
+    ASSERT_EQ(0, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, NULL));
+
+    for (int i = 0; i < TABLE_SLICES; i++) {
+        float phase = -1.0f + 2.0f * i / TABLE_SLICES;
+        struct hpod_vector3_s expected, actual;
+
+        HPOD_gait_calc(&hexy, &gait, &movement, phase, &expected);
+        HPOD_gait_table_calc(&table, phase, HPOD_INTERP_LINEAR, &actual);
+
+        ASSERT_NEAR(expected.x, actual.x, FLOAT_ERROR);
+        ASSERT_NEAR(expected.y, actual.y, FLOAT_ERROR);
+        ASSERT_NEAR(expected.z, actual.z, FLOAT_ERROR);
+    }
+}
+
+TEST_F(GaitTableTest, InterpolationAccuracy)
+{
+    struct hpod_gait_table_s table;
+    ASSERT_EQ(0, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, NULL));
+
+    float linear = max_error(&table, HPOD_INTERP_LINEAR);
+    float cubic = max_error(&table, HPOD_INTERP_CUBIC);
+
+    ASSERT_LT(linear, 0.1);
+    ASSERT_LT(cubic, 0.05);
+    ASSERT_LT(cubic, linear);
+}
+
+TEST_F(GaitTableTest, PhaseWraps)
+{
+    struct hpod_gait_table_s table;
+    ASSERT_EQ(0, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, NULL));
+
+    float phases[] = {-2.0f, -1.3f, 1.0f, 1.7f, 2.5f};
+    for (unsigned int i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        struct hpod_vector3_s expected, actual;
+
+        HPOD_gait_calc(&hexy, &gait, &movement, phases[i], &expected);
+        HPOD_gait_table_calc(&table, phases[i], HPOD_INTERP_CUBIC, &actual);
+
+        ASSERT_NEAR(expected.x, actual.x, 0.1);
+        ASSERT_NEAR(expected.y, actual.y, 0.1);
+        ASSERT_NEAR(expected.z, actual.z, 0.1);
+    }
+}
+
+TEST_F(GaitTableTest, SetMovement)
+{
+    struct hpod_gait_table_s table;
+    ASSERT_EQ(0, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, angles));
+
+    // Rescaling must match a table built from scratch
+    movement.x = -0.3f; movement.y = 0.6f;
+    ASSERT_EQ(0, HPOD_gait_table_set_movement(&table, &movement));
+    ASSERT_LT(max_error(&table, HPOD_INTERP_CUBIC), 0.05);
+
+    for (int i = 0; i < 100; i++) {
+        float phase = -1.0f + 2.0f * i / 100;
+        struct hpod_vector3_s pos;
+        float alpha, beta, theta, a, b, t;
+
+        HPOD_gait_calc(&hexy, &gait, &movement, phase, &pos);
+        ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &pos, &alpha, &beta, &theta));
+        ASSERT_EQ(0, HPOD_gait_table_angles(&table, phase, HPOD_INTERP_CUBIC, &a, &b, &t));
+
+        ASSERT_NEAR(alpha, a, FLOAT_ERROR);
+        ASSERT_NEAR(beta, b, FLOAT_ERROR);
+        ASSERT_NEAR(theta, t, FLOAT_ERROR);
+    }
+}
+
+TEST_F(GaitTableTest, AnglesDisabled)
+{
+    struct hpod_gait_table_s table;
+    float a, b, t;
+
+    ASSERT_EQ(0, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, NULL));
+    ASSERT_EQ(-1, HPOD_gait_table_angles(&table, 0.0f, HPOD_INTERP_LINEAR, &a, &b, &t));
+}
+
+
+TEST_F(GaitTableTest, LegLinks)
+{
+    // Eight swept legs with a longer foreleg on leg 5
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    config.legs = 8;
+    for (int i = 0; i < 8; i++) {
+        float angle = (67.5f - 45.0f * (i / 2)) * M_PI / 180;
+        config.leg[i].x = (i % 2 ? 100.0f : -100.0f) * cosf(angle);
+        config.leg[i].y = 100.0f * sinf(angle);
+        config.leg[i].yaw = angle;
+    }
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_gait_table_s table;
+    gait.movement = {60.0, 100.0, 20.0};
+    movement = {0.5, 1.0, 0.0};
+
+    // Shared angles are rejected once the legs differ, shapes alone are still valid
+    ASSERT_EQ(-1, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, angles));
+    ASSERT_EQ(0, HPOD_gait_table_init(&table, &hexy, &gait, &movement, TABLE_SLICES, shape, NULL));
+
+    ASSERT_EQ(0, HPOD_gait_table_init_n(&table, &hexy, 5, &gait, &movement, TABLE_SLICES, shape, angles));
+
+    // Leg tables follow the leg's stride and links
+    for (int i = 0; i < TABLE_SLICES; i++) {
+        float phase = -1.0f + 2.0f * i / TABLE_SLICES;
+        struct hpod_vector3_s expected, actual;
+        float alpha, beta, theta, a, b, t;
+
+        HPOD_gait_calc_leg(&hexy, &gait, &movement, phase, 5, &expected);
+        HPOD_gait_table_calc(&table, phase, HPOD_INTERP_LINEAR, &actual);
+
+        ASSERT_NEAR(expected.x, actual.x, FLOAT_ERROR);
+        ASSERT_NEAR(expected.y, actual.y, FLOAT_ERROR);
+        ASSERT_NEAR(expected.z, actual.z, FLOAT_ERROR);
+
+        ASSERT_EQ(0, HPOD_leg_ik3_n(&hexy, 5, &expected, &alpha, &beta, &theta));
+        ASSERT_EQ(0, HPOD_gait_table_angles(&table, phase, HPOD_INTERP_LINEAR, &a, &b, &t));
+
+        ASSERT_NEAR(alpha, a, FLOAT_ERROR);
+        ASSERT_NEAR(beta, b, FLOAT_ERROR);
+        ASSERT_NEAR(theta, t, FLOAT_ERROR);
+    }
+}
@@ -0,0 +1,322 @@
+/**
+ * Libhexapod
+ * Hexapod Jacobian Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/jacobian.h"
+
+#define SWEEP_SIZE      100
+#define DIFF_STEP       0.01f
+#define DIFF_ERROR      0.05
+
+class JacobianTest : public ::testing::Test
+{
+protected:
+    JacobianTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+    }
+
+    virtual ~JacobianTest()
+    {
+
+    }
+
+    // Joint angles spread across the working range of the leg, clear of singularities
+    static void sweep_angles(int i, float* alpha, float* beta, float* theta)
+    {
+        *alpha = M_PI / 6 * sinf(i * 0.1f);
+        *beta = 2 * M_PI / 3 + M_PI / 6 * sinf(i * 0.13f);
+        *theta = M_PI / 4 * cosf(i * 0.07f);
+    }
+
+    struct hexapod_s hexy;
+};
+
+TEST_F(JacobianTest, MatchesFiniteDifferences)
+{
+    for (int i = 0; i < SWEEP_SIZE; i++) {
+        float q[3];
+        sweep_angles(i, &q[0], &q[1], &q[2]);
+
+        float jacobian[3][3];
+        HPOD_leg_jacobian(&hexy, q[0], q[1], q[2], jacobian);
+
+        // Central differences of forward kinematics for each joint
+        for (int j = 0; j < 3; j++) {
+            float qp[3] = {q[0], q[1], q[2]};
+            float qn[3] = {q[0], q[1], q[2]};
+            qp[j] += DIFF_STEP;
+            qn[j] -= DIFF_STEP;
+
+            struct hpod_vector3_s pp, pn;
+            HPOD_leg_fk3(&hexy, qp[0], qp[1], qp[2], &pp);
+            HPOD_leg_fk3(&hexy, qn[0], qn[1], qn[2], &pn);
+
+            ASSERT_NEAR((pp.x - pn.x) / (2 * DIFF_STEP), jacobian[0][j], DIFF_ERROR);
+            ASSERT_NEAR((pp.y - pn.y) / (2 * DIFF_STEP), jacobian[1][j], DIFF_ERROR);
+            ASSERT_NEAR((pp.z - pn.z) / (2 * DIFF_STEP), jacobian[2][j], DIFF_ERROR);
+        }
+    }
+}
+
+TEST_F(JacobianTest, VelocityInvertsJacobian)
+{
+    for (int i = 0; i < SWEEP_SIZE; i++) {
+        float q[3];
+        sweep_angles(i, &q[0], &q[1], &q[2]);
+
+        struct hpod_vector3_s velocity = {100.0f * cosf(i * 0.3f), 100.0f * sinf(i * 0.3f), 50.0f * sinf(i * 0.2f)};
+        float dq[3];
+
+        int res = HPOD_leg_ik3_velocity(&hexy, q[0], q[1], q[2], &velocity,
+                                        HPOD_JACOBIAN_DEFAULT_DAMPING, &dq[0], &dq[1], &dq[2]);
+        ASSERT_EQ(HPOD_VELOCITY_EXACT, res);
+
+        float jacobian[3][3];
+        HPOD_leg_jacobian(&hexy, q[0], q[1], q[2], jacobian);
+
+        float v[3] = {velocity.x, velocity.y, velocity.z};
+        for (int j = 0; j < 3; j++) {
+            float actual = jacobian[j][0] * dq[0] + jacobian[j][1] * dq[1] + jacobian[j][2] * dq[2];
+            ASSERT_NEAR(v[j], actual, 1e-3);
+        }
+    }
+}
+
+TEST_F(JacobianTest, IntegratedVelocityTracksPath)
+{
+    // Start from a known reachable position and trace a line at 1kHz
+    struct hpod_vector3_s start = {hexy.config.offset_a + hexy.config.len_bc, -20.0f, -30.0f};
+    struct hpod_vector3_s velocity = {-20.0f, 40.0f, 10.0f};
+    const float dt = 0.001f;
+    const int steps = 1000;
+
+    float q[3];
+    ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &start, &q[0], &q[1], &q[2]));
+
+    for (int i = 0; i < steps; i++) {
+        float dq[3];
+        HPOD_leg_ik3_velocity(&hexy, q[0], q[1], q[2], &velocity,
+                              HPOD_JACOBIAN_DEFAULT_DAMPING, &dq[0], &dq[1], &dq[2]);
+        q[0] += dq[0] * dt;
+        q[1] += dq[1] * dt;
+        q[2] += dq[2] * dt;
+    }
+
+    struct hpod_vector3_s actual;
+    HPOD_leg_fk3(&hexy, q[0], q[1], q[2], &actual);
+
+    ASSERT_NEAR(start.x + velocity.x * dt * steps, actual.x, 0.1);
+    ASSERT_NEAR(start.y + velocity.y * dt * steps, actual.y, 0.1);
+    ASSERT_NEAR(start.z + velocity.z * dt * steps, actual.z, 0.1);
+}
+
+TEST_F(JacobianTest, DampedNearSingularity)
+{
+    // Fully extended leg, where the planar Jacobian is singular
+    struct hpod_vector3_s velocity = {100.0f, 0.0f, 100.0f};
+    float dq[3];
+
+    int res = HPOD_leg_ik3_velocity(&hexy, 0.0f, M_PI, 0.0f, &velocity,
+                                    HPOD_JACOBIAN_DEFAULT_DAMPING, &dq[0], &dq[1], &dq[2]);
+    ASSERT_EQ(HPOD_VELOCITY_DAMPED, res);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_FALSE(isnan(dq[i]));
+        ASSERT_LT(fabsf(dq[i]), 10.0f);
+    }
+
+    // Tangential motion is still achievable and should be tracked
+    struct hpod_vector3_s lift = {0.0f, 0.0f, 100.0f};
+    HPOD_leg_ik3_velocity(&hexy, 0.0f, M_PI, 0.0f, &lift,
+                          HPOD_JACOBIAN_DEFAULT_DAMPING, &dq[0], &dq[1], &dq[2]);
+
+    float jacobian[3][3];
+    HPOD_leg_jacobian(&hexy, 0.0f, M_PI, 0.0f, jacobian);
+    float z = jacobian[2][0] * dq[0] + jacobian[2][1] * dq[1];
+    ASSERT_NEAR(lift.z, z, 1.0);
+}
+
+TEST_F(JacobianTest, WarmStartFollowsGait)
+{
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.5f, 1.0f, 0.0f};
+    struct hpod_ik_context_s ctx;
+    HPOD_ik_context_init(&ctx, HPOD_IK_DEFAULT_ITERATIONS, HPOD_IK_DEFAULT_TOLERANCE);
+
+    // One gait period at 1kHz with a one second period
+    for (int i = 0; i < 1000; i++) {
+        float phase = -1.0f + 2.0f * i / 1000;
+        struct hpod_vector3_s target, actual;
+        float alpha, beta, theta;
+
+        HPOD_gait_calc(&hexy, &gait, &movement, phase, &target);
+        ASSERT_EQ(0, HPOD_leg_ik3_warm(&hexy, &ctx, &target, &alpha, &beta, &theta));
+        ASSERT_LE(ctx.iterations, HPOD_IK_DEFAULT_ITERATIONS);
+
+        HPOD_leg_fk3(&hexy, alpha, beta, theta, &actual);
+        ASSERT_NEAR(target.x, actual.x, HPOD_IK_DEFAULT_TOLERANCE);
+        ASSERT_NEAR(target.y, actual.y, HPOD_IK_DEFAULT_TOLERANCE);
+        ASSERT_NEAR(target.z, actual.z, HPOD_IK_DEFAULT_TOLERANCE);
+    }
+
+    // Only the first (cold) solve should need the analytic IK
+    ASSERT_EQ(1000u, ctx.solves);
+    ASSERT_EQ(1u, ctx.fallbacks);
+}
+
+TEST_F(JacobianTest, WarmStartFallsBack)
+{
+    struct hpod_ik_context_s ctx;
+    HPOD_ik_context_init(&ctx, HPOD_IK_DEFAULT_ITERATIONS, HPOD_IK_DEFAULT_TOLERANCE);
+
+    struct hpod_vector3_s near = {hexy.config.offset_a + hexy.config.len_bc, 0.0f, -30.0f};
+    struct hpod_vector3_s far = {0.0f, hexy.config.offset_a + hexy.config.len_bc, 30.0f};
+    struct hpod_vector3_s out = {hexy.config.offset_a + hexy.kinematics.reach_max + 10.0f, 0.0f, 0.0f};
+    float alpha, beta, theta, a, b, t;
+
+    ASSERT_EQ(0, HPOD_leg_ik3_warm(&hexy, &ctx, &near, &alpha, &beta, &theta));
+    ASSERT_EQ(1u, ctx.fallbacks);
+
+    // Large jumps exceed the step limit and use the analytic solution
+    ASSERT_EQ(0, HPOD_leg_ik3_warm(&hexy, &ctx, &far, &alpha, &beta, &theta));
+    ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &far, &a, &b, &t));
+    ASSERT_NEAR(a, alpha, 1e-3);
+    ASSERT_NEAR(b, beta, 1e-3);
+    ASSERT_NEAR(t, theta, 1e-3);
+
+    // Unreachable targets fail as the analytic IK does, and invalidate the warm start
+    ASSERT_EQ(-1, HPOD_leg_ik3_warm(&hexy, &ctx, &out, &alpha, &beta, &theta));
+    ASSERT_TRUE(isnan(alpha));
+    ASSERT_EQ(0, ctx.valid);
+
+    uint32_t fallbacks = ctx.fallbacks;
+    ASSERT_EQ(0, HPOD_leg_ik3_warm(&hexy, &ctx, &near, &alpha, &beta, &theta));
+    ASSERT_EQ(0, ctx.iterations);
+    ASSERT_EQ(fallbacks + 1, ctx.fallbacks);
+}
+
+TEST_F(JacobianTest, WarmStartNearFullExtension)
+{
+    struct hpod_ik_context_s ctx;
+    HPOD_ik_context_init(&ctx, HPOD_IK_DEFAULT_ITERATIONS, HPOD_IK_DEFAULT_TOLERANCE);
+    float reach = hexy.kinematics.reach_max;
+
+    // Straighten the leg towards full extension in small steps, where Newton converges slowly
+    for (int i = 0; i <= SWEEP_SIZE; i++) {
+        float len_ac = reach - 2.0f + 2.0f * i / SWEEP_SIZE;
+        struct hpod_vector3_s target = {hexy.config.offset_a + len_ac * cosf(0.3f), 0.0f, -len_ac * sinf(0.3f)};
+        struct hpod_vector3_s actual;
+        float alpha, beta, theta, a, b, t;
+
+        int res = HPOD_leg_ik3_warm(&hexy, &ctx, &target, &alpha, &beta, &theta);
+        ASSERT_EQ(HPOD_leg_ik3(&hexy, &target, &a, &b, &t), res);
+        if (res < 0) {
+            continue;
+        }
+
+        HPOD_leg_fk3(&hexy, alpha, beta, theta, &actual);
+        ASSERT_NEAR(target.x, actual.x, HPOD_IK_DEFAULT_TOLERANCE);
+        ASSERT_NEAR(target.y, actual.y, HPOD_IK_DEFAULT_TOLERANCE);
+        ASSERT_NEAR(target.z, actual.z, HPOD_IK_DEFAULT_TOLERANCE);
+    }
+
+    // Just outside the envelope fails as the analytic IK does, even within tolerance
+    float len_ac = reach + HPOD_IK_DEFAULT_TOLERANCE / 2;
+    struct hpod_vector3_s out = {hexy.config.offset_a + len_ac * cosf(0.3f), 0.0f, -len_ac * sinf(0.3f)};
+    float alpha, beta, theta;
+    ASSERT_EQ(-1, HPOD_leg_ik3_warm(&hexy, &ctx, &out, &alpha, &beta, &theta));
+}
+
+TEST_F(JacobianTest, LegLinks)
+{
+    // Eight swept legs with a longer foreleg on leg 5
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    config.legs = 8;
+    for (int i = 0; i < 8; i++) {
+        float angle = (67.5f - 45.0f * (i / 2)) * M_PI / 180;
+        config.leg[i].x = (i % 2 ? 100.0f : -100.0f) * cosf(angle);
+        config.leg[i].y = 100.0f * sinf(angle);
+        config.leg[i].yaw = angle;
+    }
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+
+    struct hpod_vector3_s velocity = {10.0f, -20.0f, 5.0f};
+    struct hpod_vector3_s near = {hexy.config.offset_a + hexy.config.len_bc, 0.0f, -30.0f};
+    float alpha, beta, theta;
+
+    // Shared links are rejected once the legs differ
+    struct hpod_ik_context_s shared;
+    HPOD_ik_context_init(&shared, HPOD_IK_DEFAULT_ITERATIONS, HPOD_IK_DEFAULT_TOLERANCE);
+    ASSERT_EQ(-1, HPOD_leg_ik3_velocity(&hexy, 0.1f, 2.0f, 0.2f, &velocity, 0.0f, &alpha, &beta, &theta));
+    ASSERT_EQ(-1, HPOD_leg_ik3_warm(&hexy, &shared, &near, &alpha, &beta, &theta));
+    ASSERT_TRUE(isnan(alpha));
+
+    // The per leg Jacobian and velocity IK follow the leg's own FK
+    for (int i = 0; i < SWEEP_SIZE; i++) {
+        float q[3];
+        sweep_angles(i, &q[0], &q[1], &q[2]);
+
+        float jacobian[3][3];
+        HPOD_leg_jacobian_n(&hexy, 5, q[0], q[1], q[2], jacobian);
+
+        for (int j = 0; j < 3; j++) {
+            float qp[3] = {q[0], q[1], q[2]};
+            float qn[3] = {q[0], q[1], q[2]};
+            qp[j] += DIFF_STEP;
+            qn[j] -= DIFF_STEP;
+
+            struct hpod_vector3_s pp, pn;
+            HPOD_leg_fk3_n(&hexy, 5, qp[0], qp[1], qp[2], &pp);
+            HPOD_leg_fk3_n(&hexy, 5, qn[0], qn[1], qn[2], &pn);
+
+            ASSERT_NEAR((pp.x - pn.x) / (2 * DIFF_STEP), jacobian[0][j], DIFF_ERROR);
+            ASSERT_NEAR((pp.y - pn.y) / (2 * DIFF_STEP), jacobian[1][j], DIFF_ERROR);
+            ASSERT_NEAR((pp.z - pn.z) / (2 * DIFF_STEP), jacobian[2][j], DIFF_ERROR);
+        }
+
+        float dq[3];
+        int res = HPOD_leg_ik3_velocity_n(&hexy, 5, q[0], q[1], q[2], &velocity,
+                                          HPOD_JACOBIAN_DEFAULT_DAMPING, &dq[0], &dq[1], &dq[2]);
+        ASSERT_EQ(HPOD_VELOCITY_EXACT, res);
+
+        float v[3] = {velocity.x, velocity.y, velocity.z};
+        for (int j = 0; j < 3; j++) {
+            float actual = jacobian[j][0] * dq[0] + jacobian[j][1] * dq[1] + jacobian[j][2] * dq[2];
+            ASSERT_NEAR(v[j], actual, 1e-3);
+        }
+    }
+
+    // Warm starts for the leg track its gait with its own links
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_vector3_s movement = {0.0f, 1.0f, 0.0f};
+    struct hpod_ik_context_s ctx;
+    gait.movement = {60.0, 100.0, 20.0};
+    HPOD_ik_context_init_n(&ctx, 5, HPOD_IK_DEFAULT_ITERATIONS, HPOD_IK_DEFAULT_TOLERANCE);
+
+    for (int i = 0; i < 1000; i++) {
+        float phase = -1.0f + 2.0f * i / 1000;
+        struct hpod_vector3_s target, actual;
+
+        HPOD_gait_calc_leg(&hexy, &gait, &movement, phase, 5, &target);
+        ASSERT_EQ(0, HPOD_leg_ik3_warm(&hexy, &ctx, &target, &alpha, &beta, &theta));
+
+        HPOD_leg_fk3_n(&hexy, 5, alpha, beta, theta, &actual);
+        ASSERT_NEAR(target.x, actual.x, HPOD_IK_DEFAULT_TOLERANCE);
+        ASSERT_NEAR(target.y, actual.y, HPOD_IK_DEFAULT_TOLERANCE);
+        ASSERT_NEAR(target.z, actual.z, HPOD_IK_DEFAULT_TOLERANCE);
+    }
+    ASSERT_EQ(1u, ctx.fallbacks);
+}
@@ -0,0 +1,167 @@
+/**
+ * Libhexapod
+ * Hexapod Pipeline Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/gait_pattern.h"
+#include "hexapod/servo.h"
+#include "hexapod/body_pose.h"
+#include "hexapod/pipeline.h"
+
+#define FLOAT_ERROR     0.01
+
+class PipelineTest : public ::testing::Test
+{
+protected:
+    PipelineTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+        HPOD_servo_init(&servo, 300.0 / 180.0 * M_PI, 1024, 512);
+    }
+
+    virtual ~PipelineTest()
+    {
+
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_servo_s servo;
+    struct hpod_gait_s gait = HPOD_DEFAULT_GAIT;
+    struct hpod_body_transform_s transform;
+    struct hpod_pipeline_scratch_s scratch;
+};
+
+TEST_F(PipelineTest, MatchesOutputMix)
+{
+    struct hpod_body_pose_s pose = HPOD_DEFAULT_BODY_POSE;
+    struct hpod_vector3_s movement = {0.5, 1.0, 0.0};
+
+    // The default pose leaves the gait unchanged
+    HPOD_body_pose_init(&transform, &pose);
+
+    for (int p = 0; p < 100; p++) {
+        float phase = -1.0f + 2.0f * p / 100;
+        float angles[6][3];
+        int expected[6][3], out[6][3];
+
+        HPOD_output_mix(&hexy, &gait, &movement, phase, angles);
+        HPOD_servo_mix(&servo, hexy.legs, angles, expected);
+
+        ASSERT_EQ(0, HPOD_pipeline(&hexy, &gait, &servo, &transform, &movement, phase, &scratch, out));
+
+        for (int i = 0; i < 6; i++) {
+            ASSERT_EQ(1, scratch.valid[i]);
+            ASSERT_NEAR(scratch.gait_pos[i].x, scratch.joint_pos[i].x, FLOAT_ERROR);
+            ASSERT_NEAR(scratch.gait_pos[i].y, scratch.joint_pos[i].y, FLOAT_ERROR);
+            ASSERT_NEAR(scratch.gait_pos[i].z, scratch.joint_pos[i].z, FLOAT_ERROR);
+            for (int j = 0; j < 3; j++) {
+                ASSERT_NEAR(angles[i][j], scratch.angles[i][j], FLOAT_ERROR);
+                ASSERT_NEAR(expected[i][j], out[i][j], 1);
+            }
+        }
+    }
+}
+
+TEST_F(PipelineTest, MatchesBodyPose)
+{
+    struct hpod_body_pose_s pose = {{5.0, -10.0, 10.0}, M_PI / 32, -M_PI / 24, M_PI / 16};
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    struct hpod_vector3_s feet[6], joints[6];
+    float phase = 0.3;
+    int out[6][3];
+
+    HPOD_body_pose_init(&transform, &pose);
+    ASSERT_EQ(0, HPOD_pipeline(&hexy, &gait, &servo, &transform, &movement, phase, &scratch, out));
+
+    for (int i = 0; i < 6; i++) {
+        HPOD_gait_calc_leg(&hexy, &gait, &movement, HPOD_gait_pattern_phase(&gait.pattern, phase, i), i, &feet[i]);
+    }
+    HPOD_body_pose_apply(&hexy, &transform, feet, joints);
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_NEAR(joints[i].x, scratch.joint_pos[i].x, FLOAT_ERROR);
+        ASSERT_NEAR(joints[i].y, scratch.joint_pos[i].y, FLOAT_ERROR);
+        ASSERT_NEAR(joints[i].z, scratch.joint_pos[i].z, FLOAT_ERROR);
+
+        float a, b, t;
+        ASSERT_EQ(0, HPOD_leg_ik3(&hexy, &joints[i], &a, &b, &t));
+        ASSERT_NEAR(HPOD_servo_scale(&servo, a), out[i][0], 1);
+        ASSERT_NEAR(HPOD_servo_scale(&servo, b), out[i][1], 1);
+        ASSERT_NEAR(HPOD_servo_scale(&servo, t), out[i][2], 1);
+    }
+}
+
+TEST_F(PipelineTest, LegLayout)
+{
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    struct hpod_body_pose_s pose = HPOD_DEFAULT_BODY_POSE;
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    float angles[HPOD_MAX_LEGS][3];
+    int out[HPOD_MAX_LEGS][3];
+
+    // Octopod with swept mounts and one longer foreleg
+    config.legs = 8;
+    for (int i = 0; i < 8; i++) {
+        float angle = (67.5f - 45.0f * (i / 2)) * M_PI / 180;
+        config.leg[i].x = (i % 2 ? 100.0f : -100.0f) * cosf(angle);
+        config.leg[i].y = 100.0f * sinf(angle);
+        config.leg[i].yaw = angle;
+    }
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+    gait.movement = {60.0, 100.0, 20.0};
+    HPOD_body_pose_init(&transform, &pose);
+
+    for (int p = 0; p < 20; p++) {
+        float phase = -1.0f + 2.0f * p / 20;
+
+        HPOD_output_mix(&hexy, &gait, &movement, phase, angles);
+        ASSERT_EQ(0, HPOD_pipeline(&hexy, &gait, &servo, &transform, &movement, phase, &scratch, out));
+
+        for (int i = 0; i < 8; i++) {
+            ASSERT_EQ(1, scratch.valid[i]);
+            for (int j = 0; j < 3; j++) {
+                ASSERT_NEAR(angles[i][j], scratch.angles[i][j], FLOAT_ERROR);
+                ASSERT_EQ(HPOD_servo_scale(&servo, angles[i][j]), out[i][j]);
+            }
+        }
+    }
+
+    // Legs past the configured count are untouched
+    config.legs = 4;
+    HPOD_init(&hexy, &config);
+    memset(out, 0xFF, sizeof(out));
+    ASSERT_EQ(0, HPOD_pipeline(&hexy, &gait, &servo, &transform, &movement, 0.3, &scratch, out));
+    for (int i = 4; i < HPOD_MAX_LEGS; i++) {
+        ASSERT_EQ(-1, out[i][0]);
+    }
+}
+
+TEST_F(PipelineTest, UnreachableLegsHold)
+{
+    struct hpod_body_pose_s pose = {{0.0, 0.0, 1000.0}, 0.0, 0.0, 0.0};
+    struct hpod_vector3_s movement = {0.0, 1.0, 0.0};
+    int out[6][3];
+
+    HPOD_body_pose_init(&transform, &pose);
+    ASSERT_EQ(6, HPOD_pipeline(&hexy, &gait, &servo, &transform, &movement, 0.0, &scratch, out));
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQ(0, scratch.valid[i]);
+        for (int j = 0; j < 3; j++) {
+            ASSERT_EQ(servo.output_offset, out[i][j]);
+        }
+    }
+}
+
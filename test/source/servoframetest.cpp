@@ -0,0 +1,298 @@
+/**
+ * Libhexapod
+ * Servo Frame Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "hexapod/servo_frame.h"
+
+#define RANGE_RADS (300.0 / 180.0 * M_PI)
+#define LEGS        6
+#define CHANNELS    (LEGS * 3)
+
+// Capturing transport, records each write as a separate frame
+struct loopback_s {
+    uint8_t data[HPOD_SERVO_FRAME_MAX * 4];
+    int length;
+    int writes;
+};
+
+static int loopback_write(void *ctx, const uint8_t *data, int length)
+{
+    struct loopback_s *lb = (struct loopback_s *) ctx;
+    if (lb->length + length > (int) sizeof(lb->data)) {
+        return -1;
+    }
+    memcpy(&lb->data[lb->length], data, length);
+    lb->length += length;
+    lb->writes++;
+    return 0;
+}
+
+class ServoFrameTest : public ::testing::Test
+{
+protected:
+    ServoFrameTest()
+    {
+        HPOD_servo_init(&servo, RANGE_RADS, 1024, 512);
+        HPOD_servo_table_init(&table, &servo, LEGS);
+
+        for (int i = 0; i < HPOD_SERVO_CHANNELS; i++) {
+            ids[i] = i + 1;
+            counts[i / 3][i % 3] = 100 + i * 50;
+        }
+    }
+
+    virtual ~ServoFrameTest()
+    {
+    }
+
+    // Decode a Dynamixel sync write, returning the number of positions or -1 if malformed
+    int decode_dxl1(const uint8_t *data, int length, uint8_t *out_ids, int *out_counts)
+    {
+        if (length < 8 || data[0] != 0xFF || data[1] != 0xFF || data[2] != HPOD_DXL1_BROADCAST_ID) {
+            return -1;
+        }
+        if (data[3] + 4 != length || data[4] != HPOD_DXL1_SYNC_WRITE) {
+            return -1;
+        }
+
+        uint8_t sum = 0;
+        for (int i = 2; i < length - 1; i++) {
+            sum += data[i];
+        }
+        if ((uint8_t) ~sum != data[length - 1]) {
+            return -1;
+        }
+
+        int field = data[6] + 1;
+        int n = (length - 8) / field;
+        for (int i = 0; i < n; i++) {
+            const uint8_t *f = &data[7 + i * field];
+            out_ids[i] = f[0];
+            out_counts[i] = f[1] | (f[2] << 8);
+        }
+        return n;
+    }
+
+    struct hpod_servo_s servo;
+    struct hpod_servo_table_s table;
+    uint8_t ids[HPOD_SERVO_CHANNELS];
+    int counts[HPOD_MAX_LEGS][3];
+};
+
+TEST_F(ServoFrameTest, InitChecksBuffer)
+{
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+
+    ASSERT_EQ(-1, HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, LEGS, ids, 512, buffer,
+                                        HPOD_DXL1_FRAME_LENGTH(CHANNELS) - 1));
+    ASSERT_EQ(-1, HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_SSC32, LEGS, ids, 1500, buffer,
+                                        HPOD_SSC32_FRAME_LENGTH(CHANNELS) - 1));
+
+    ids[5] = HPOD_DXL1_BROADCAST_ID;
+    ASSERT_EQ(-1, HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, LEGS, ids, 512, buffer, sizeof(buffer)));
+
+    ids[5] = HPOD_SSC32_MAX_CHANNEL + 1;
+    ASSERT_EQ(-1, HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_SSC32, LEGS, ids, 1500, buffer, sizeof(buffer)));
+}
+
+TEST_F(ServoFrameTest, Dxl1SyncWrite)
+{
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+
+    int length = HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, LEGS, ids, 512, buffer, sizeof(buffer));
+    ASSERT_EQ(HPOD_DXL1_FRAME_LENGTH(CHANNELS), length);
+    ASSERT_EQ(HPOD_DXL1_GOAL_POSITION, buffer[5]);
+    ASSERT_EQ(2, buffer[6]);
+
+    uint8_t out_ids[HPOD_SERVO_CHANNELS];
+    int out_counts[HPOD_SERVO_CHANNELS];
+
+    ASSERT_EQ(CHANNELS, decode_dxl1(buffer, length, out_ids, out_counts));
+    for (int i = 0; i < CHANNELS; i++) {
+        ASSERT_EQ(ids[i], out_ids[i]);
+        ASSERT_EQ(512, out_counts[i]);
+    }
+
+    length = HPOD_servo_frame_encode(&frame, counts);
+    ASSERT_EQ(CHANNELS, decode_dxl1(buffer, length, out_ids, out_counts));
+    for (int i = 0; i < CHANNELS; i++) {
+        ASSERT_EQ(ids[i], out_ids[i]);
+        ASSERT_EQ(counts[i / 3][i % 3], out_counts[i]);
+    }
+
+    // Corrupted frames fail the checksum
+    buffer[10] ^= 0x01;
+    ASSERT_EQ(-1, decode_dxl1(buffer, length, out_ids, out_counts));
+}
+
+TEST_F(ServoFrameTest, Ssc32GroupMove)
+{
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+
+    int length = HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_SSC32, LEGS, ids, 1500, buffer, sizeof(buffer));
+    ASSERT_EQ(HPOD_SSC32_FRAME_LENGTH(CHANNELS), length);
+    ASSERT_EQ(0, memcmp("#01P1500#02P1500", buffer, 16));
+    ASSERT_EQ('\r', buffer[length - 1]);
+
+    counts[0][0] = 500;
+    counts[0][1] = 2500;
+    counts[0][2] = 12000;
+    counts[1][0] = -5;
+    length = HPOD_servo_frame_encode(&frame, counts);
+    ASSERT_EQ(0, memcmp("#01P0500#02P2500#03P9999#04P0000#05P", buffer, 36));
+}
+
+TEST_F(ServoFrameTest, TableEncodeMatchesMix)
+{
+    const enum hpod_servo_format_e formats[] = {HPOD_SERVO_FORMAT_DXL1, HPOD_SERVO_FORMAT_SSC32};
+
+    float in[6][3];
+    for (int i = 0; i < CHANNELS; i++) {
+        in[i / 3][i % 3] = -1.0f + 2.0f * i / CHANNELS;
+    }
+
+    int out[6][3];
+    HPOD_servo_table_center(&table, out);
+    HPOD_servo_table_mix(&table, in, out);
+
+    for (unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        struct hpod_servo_frame_s frame;
+        uint8_t expected[HPOD_SERVO_FRAME_MAX];
+        uint8_t actual[HPOD_SERVO_FRAME_MAX];
+
+        HPOD_servo_frame_init(&frame, formats[f], LEGS, ids, 512, expected, sizeof(expected));
+        int length = HPOD_servo_frame_encode(&frame, out);
+
+        HPOD_servo_frame_init(&frame, formats[f], LEGS, ids, 512, actual, sizeof(actual));
+        ASSERT_EQ(length, HPOD_servo_frame_encode_table(&frame, &table, in));
+        ASSERT_EQ(0, memcmp(expected, actual, length));
+
+        // Unsolved joints hold the previous frame
+        float solved = in[3][1];
+        in[3][1] = NAN;
+        ASSERT_EQ(length, HPOD_servo_frame_encode_table(&frame, &table, in));
+        ASSERT_EQ(0, memcmp(expected, actual, length));
+        in[3][1] = solved;
+    }
+}
+
+TEST_F(ServoFrameTest, EightLegs)
+{
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+
+    ASSERT_EQ(-1, HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, 0, ids, 512, buffer, sizeof(buffer)));
+    ASSERT_EQ(-1, HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, HPOD_MAX_LEGS + 1, ids, 512, buffer,
+                                        sizeof(buffer)));
+
+    int length = HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, 8, ids, 512, buffer, sizeof(buffer));
+    ASSERT_EQ(HPOD_DXL1_FRAME_LENGTH(24), length);
+
+    // Every leg is encoded, including the legs beyond six
+    uint8_t out_ids[HPOD_SERVO_CHANNELS];
+    int out_counts[HPOD_SERVO_CHANNELS];
+    length = HPOD_servo_frame_encode(&frame, counts);
+    ASSERT_EQ(24, decode_dxl1(buffer, length, out_ids, out_counts));
+    for (int i = 0; i < 24; i++) {
+        ASSERT_EQ(ids[i], out_ids[i]);
+        ASSERT_EQ(counts[i / 3][i % 3], out_counts[i]);
+    }
+
+    // Tables mix every leg, and must match the frame leg count
+    float in[8][3];
+    for (int i = 0; i < 24; i++) {
+        in[i / 3][i % 3] = -1.0f + 2.0f * i / 24;
+    }
+    ASSERT_EQ(-1, HPOD_servo_frame_encode_table(&frame, &table, in));
+
+    struct hpod_servo_table_s octopod;
+    HPOD_servo_table_init(&octopod, &servo, 8);
+    ASSERT_EQ(length, HPOD_servo_frame_encode_table(&frame, &octopod, in));
+    ASSERT_EQ(24, decode_dxl1(buffer, length, out_ids, out_counts));
+    for (int i = 0; i < 24; i++) {
+        ASSERT_NEAR(HPOD_servo_scale(&servo, in[i / 3][i % 3]), out_counts[i], 1);
+    }
+}
+
+TEST_F(ServoFrameTest, SingleWritePerFrame)
+{
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+    struct loopback_s lb = {};
+    struct hpod_servo_transport_s transport = {loopback_write, &lb};
+
+    int length = HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, LEGS, ids, 512, buffer, sizeof(buffer));
+    HPOD_servo_frame_encode(&frame, counts);
+
+    ASSERT_EQ(0, HPOD_servo_frame_send(&frame, &transport));
+    ASSERT_EQ(0, HPOD_servo_frame_send(&frame, &transport));
+
+    ASSERT_EQ(2, lb.writes);
+    ASSERT_EQ(length * 2, lb.length);
+    ASSERT_EQ(0, memcmp(buffer, lb.data, length));
+    ASSERT_EQ(0, memcmp(buffer, lb.data + length, length));
+}
+
+TEST_F(ServoFrameTest, PtyRoundTrip)
+{
+    // The library writes to the pty master, the test reads as the device on the slave
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master, 0);
+    ASSERT_EQ(0, grantpt(master));
+    ASSERT_EQ(0, unlockpt(master));
+
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave, 0);
+
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    struct hpod_servo_frame_s frame;
+    uint8_t buffer[HPOD_SERVO_FRAME_MAX];
+    struct hpod_servo_transport_s transport;
+    HPOD_servo_transport_fd(&transport, &master);
+
+    int length = HPOD_servo_frame_init(&frame, HPOD_SERVO_FORMAT_DXL1, LEGS, ids, 512, buffer, sizeof(buffer));
+    HPOD_servo_frame_encode(&frame, counts);
+    ASSERT_EQ(0, HPOD_servo_frame_send(&frame, &transport));
+
+    uint8_t rx[HPOD_SERVO_FRAME_MAX];
+    int received = 0;
+    while (received < length) {
+        ssize_t res = read(slave, rx + received, length - received);
+        ASSERT_GT(res, 0);
+        received += res;
+    }
+
+    uint8_t out_ids[HPOD_SERVO_CHANNELS];
+    int out_counts[HPOD_SERVO_CHANNELS];
+    ASSERT_EQ(CHANNELS, decode_dxl1(rx, received, out_ids, out_counts));
+    for (int i = 0; i < CHANNELS; i++) {
+        ASSERT_EQ(ids[i], out_ids[i]);
+        ASSERT_EQ(counts[i / 3][i % 3], out_counts[i]);
+    }
+
+    close(slave);
+    close(master);
+
+    // Writes to a closed fd are reported
+    ASSERT_EQ(-1, HPOD_servo_frame_send(&frame, &transport));
+}
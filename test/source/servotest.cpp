@@ -14,6 +14,8 @@
 #include "hexapod/servo.h"
 
 #define RANGE_RADS (300.0 / 180.0 * M_PI)
+#define LEGS        6
+#define CHANNELS    (LEGS * 3)
 
 class ServoTest : public ::testing::Test
 {
@@ -66,3 +68,158 @@ TEST_F(ServoTest, HalfRight)
     ASSERT_EQ(output, 256);
 }
 
+
+TEST_F(ServoTest, TableMatchesScale)
+{
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, LEGS);
+
+    float in[6][3];
+    int out[6][3];
+    for (int i = 0; i < CHANNELS; i++) {
+        in[i / 3][i % 3] = -RANGE_RADS / 2 + RANGE_RADS * i / (CHANNELS - 1);
+    }
+
+    HPOD_servo_table_mix(&table, in, out);
+
+    for (int i = 0; i < CHANNELS; i++) {
+        ASSERT_NEAR(HPOD_servo_scale(&servo, in[i / 3][i % 3]), out[i / 3][i % 3], 1);
+    }
+}
+
+TEST_F(ServoTest, TableLegCount)
+{
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, 8);
+
+    float in[8][3];
+    int out[8][3];
+    for (int i = 0; i < 24; i++) {
+        in[i / 3][i % 3] = -RANGE_RADS / 2 + RANGE_RADS * i / 23;
+    }
+
+    HPOD_servo_mix(&servo, 8, in, out);
+    HPOD_servo_table_mix(&table, in, out);
+    for (int i = 0; i < 24; i++) {
+        ASSERT_NEAR(HPOD_servo_scale(&servo, in[i / 3][i % 3]), out[i / 3][i % 3], 1);
+    }
+
+    // Legs beyond the table are left untouched
+    HPOD_servo_table_init(&table, &servo, LEGS);
+    out[7][2] = -1;
+    HPOD_servo_table_center(&table, out);
+    HPOD_servo_table_mix(&table, in, out);
+    ASSERT_EQ(-1, out[7][2]);
+
+    HPOD_servo_table_init(&table, &servo, HPOD_MAX_LEGS + 1);
+    ASSERT_EQ(HPOD_MAX_LEGS, table.legs);
+}
+
+TEST_F(ServoTest, TableCalibration)
+{
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, LEGS);
+
+    // Reversed, 10% gain, trimmed and offset channel with tight soft limits
+    struct hpod_servo_cal_s cal = {0.1f, -1, 1.1f, -0.5f, 0.5f, 500};
+    HPOD_servo_table_set(&table, &servo, 4, &cal);
+
+    float in[6][3] = {};
+    int out[6][3];
+    float counts_per_rad = output_range / range_rads;
+
+    in[1][1] = 0.2f;
+    HPOD_servo_table_mix(&table, in, out);
+    ASSERT_NEAR(500 - (0.2f + 0.1f) * 1.1f * counts_per_rad, out[1][1], 1);
+    ASSERT_EQ(output_offset, out[0][0]);
+
+    // Soft limits apply after trim
+    in[1][1] = 1.0f;
+    HPOD_servo_table_mix(&table, in, out);
+    ASSERT_NEAR(500 - 0.5f * 1.1f * counts_per_rad, out[1][1], 1);
+
+    in[1][1] = -1.0f;
+    HPOD_servo_table_mix(&table, in, out);
+    ASSERT_NEAR(500 + 0.5f * 1.1f * counts_per_rad, out[1][1], 1);
+}
+
+TEST_F(ServoTest, TableHoldsNaN)
+{
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, LEGS);
+
+    float in[6][3] = {};
+    int out[6][3];
+    HPOD_servo_table_center(&table, out);
+
+    in[2][0] = 0.5f;
+    HPOD_servo_table_mix(&table, in, out);
+    int held = out[2][0];
+    ASSERT_NE(output_offset, held);
+
+    // Unsolved legs keep their last output
+    in[2][0] = NAN;
+    in[2][1] = NAN;
+    HPOD_servo_table_mix(&table, in, out);
+    ASSERT_EQ(held, out[2][0]);
+    ASSERT_EQ(output_offset, out[2][1]);
+}
+
+TEST_F(ServoTest, TablePack)
+{
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, LEGS);
+
+    // Servo ID followed by a 16 bit position, as in a bus sync write
+    const int stride = 3;
+    uint8_t frame[CHANNELS * stride];
+    for (int i = 0; i < CHANNELS; i++) {
+        frame[i * stride] = i;
+    }
+
+    float in[6][3];
+    int out[6][3];
+    for (int i = 0; i < CHANNELS; i++) {
+        in[i / 3][i % 3] = -1.0f + 2.0f * i / CHANNELS;
+    }
+    HPOD_servo_table_mix(&table, in, out);
+    HPOD_servo_table_pack_u16le(&table, in, frame + 1, stride);
+
+    for (int i = 0; i < CHANNELS; i++) {
+        ASSERT_EQ(i, frame[i * stride]);
+        ASSERT_EQ(out[i / 3][i % 3], frame[i * stride + 1] | (frame[i * stride + 2] << 8));
+    }
+
+    // NaN channels hold the value in the frame
+    in[0][0] = NAN;
+    HPOD_servo_table_pack_u16le(&table, in, frame + 1, stride);
+    ASSERT_EQ(out[0][0], frame[1] | (frame[2] << 8));
+}
+
+TEST_F(ServoTest, TablePackClamps)
+{
+    struct hpod_servo_table_s table;
+    HPOD_servo_table_init(&table, &servo, LEGS);
+
+    // Calibrations that overshoot the 16 bit field in each direction
+    struct hpod_servo_cal_s high = {0.0f, 1, 1.0f, -1.0f, 1.0f, 0xFFF0};
+    struct hpod_servo_cal_s low = {0.0f, -1, 1.0f, -1.0f, 1.0f, 10};
+    HPOD_servo_table_set(&table, &servo, 0, &high);
+    HPOD_servo_table_set(&table, &servo, 1, &low);
+
+    const int stride = 2;
+    uint8_t frame[CHANNELS * stride] = {};
+    float in[6][3] = {};
+    int out[6][3];
+
+    in[0][0] = 0.5f;
+    in[0][1] = 0.5f;
+    HPOD_servo_table_mix(&table, in, out);
+    ASSERT_GT(out[0][0], 0xFFFF);
+    ASSERT_LT(out[0][1], 0);
+
+    HPOD_servo_table_pack_u16le(&table, in, frame, stride);
+    ASSERT_EQ(0xFFFF, frame[0] | (frame[1] << 8));
+    ASSERT_EQ(0, frame[2] | (frame[3] << 8));
+    ASSERT_EQ(output_offset, frame[4] | (frame[5] << 8));
+}
@@ -0,0 +1,173 @@
+/**
+ * Libhexapod
+ * Hexapod Workspace Unit Tests
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include <vector>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/workspace.h"
+
+#define QUERY_COUNT     10000
+
+class WorkspaceTest : public ::testing::Test
+{
+protected:
+    WorkspaceTest()
+    {
+        struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+        HPOD_init(&hexy, &config);
+    }
+
+    virtual ~WorkspaceTest()
+    {
+
+    }
+
+    // Random foot positions spread over and around the leg reach
+    void random_position(std::mt19937& rng, struct hpod_vector3_s* pos)
+    {
+        float reach = hexy.config.offset_a + hexy.kinematics.reach_max;
+        std::uniform_real_distribution<float> dist(-reach * 1.1f, reach * 1.1f);
+        pos->x = dist(rng);
+        pos->y = dist(rng);
+        pos->z = dist(rng);
+    }
+
+    struct hexapod_s hexy;
+    struct hpod_workspace_s ws;
+};
+
+TEST_F(WorkspaceTest, MatchesIK)
+{
+    std::mt19937 rng(1);
+    HPOD_workspace_build(&ws, &hexy, NULL);
+
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        struct hpod_vector3_s pos;
+        random_position(rng, &pos);
+
+        float a, b, t;
+        int solved = HPOD_leg_ik3(&hexy, &pos, &a, &b, &t) == 0;
+        float margin = HPOD_workspace_margin(&ws, &pos);
+
+        // Classification may only differ within a cell of the boundary
+        if (fabsf(margin) > ws.cell) {
+            ASSERT_EQ(solved, HPOD_workspace_reachable(&ws, &pos));
+        }
+
+        // Compare against the analytic reach envelope margin (before saturation), which is only
+        // the true distance where the nearest envelope point is not behind the body joint (d < 0)
+        float d = sqrtf(pos.x * pos.x + pos.y * pos.y) - hexy.config.offset_a;
+        float len_ac = sqrtf(d * d + pos.z * pos.z);
+        float expected = fminf(len_ac - hexy.kinematics.reach_min, hexy.kinematics.reach_max - len_ac);
+        // Only inside the grid, outside it margins are extrapolated conservatively from the edge
+        float r = sqrtf(pos.x * pos.x + pos.y * pos.y);
+        float grid_max = (HPOD_WORKSPACE_NODES - 1) * ws.cell;
+        bool in_grid = (r - ws.r_min < grid_max) && (pos.z - ws.z_min >= 0) && (pos.z - ws.z_min < grid_max);
+        if (in_grid && d >= 0.0f && fabsf(expected) < 50.0f) {
+            // Chamfer distances overestimate by up to ~8% off the grid axes
+            ASSERT_NEAR(expected, margin, ws.cell + 0.1f * fabsf(expected));
+        }
+    }
+}
+
+TEST_F(WorkspaceTest, LegLinks)
+{
+    // Eight swept legs with a longer foreleg on leg 5
+    struct hexapod_config_s config = HPOD_DEFAULT_CONFIG;
+    config.legs = 8;
+    for (int i = 0; i < 8; i++) {
+        float angle = (67.5f - 45.0f * (i / 2)) * M_PI / 180;
+        config.leg[i].x = (i % 2 ? 100.0f : -100.0f) * cosf(angle);
+        config.leg[i].y = 100.0f * sinf(angle);
+        config.leg[i].yaw = angle;
+    }
+    config.leg[5].len_bc = 170;
+    HPOD_init(&hexy, &config);
+
+    ASSERT_EQ(-1, HPOD_workspace_build(&ws, &hexy, NULL));
+    ASSERT_EQ(0, HPOD_workspace_build_n(&ws, &hexy, 5, NULL));
+
+    // Leg 5 reaches beyond the shared links, so the map must follow its own IK
+    std::mt19937 rng(1);
+    int extended = 0;
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        struct hpod_vector3_s pos;
+        random_position(rng, &pos);
+
+        float a, b, t;
+        int solved = HPOD_leg_ik3_n(&hexy, 5, &pos, &a, &b, &t) == 0;
+        float margin = HPOD_workspace_margin(&ws, &pos);
+
+        if (fabsf(margin) > ws.cell) {
+            ASSERT_EQ(solved, HPOD_workspace_reachable(&ws, &pos));
+            extended += solved && HPOD_leg_ik3(&hexy, &pos, &a, &b, &t) < 0;
+        }
+    }
+    ASSERT_GT(extended, 0);
+}
+
+TEST_F(WorkspaceTest, JointLimits)
+{
+    struct hpod_joint_limits_s limits = {{-M_PI / 4, M_PI / 4, -M_PI / 6}, {M_PI / 4, 3 * M_PI / 4, M_PI / 6}};
+    std::mt19937 rng(2);
+    HPOD_workspace_build(&ws, &hexy, &limits);
+
+    int reachable = 0;
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        struct hpod_vector3_s pos;
+        random_position(rng, &pos);
+
+        float a, b, t;
+        int solved = HPOD_leg_ik3(&hexy, &pos, &a, &b, &t) == 0;
+        for (int j = 0; solved && j < 3; j++) {
+            float angle = (j == 0) ? a : (j == 1) ? b : t;
+            solved = (angle >= limits.min[j]) && (angle <= limits.max[j]);
+        }
+
+        if (fabsf(HPOD_workspace_margin(&ws, &pos)) > ws.cell) {
+            ASSERT_EQ(solved, HPOD_workspace_reachable(&ws, &pos));
+        }
+        reachable += solved;
+    }
+
+    ASSERT_GT(reachable, 0);
+}
+
+TEST_F(WorkspaceTest, OutsideGrid)
+{
+    HPOD_workspace_build(&ws, &hexy, NULL);
+
+    struct hpod_vector3_s far = {1000.0f, 0.0f, 0.0f};
+    struct hpod_vector3_s nan = {NAN, 0.0f, 0.0f};
+
+    ASSERT_EQ(0, HPOD_workspace_reachable(&ws, &far));
+    ASSERT_EQ(0, HPOD_workspace_reachable(&ws, &nan));
+}
+
+TEST_F(WorkspaceTest, Serialise)
+{
+    HPOD_workspace_build(&ws, &hexy, NULL);
+
+    std::vector<uint8_t> buffer(sizeof(struct hpod_workspace_s));
+    ASSERT_EQ(-1, HPOD_workspace_serialise(&ws, buffer.data(), buffer.size() - 1));
+    ASSERT_EQ((int) buffer.size(), HPOD_workspace_serialise(&ws, buffer.data(), buffer.size()));
+
+    struct hpod_workspace_s loaded;
+    ASSERT_EQ(0, HPOD_workspace_deserialise(&loaded, buffer.data(), buffer.size()));
+    ASSERT_EQ(0, memcmp(&ws, &loaded, sizeof(struct hpod_workspace_s)));
+
+    // Corrupted maps are rejected
+    buffer[sizeof(struct hpod_workspace_s) / 2] ^= 0x01;
+    ASSERT_EQ(-1, HPOD_workspace_deserialise(&loaded, buffer.data(), buffer.size()));
+}
+
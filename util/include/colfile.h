@@ -0,0 +1,79 @@
+/**
+ * Libhexapod
+ * Hexapod Utility columnar binary file
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_UTIL_COLFILE_H
+#define HEXAPOD_UTIL_COLFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Column file layout (little endian)
+ * A fixed header, followed by one name per column, followed by the data with each column
+ * stored contiguously (rows float32 values per column) from data_offset. Columns can be
+ * memory mapped directly, see hexfile.py for the numpy reader.
+ *
+ *   0   char magic[8]        "HPODCOL1"
+ *   8   uint32 columns
+ *   12  uint32 data_offset   Start of column 0, a multiple of COLFILE_ALIGN
+ *   16  uint64 rows
+ *   24  char dtype[8]        numpy type string of the values, "<f4"
+ *   32  char names[columns][COLFILE_NAME_MAX]
+ */
+#define COLFILE_MAGIC           "HPODCOL1"
+#define COLFILE_DTYPE           "<f4"
+#define COLFILE_HEADER_SIZE     32
+#define COLFILE_NAME_MAX        48
+#define COLFILE_ALIGN           64
+
+/**
+ * Column file writer
+ * Rows are written in chunks at any row offset, so the file size is fixed at creation
+ */
+struct colfile_s {
+    int fd;
+    uint32_t columns;
+    uint32_t data_offset;
+    uint64_t rows;
+};
+
+/**
+ * Memory mapped column file reader
+ */
+struct colfile_map_s {
+    void* base;
+    size_t size;
+    uint32_t columns;
+    uint32_t data_offset;
+    uint64_t rows;
+};
+
+int colfile_create(struct colfile_s* file, const char* name, uint32_t columns, const char* const names[],
+                   uint64_t rows);
+
+int colfile_write(struct colfile_s* file, uint64_t row, uint32_t count, uint32_t stride, const float* chunk);
+
+int colfile_close(struct colfile_s* file);
+
+int colfile_map(struct colfile_map_s* map, const char* name);
+
+const char* colfile_name(struct colfile_map_s* map, uint32_t column);
+
+const float* colfile_column(struct colfile_map_s* map, uint32_t column);
+
+void colfile_unmap(struct colfile_map_s* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
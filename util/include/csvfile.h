@@ -15,9 +15,9 @@
 extern "C" {
 #endif
 
-#include "util.h"
+#include "colfile.h"
 
-void write_file(const char* name, int count, float data[NUM_SLICES_MAX][10]);
+int write_csv(const char* name, struct colfile_map_s* map);
 
 #ifdef __cplusplus
 }
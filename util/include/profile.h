@@ -0,0 +1,42 @@
+/**
+ * Libhexapod
+ * Hexapod Utility IK / FK accuracy profiler
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_UTIL_PROFILE_H
+#define HEXAPOD_UTIL_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of profile worker threads
+#define PROFILE_MAX_THREADS     64
+
+// Maximum number of heatmap bins per axis
+#define PROFILE_MAX_BINS        64
+
+// Distance (mm) inside the reach envelope at which samples count as on the boundary
+#define PROFILE_BOUNDARY_MM     5.0f
+
+// Distance (mm) from the theta axis at which samples count as on the axis
+#define PROFILE_AXIS_MM         5.0f
+
+// Profile kernel for the exact libm path (HPOD_leg_ik3 / HPOD_leg_fk3), other kernels are
+// HPOD_simd_select kernel sets (hpod_simd_e) and are compared against the exact path
+#define PROFILE_KERNEL_EXACT    -1
+
+struct config_s;
+
+int profile_kernel_parse(const char* name, int* kernel);
+
+int profile_run(struct config_s* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * Libhexapod
+ * Hexapod Utility parameter sweep
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#ifndef HEXAPOD_UTIL_SWEEP_H
+#define HEXAPOD_UTIL_SWEEP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of sweep worker threads
+#define SWEEP_MAX_THREADS       64
+
+/**
+ * Swept parameters
+ * Candidates are indexed with the first parameter varying fastest.
+ */
+enum sweep_param_e {
+    SWEEP_MOVEMENT_X,   //!< Movement X (left/right)
+    SWEEP_MOVEMENT_Y,   //!< Movement Y (forward/reverse)
+    SWEEP_MOVEMENT_Z,   //!< Movement Z (rotation)
+    SWEEP_ROLL,         //!< Body roll (radians)
+    SWEEP_PITCH,        //!< Body pitch (radians)
+    SWEEP_YAW,          //!< Body yaw (radians)
+    SWEEP_HEIGHT,       //!< Body height above the neutral stance (mm)
+    SWEEP_OFFSET_X,     //!< Gait offset X, foot distance out from the hip (mm)
+    SWEEP_OFFSET_Z,     //!< Gait offset Z, foot height below the hip (mm)
+    SWEEP_STRIDE_X,     //!< Gait movement X, sideways stride (mm)
+    SWEEP_STRIDE_Y,     //!< Gait movement Y, forward stride (mm)
+    SWEEP_LIFT,         //!< Gait movement Z, foot lift (mm)
+    SWEEP_DUTY,         //!< Gait duty factor
+    SWEEP_PARAMS
+};
+
+/**
+ * Sweep range
+ * steps points from min to max (inclusive), a single step is fixed at min and zero steps
+ * leaves the parameter at the base configuration.
+ */
+struct sweep_range_s {
+    float min;
+    float max;
+    int steps;
+};
+
+// Sweep option names (--sweep-<name>), indexed by sweep_param_e
+extern const char* const sweep_param_names[SWEEP_PARAMS];
+
+struct config_s;
+
+int sweep_enabled(struct config_s* config);
+
+uint64_t sweep_size(struct config_s* config);
+
+int sweep_run(struct config_s* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -11,25 +11,34 @@
 
 #include "hexapod/hexapod.h"
 
+#include "sweep.h"
+#include "profile.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Maximum number of slices in output calculation
-#define NUM_SLICES_MAX      1000
 #define FILE_NAME_MAX       64
 
 // Utility configuration
 struct config_s {
     int slices;
     char filename[FILE_NAME_MAX];
+    char csv_filename[FILE_NAME_MAX];
     struct hexapod_config_s hexapod;
     struct hpod_gait_s gait;
     struct hpod_vector3_s movement;
+    int threads;
+    struct sweep_range_s sweep[SWEEP_PARAMS];
+    int profile;
+    int profile_samples;
+    int profile_bins;
+    int profile_kernel;
 };
 
 // Default configuration
-#define DEFAULT_CONFIG {400, "output.csv", HPOD_DEFAULT_CONFIG, HPOD_DEFAULT_GAIT, {0.0, 1.0, 0.0}}
+#define DEFAULT_CONFIG {400, "output.col", "", HPOD_DEFAULT_CONFIG, HPOD_DEFAULT_GAIT, {0.0, 1.0, 0.0}, \
+                        0, {{0.0, 0.0, 0}}, 0, 128, 16, PROFILE_KERNEL_EXACT}
 
 void parse_config(int argc, char** argv, struct config_s* config);
 
@@ -0,0 +1,180 @@
+/**
+ * Libhexapod
+ * Hexapod Utility columnar binary file
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include "colfile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static int write_all(int fd, const void* data, size_t size, uint64_t offset)
+{
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (size > 0) {
+        ssize_t res = pwrite(fd, p, size, (off_t)offset);
+        if (res <= 0) {
+            return -1;
+        }
+        p += res;
+        size -= res;
+        offset += res;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Create a column file for rows values of each column
+ * The file is sized up front, unwritten rows read as zero. Returns 0 on success.
+ */
+int colfile_create(struct colfile_s* file, const char* name, uint32_t columns, const char* const names[],
+                   uint64_t rows)
+{
+    uint32_t header_size = COLFILE_HEADER_SIZE + columns * COLFILE_NAME_MAX;
+    uint8_t header[COLFILE_HEADER_SIZE] = {0};
+
+    file->columns = columns;
+    file->rows = rows;
+    file->data_offset = (header_size + COLFILE_ALIGN - 1) / COLFILE_ALIGN * COLFILE_ALIGN;
+
+    file->fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file->fd < 0) {
+        return -1;
+    }
+
+    memcpy(&header[0], COLFILE_MAGIC, 8);
+    memcpy(&header[8], &file->columns, 4);
+    memcpy(&header[12], &file->data_offset, 4);
+    memcpy(&header[16], &file->rows, 8);
+    memcpy(&header[24], COLFILE_DTYPE, sizeof(COLFILE_DTYPE));
+
+    if (write_all(file->fd, header, sizeof(header), 0) < 0) {
+        close(file->fd);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < columns; i++) {
+        char column_name[COLFILE_NAME_MAX] = {0};
+        strncpy(column_name, names[i], COLFILE_NAME_MAX - 1);
+
+        if (write_all(file->fd, column_name, COLFILE_NAME_MAX, COLFILE_HEADER_SIZE + i * COLFILE_NAME_MAX) < 0) {
+            close(file->fd);
+            return -1;
+        }
+    }
+
+    if (ftruncate(file->fd, file->data_offset + (off_t)columns * rows * sizeof(float)) < 0) {
+        close(file->fd);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Write a chunk of count rows starting at row
+ * The chunk is column major, with the values for column c at chunk[c * stride]. Each column
+ * is a single contiguous write. Returns 0 on success.
+ */
+int colfile_write(struct colfile_s* file, uint64_t row, uint32_t count, uint32_t stride, const float* chunk)
+{
+    if (row + count > file->rows) {
+        return -1;
+    }
+
+    for (uint32_t c = 0; c < file->columns; c++) {
+        uint64_t offset = file->data_offset + ((uint64_t)c * file->rows + row) * sizeof(float);
+
+        if (write_all(file->fd, &chunk[(size_t)c * stride], count * sizeof(float), offset) < 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Close a column file writer
+ */
+int colfile_close(struct colfile_s* file)
+{
+    return close(file->fd);
+}
+
+/**
+ * @brief Memory map a column file for reading
+ * Returns 0 on success, -1 if the file cannot be opened or is not a complete column file.
+ */
+int colfile_map(struct colfile_map_s* map, const char* name)
+{
+    struct stat st;
+    int fd = open(name, O_RDONLY);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (fstat(fd, &st) < 0 || st.st_size < COLFILE_HEADER_SIZE) {
+        close(fd);
+        return -1;
+    }
+
+    map->size = st.st_size;
+    map->base = mmap(NULL, map->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map->base == MAP_FAILED) {
+        return -1;
+    }
+
+    const uint8_t* header = (const uint8_t*)map->base;
+    memcpy(&map->columns, &header[8], 4);
+    memcpy(&map->data_offset, &header[12], 4);
+    memcpy(&map->rows, &header[16], 8);
+
+    if (memcmp(header, COLFILE_MAGIC, 8) != 0 || memcmp(&header[24], COLFILE_DTYPE, sizeof(COLFILE_DTYPE)) != 0
+        || map->data_offset < COLFILE_HEADER_SIZE + (uint64_t)map->columns * COLFILE_NAME_MAX
+        || map->size < map->data_offset + (uint64_t)map->columns * map->rows * sizeof(float)) {
+        munmap(map->base, map->size);
+        return -1;
+    }
+
+    madvise(map->base, map->size, MADV_SEQUENTIAL);
+
+    return 0;
+}
+
+/**
+ * @brief Fetch the name of a mapped column
+ */
+const char* colfile_name(struct colfile_map_s* map, uint32_t column)
+{
+    return (const char*)map->base + COLFILE_HEADER_SIZE + column * COLFILE_NAME_MAX;
+}
+
+/**
+ * @brief Fetch the values of a mapped column
+ */
+const float* colfile_column(struct colfile_map_s* map, uint32_t column)
+{
+    return (const float*)((const uint8_t*)map->base + map->data_offset) + (size_t)column * map->rows;
+}
+
+/**
+ * @brief Unmap a column file
+ */
+void colfile_unmap(struct colfile_map_s* map)
+{
+    munmap(map->base, map->size);
+}
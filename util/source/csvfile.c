@@ -1,38 +1,46 @@
+/**
+ * Libhexapod
+ * Hexapod Utility CSV writer
+ * Exports a column file as CSV, with the column names as the first line
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
 
 #include "csvfile.h"
 
 #include <stdio.h>
 
-#include "util.h"
+#include "colfile.h"
 
+#define CSV_BUFFER_SIZE     (1 << 20)
 
-void write_line(FILE* fp, int count, float* data)
-{
-    for (int i = 0; i < count; i++) {
-        if (i < (count - 1)) {
-            fprintf(fp, "%.2f, ", data[i]);
-        } else {
-            fprintf(fp, "%.2f", data[i]);
-        }
-
-    }
-    fprintf(fp, "\n");
-}
-
-void write_file(const char* name, int count, float data[NUM_SLICES_MAX][10])
+/**
+ * @brief Write a mapped column file to a CSV file
+ * Values are written with enough digits to round trip. Returns 0 on success.
+ */
+int write_csv(const char* name, struct colfile_map_s* map)
 {
     // Open output file
     FILE *fp = fopen(name, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+    setvbuf(fp, NULL, _IOFBF, CSV_BUFFER_SIZE);
 
-    // Write outputs
-    fprintf(fp, "Phase, Target X (left/right), Target Y (forward/back), Target Z (up/down), "
-            "Leg Angle Alpha, Leg Angle Beta, Leg Angle Theta, "
-            "Actual X (left/right), Actual Y (forward/back), Actual Z (up/down)\n");
+    const float* columns[map->columns];
+    for (uint32_t c = 0; c < map->columns; c++) {
+        columns[c] = colfile_column(map, c);
+        fprintf(fp, (c < map->columns - 1) ? "%s, " : "%s\n", colfile_name(map, c));
+    }
 
-    for (int i = 0; i < count; i++) {
-        write_line(fp, 10, data[i]);
+    // Write outputs
+    for (uint64_t i = 0; i < map->rows; i++) {
+        for (uint32_t c = 0; c < map->columns; c++) {
+            fprintf(fp, (c < map->columns - 1) ? "%.9g, " : "%.9g\n", columns[c][i]);
+        }
     }
 
     // Close file
-    fclose(fp);
+    return fclose(fp);
 }
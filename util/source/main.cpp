@@ -1,7 +1,7 @@
 /**
  * Libhexapod
  * Hexapod utility
- * This runs the hexapod library and writes outputs to a csv for analysis
+ * This runs the hexapod library and streams outputs to a column file for analysis
  *
  * https://github.com/ryankurte/libhexapod
  * Copyright 2017 Ryan Kurte
@@ -13,8 +13,36 @@
 #include "hexapod/hexapod.h"
 
 #include "util.h"
+#include "colfile.h"
 #include "csvfile.h"
-
+#include "sweep.h"
+#include "profile.h"
+
+// Rows computed per write
+#define CHUNK_ROWS      4096
+
+enum column_e {
+    COL_PHASE,
+    COL_TARGET_X,
+    COL_TARGET_Y,
+    COL_TARGET_Z,
+    COL_ALPHA,
+    COL_BETA,
+    COL_THETA,
+    COL_ACTUAL_X,
+    COL_ACTUAL_Y,
+    COL_ACTUAL_Z,
+    COL_COUNT
+};
+
+static const char* const column_names[COL_COUNT] = {
+    "Phase", "Target X (left/right)", "Target Y (forward/back)", "Target Z (up/down)",
+    "Leg Angle Alpha", "Leg Angle Beta", "Leg Angle Theta",
+    "Actual X (left/right)", "Actual Y (forward/back)", "Actual Z (up/down)"
+};
+
+// Output chunk, column major so each column is written in one call
+static float chunk[COL_COUNT][CHUNK_ROWS];
 
 int main(int argc, char **argv)
 {
@@ -22,6 +50,20 @@ int main(int argc, char **argv)
 
     parse_config(argc, argv, &config);
 
+    if (config.profile) {
+        return profile_run(&config);
+    }
+
+    if (config.slices < 2) {
+        printf("ERROR: at least two slices are required\r\n");
+        return -1;
+    }
+
+    // Sweeps report failing candidates rather than validating a single gait
+    if (sweep_enabled(&config)) {
+        return sweep_run(&config);
+    }
+
     // Create hexapod control instance
     struct hexapod_s hexy;
     HPOD_init(&hexy, &config.hexapod);
@@ -33,40 +75,65 @@ int main(int argc, char **argv)
     }
 
     // Output data
-    float data[NUM_SLICES_MAX][10];
-    // Calculate position of every slice
-    for (int i = 0; i < config.slices; i++) {
-        float phase = i / (((float)config.slices - 1) / 2) - 1;
-        data[i][0] = phase;
-
-        // Calculate leg position for a given gait
-        struct hpod_vector3_s position;
-        HPOD_gait_calc(&hexy, &config.gait, &config.movement, phase, &position);
-
-        // Save leg positions
-        data[i][1] = position.x;
-        data[i][2] = position.y;
-        data[i][3] = position.z;
-
-        // Calculate servo control
-        float alpha, beta, theta;
-        HPOD_leg_ik3(&hexy, &position, &alpha, &beta, &theta);
-
-        data[i][4] = alpha;
-        data[i][5] = beta;
-        data[i][6] = theta;
-
-        // Calculate control inverse
-        struct hpod_vector3_s actual;
-        HPOD_leg_fk3(&hexy, alpha, beta, theta, &actual);
-        data[i][7] = actual.x;
-        data[i][8] = actual.y;
-        data[i][9] = actual.z;
+    struct colfile_s file;
+    res = colfile_create(&file, config.filename, COL_COUNT, column_names, config.slices);
+    if (res < 0) {
+        printf("ERROR: could not create output file %s\r\n", config.filename);
+        return -1;
+    }
+
+    // Calculate position of every slice, one chunk at a time
+    const double phase_step = 2.0 / (config.slices - 1);
+    for (int start = 0; start < config.slices; start += CHUNK_ROWS) {
+        int count = (config.slices - start < CHUNK_ROWS) ? config.slices - start : CHUNK_ROWS;
+
+        for (int i = 0; i < count; i++) {
+            float phase = (float)((start + i) * phase_step - 1.0);
+            chunk[COL_PHASE][i] = phase;
+
+            // Calculate leg position for a given gait (front left leg, so rotation applies)
+            struct hpod_vector3_s position;
+            HPOD_gait_calc_leg(&hexy, &config.gait, &config.movement, phase, 0, &position);
+
+            // Save leg positions
+            chunk[COL_TARGET_X][i] = position.x;
+            chunk[COL_TARGET_Y][i] = position.y;
+            chunk[COL_TARGET_Z][i] = position.z;
+
+            // Calculate servo control
+            float alpha, beta, theta;
+            HPOD_leg_ik3_n(&hexy, 0, &position, &alpha, &beta, &theta);
+
+            chunk[COL_ALPHA][i] = alpha;
+            chunk[COL_BETA][i] = beta;
+            chunk[COL_THETA][i] = theta;
+
+            // Calculate control inverse
+            struct hpod_vector3_s actual;
+            HPOD_leg_fk3(&hexy, alpha, beta, theta, &actual);
+            chunk[COL_ACTUAL_X][i] = actual.x;
+            chunk[COL_ACTUAL_Y][i] = actual.y;
+            chunk[COL_ACTUAL_Z][i] = actual.z;
+        }
+
+        if (colfile_write(&file, start, count, CHUNK_ROWS, &chunk[0][0]) < 0) {
+            printf("ERROR: could not write to output file %s\r\n", config.filename);
+            colfile_close(&file);
+            return -1;
+        }
     }
 
-    // Write outputs
-    write_file("output.csv", config.slices, data);
+    colfile_close(&file);
+
+    // Optional CSV export
+    if (config.csv_filename[0] != '\0') {
+        struct colfile_map_s map;
+        if (colfile_map(&map, config.filename) < 0 || write_csv(config.csv_filename, &map) < 0) {
+            printf("ERROR: could not export %s to %s\r\n", config.filename, config.csv_filename);
+            return -1;
+        }
+        colfile_unmap(&map);
+    }
 
     return 0;
 }
-
@@ -0,0 +1,548 @@
+/**
+ * Libhexapod
+ * Hexapod Utility IK / FK accuracy profiler
+ * Samples a grid over the leg workspace in parallel, solving each target with IK and
+ * measuring the distance from the target to the FK of the solution. Errors are binned into a
+ * 3D heatmap written as a column file, and into log scale histograms for percentiles.
+ * IK2 / FK2 kernel sets from HPOD_simd_select may be profiled alongside the exact path.
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/simd.h"
+
+#include "util.h"
+#include "colfile.h"
+
+// Error histogram, PROFILE_HIST_DECADES decades from PROFILE_HIST_MIN mm with an underflow
+// (including exact) bin first and an overflow (or non finite) bin last
+#define PROFILE_HIST_MIN        1e-8f
+#define PROFILE_HIST_DECADES    12
+#define PROFILE_HIST_PER_DECADE 8
+#define PROFILE_HIST_BINS       (PROFILE_HIST_DECADES * PROFILE_HIST_PER_DECADE + 2)
+
+/**
+ * Workspace regions, samples are assigned to the first region that applies
+ */
+enum profile_region_e {
+    REGION_BOUNDARY,    //!< Within PROFILE_BOUNDARY_MM of the reach envelope (leg straight or folded)
+    REGION_AXIS,        //!< Within PROFILE_AXIS_MM of the theta axis (theta undefined)
+    REGION_INTERIOR,    //!< Everywhere else
+    REGION_COUNT
+};
+
+static const char* const region_names[REGION_COUNT] = {
+    "reach boundary", "theta axis", "interior"
+};
+
+/**
+ * Profiled paths, the exact path is always profiled as the reference
+ */
+enum profile_path_e {
+    PATH_EXACT,         //!< HPOD_leg_ik3 -> HPOD_leg_fk3
+    PATH_KERNEL,        //!< HPOD_leg_ik2_simd -> HPOD_leg_fk2_simd with the selected kernel set
+    PATH_COUNT
+};
+
+/**
+ * Profile kernel names, for --profile-kernel
+ */
+static const struct {
+    const char* name;
+    int kernel;
+} profile_kernels[] = {
+    {"exact", PROFILE_KERNEL_EXACT},
+    {"scalar", HPOD_SIMD_SCALAR},
+    {"x4", HPOD_SIMD_X4},
+    {"x8", HPOD_SIMD_X8},
+    {"auto", HPOD_SIMD_AUTO},
+};
+
+#define PROFILE_KERNELS (sizeof(profile_kernels) / sizeof(profile_kernels[0]))
+
+enum profile_column_e {
+    COL_X,
+    COL_Y,
+    COL_Z,
+    COL_SAMPLES,
+    COL_MEAN_ERROR,
+    COL_MAX_ERROR,
+    COL_COUNT
+};
+
+static const char* const column_names[COL_COUNT] = {
+    "Bin X (left/right)", "Bin Y (forward/back)", "Bin Z (up/down)",
+    "Samples", "Mean Error", "Max Error"
+};
+
+/**
+ * Heatmap bin
+ */
+struct profile_bin_s {
+    uint32_t samples;
+    float max_error;
+    double total_error;
+};
+
+/**
+ * Profile worker, samples z planes from begin to end (exclusive) into its own heatmap and
+ * histograms, which are merged once all workers complete. The heatmap and worst target are
+ * of the last profiled path.
+ */
+struct profile_worker_s {
+    pthread_t thread;
+    struct config_s* config;
+    struct hexapod_s* hexapod;
+    float extent[3];                //!< Half width of the sampled workspace on each axis
+    int begin;
+    int end;
+    int paths;                      //!< Profiled paths, 1 for the exact path alone
+    uint64_t samples;               //!< Samples taken
+    uint64_t histogram[PATH_COUNT][REGION_COUNT][PROFILE_HIST_BINS];
+    float max_error[PATH_COUNT][REGION_COUNT];
+    float worst_error;              //!< Maximum error over all regions
+    struct hpod_vector3_s worst;    //!< Target with the maximum error
+    struct profile_bin_s* bins;
+    float* row;                     //!< Kernel inputs and outputs for one row of samples (4 per sample)
+    int8_t* regions;                //!< Region of each sample in the row, -1 when unreachable
+};
+
+/**
+ * @brief Histogram bin for an error
+ */
+static int profile_hist_bin(float error)
+{
+    if (!(error < INFINITY)) {
+        return PROFILE_HIST_BINS - 1;
+    }
+    if (error < PROFILE_HIST_MIN) {
+        return 0;
+    }
+
+    int bin = 1 + (int)(log10f(error / PROFILE_HIST_MIN) * PROFILE_HIST_PER_DECADE);
+    return (bin < PROFILE_HIST_BINS - 1) ? bin : PROFILE_HIST_BINS - 1;
+}
+
+/**
+ * @brief Upper error bound of a histogram bin
+ */
+static float profile_hist_limit(int bin)
+{
+    if (bin >= PROFILE_HIST_BINS - 1) {
+        return INFINITY;
+    }
+
+    return PROFILE_HIST_MIN * powf(10.0f, (float)bin / PROFILE_HIST_PER_DECADE);
+}
+
+/**
+ * @brief Fetch the error bound below which a fraction of samples fall
+ */
+static float profile_percentile(const uint64_t histogram[], float fraction)
+{
+    uint64_t total = 0, count = 0;
+
+    for (int i = 0; i < PROFILE_HIST_BINS; i++) {
+        total += histogram[i];
+    }
+
+    for (int i = 0; i < PROFILE_HIST_BINS; i++) {
+        count += histogram[i];
+        if (count > 0 && count >= fraction * total) {
+            return profile_hist_limit(i);
+        }
+    }
+
+    return NAN;
+}
+
+/**
+ * @brief Parse a profile kernel name
+ * Returns 0 and sets kernel on success, -1 for unknown names.
+ */
+int profile_kernel_parse(const char* name, int* kernel)
+{
+    for (size_t i = 0; i < PROFILE_KERNELS; i++) {
+        if (strcmp(name, profile_kernels[i].name) == 0) {
+            *kernel = profile_kernels[i].kernel;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Fetch the name of a profile kernel
+ */
+static const char* profile_kernel_name(int kernel)
+{
+    for (size_t i = 0; i < PROFILE_KERNELS; i++) {
+        if (profile_kernels[i].kernel == kernel) {
+            return profile_kernels[i].name;
+        }
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief Sample target for a grid cell
+ * Samples are at cell centres, so no sample lies exactly on the theta axis.
+ */
+static struct hpod_vector3_s profile_target(struct profile_worker_s* w, int ix, int iy, int iz)
+{
+    const int samples = w->config->profile_samples;
+    struct hpod_vector3_s target = {
+        w->extent[0] * (2.0f * (ix + 0.5f) / samples - 1.0f),
+        w->extent[1] * (2.0f * (iy + 0.5f) / samples - 1.0f),
+        w->extent[2] * (2.0f * (iz + 0.5f) / samples - 1.0f),
+    };
+
+    return target;
+}
+
+/**
+ * @brief Record the round trip error of a sample
+ */
+static void profile_record(struct profile_worker_s* w, int path, int region, float error,
+                           struct hpod_vector3_s* target, int ix, int iy, int iz)
+{
+    const int samples = w->config->profile_samples;
+    const int bins = w->config->profile_bins;
+
+    w->histogram[path][region][profile_hist_bin(error)]++;
+    w->max_error[path][region] = fmaxf(w->max_error[path][region], error);
+
+    if (path != w->paths - 1) {
+        return;
+    }
+
+    if (error > w->worst_error) {
+        w->worst_error = error;
+        w->worst = *target;
+    }
+
+    int bx = ix * bins / samples, by = iy * bins / samples, bz = iz * bins / samples;
+    struct profile_bin_s* bin = &w->bins[((size_t)bz * bins + by) * bins + bx];
+    bin->samples++;
+    bin->total_error += error;
+    bin->max_error = fmaxf(bin->max_error, error);
+}
+
+/**
+ * @brief Profile worker thread
+ * Each row of samples is solved with the exact path, then with the selected kernel set from
+ * the same leg plane (d, h) inputs, with theta and the offset at joint A applied in libm as
+ * HPOD_leg_ik3 / HPOD_leg_fk3 do. Kernel errors are only recorded for targets the exact path
+ * solves, so both paths cover the same samples.
+ */
+static void* profile_worker(void* arg)
+{
+    struct profile_worker_s* w = (struct profile_worker_s*)arg;
+    struct hexapod_s* hexapod = w->hexapod;
+    const struct hpod_kinematics_s* k = &hexapod->kinematics;
+    const float offset_a = hexapod->config.offset_a;
+    const int samples = w->config->profile_samples;
+
+    float* d = w->row;
+    float* h = d + samples;
+    float* alpha = h + samples;
+    float* beta = alpha + samples;
+
+    for (int iz = w->begin; iz < w->end; iz++) {
+        for (int iy = 0; iy < samples; iy++) {
+            for (int ix = 0; ix < samples; ix++) {
+                struct hpod_vector3_s target = profile_target(w, ix, iy, iz);
+                float a, b, t;
+
+                w->samples++;
+                w->regions[ix] = -1;
+
+                // Leg plane inputs for the kernels
+                float len_xy = sqrtf(target.x * target.x + target.y * target.y);
+                d[ix] = len_xy - offset_a;
+                h[ix] = target.z;
+
+                if (HPOD_leg_ik3(hexapod, &target, &a, &b, &t) < 0) {
+                    continue;
+                }
+
+                struct hpod_vector3_s actual;
+                HPOD_leg_fk3(hexapod, a, b, t, &actual);
+
+                float dx = actual.x - target.x, dy = actual.y - target.y, dz = actual.z - target.z;
+                float error = sqrtf(dx * dx + dy * dy + dz * dz);
+
+                // Classify against the reach envelope, as in HPOD_gait_check
+                float len_ac = sqrtf(d[ix] * d[ix] + target.z * target.z);
+                float margin = fminf(len_ac - k->reach_min, k->reach_max - len_ac);
+
+                int region = REGION_INTERIOR;
+                if (margin < PROFILE_BOUNDARY_MM) {
+                    region = REGION_BOUNDARY;
+                } else if (len_xy < PROFILE_AXIS_MM) {
+                    region = REGION_AXIS;
+                }
+
+                w->regions[ix] = region;
+                profile_record(w, PATH_EXACT, region, error, &target, ix, iy, iz);
+            }
+
+            if (w->paths < PATH_COUNT) {
+                continue;
+            }
+
+            // Kernel round trip over the row, FK results replace the inputs
+            HPOD_leg_ik2_simd(hexapod, samples, d, h, alpha, beta);
+            HPOD_leg_fk2_simd(hexapod, samples, alpha, beta, d, h);
+
+            for (int ix = 0; ix < samples; ix++) {
+                if (w->regions[ix] < 0) {
+                    continue;
+                }
+
+                struct hpod_vector3_s target = profile_target(w, ix, iy, iz);
+                float theta = atan2f(target.y, target.x);
+                float len_xy = offset_a + d[ix];
+
+                float dx = len_xy * cosf(theta) - target.x;
+                float dy = len_xy * sinf(theta) - target.y;
+                float dz = h[ix] - target.z;
+                float error = sqrtf(dx * dx + dy * dy + dz * dz);
+
+                profile_record(w, PATH_KERNEL, w->regions[ix], error, &target, ix, iy, iz);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Write the heatmap to a column file, one row per bin with x varying fastest
+ */
+static int profile_write(struct config_s* config, struct profile_bin_s* bins, float extent[3])
+{
+    const int n = config->profile_bins;
+    const size_t rows = (size_t)n * n * n;
+    struct colfile_s file;
+
+    float* chunk = malloc(COL_COUNT * rows * sizeof(float));
+    if (chunk == NULL) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < rows; i++) {
+        int bx = i % n, by = (i / n) % n, bz = i / n / n;
+
+        chunk[COL_X * rows + i] = extent[0] * (2.0f * (bx + 0.5f) / n - 1.0f);
+        chunk[COL_Y * rows + i] = extent[1] * (2.0f * (by + 0.5f) / n - 1.0f);
+        chunk[COL_Z * rows + i] = extent[2] * (2.0f * (bz + 0.5f) / n - 1.0f);
+        chunk[COL_SAMPLES * rows + i] = bins[i].samples;
+        chunk[COL_MEAN_ERROR * rows + i] = (bins[i].samples > 0) ? bins[i].total_error / bins[i].samples : 0.0f;
+        chunk[COL_MAX_ERROR * rows + i] = bins[i].max_error;
+    }
+
+    int res = colfile_create(&file, config->filename, COL_COUNT, column_names, rows);
+    if (res == 0) {
+        res = colfile_write(&file, 0, rows, rows, chunk);
+        colfile_close(&file);
+    }
+
+    free(chunk);
+
+    return res;
+}
+
+/**
+ * @brief Run the accuracy profiler
+ * Samples profile_samples points per axis over a box enclosing the leg reach envelope, with
+ * z planes split evenly between worker threads. Prints p50 / p99 / max round trip error
+ * overall and per workspace region, and the worst heatmap bin, and writes the heatmap to the
+ * output file (see heatmap.py). Percentiles are the upper bound of the histogram bin they
+ * fall in. With a profile kernel selected, regions are printed for both the kernel and the
+ * exact path, and the overall results and heatmap are of the kernel. Returns 0 on success.
+ */
+int profile_run(struct config_s* config)
+{
+    static struct profile_worker_s workers[PROFILE_MAX_THREADS];
+    struct hexapod_s hexy;
+    struct timespec start, end;
+
+    HPOD_init(&hexy, &config->hexapod);
+
+    const int samples = config->profile_samples;
+    const int n = config->profile_bins;
+    if (samples < 1 || n < 1 || n > PROFILE_MAX_BINS || n > samples) {
+        printf("ERROR: profile requires 1 <= bins <= samples and bins <= %d\r\n", PROFILE_MAX_BINS);
+        return -1;
+    }
+
+    // Kernel sets hold the shared leg geometry, which hex-util configures for every leg
+    int kernel = config->profile_kernel;
+    int paths = 1;
+    if (kernel != PROFILE_KERNEL_EXACT) {
+        kernel = HPOD_simd_select(kernel);
+        paths = PATH_COUNT;
+    }
+
+    float reach = hexy.config.offset_a + hexy.kinematics.reach_max;
+    float extent[3] = {reach, reach, hexy.kinematics.reach_max};
+
+    int threads = (config->threads > 0) ? config->threads : sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (threads < 1) ? 1 : threads;
+    threads = (threads > PROFILE_MAX_THREADS) ? PROFILE_MAX_THREADS : threads;
+    threads = (threads > samples) ? samples : threads;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int res = 0;
+    int created = 0;
+
+    for (int i = 0; i < threads; i++) {
+        struct profile_worker_s* w = &workers[i];
+        memset(w, 0, sizeof(*w));
+        w->config = config;
+        w->hexapod = &hexy;
+        w->extent[0] = extent[0];
+        w->extent[1] = extent[1];
+        w->extent[2] = extent[2];
+        w->begin = samples * i / threads;
+        w->end = samples * (i + 1) / threads;
+        w->paths = paths;
+        w->bins = calloc((size_t)n * n * n, sizeof(struct profile_bin_s));
+        w->row = malloc(4 * (size_t)samples * sizeof(float));
+        w->regions = malloc((size_t)samples * sizeof(int8_t));
+
+        if (w->bins == NULL || w->row == NULL || w->regions == NULL ||
+            pthread_create(&w->thread, NULL, profile_worker, w) != 0) {
+            printf("ERROR: could not start profile worker %d\r\n", i);
+            free(w->bins);
+            free(w->row);
+            free(w->regions);
+            res = -1;
+            break;
+        }
+        created++;
+    }
+
+    // Merge into the first worker
+    struct profile_worker_s* total = &workers[0];
+
+    for (int i = 0; i < created; i++) {
+        struct profile_worker_s* w = &workers[i];
+        pthread_join(w->thread, NULL);
+        free(w->row);
+        free(w->regions);
+
+        if (i == 0) {
+            continue;
+        }
+
+        total->samples += w->samples;
+        for (int p = 0; p < paths; p++) {
+            for (int r = 0; r < REGION_COUNT; r++) {
+                for (int b = 0; b < PROFILE_HIST_BINS; b++) {
+                    total->histogram[p][r][b] += w->histogram[p][r][b];
+                }
+                if (w->max_error[p][r] > total->max_error[p][r]) {
+                    total->max_error[p][r] = w->max_error[p][r];
+                }
+            }
+        }
+        if (w->worst_error > total->worst_error) {
+            total->worst_error = w->worst_error;
+            total->worst = w->worst;
+        }
+        for (size_t b = 0; b < (size_t)n * n * n; b++) {
+            total->bins[b].samples += w->bins[b].samples;
+            total->bins[b].total_error += w->bins[b].total_error;
+            total->bins[b].max_error = fmaxf(total->bins[b].max_error, w->bins[b].max_error);
+        }
+        free(w->bins);
+    }
+
+    if (res < 0) {
+        if (created > 0) {
+            free(total->bins);
+        }
+        return res;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    // Overall results of the last path, and per region results of every path
+    const int last = paths - 1;
+    uint64_t all[PROFILE_HIST_BINS] = {0};
+    uint64_t solved = 0;
+
+    for (int r = 0; r < REGION_COUNT; r++) {
+        for (int b = 0; b < PROFILE_HIST_BINS; b++) {
+            all[b] += total->histogram[last][r][b];
+            solved += total->histogram[last][r][b];
+        }
+    }
+
+    printf("Profiled %llu samples with the %s kernel on %d threads in %.3f s, %llu inside the reach envelope\r\n",
+           (unsigned long long)total->samples, profile_kernel_name(kernel), threads, elapsed,
+           (unsigned long long)solved);
+    printf("Round trip error: p50 %.3g mm, p99 %.3g mm, max %.3g mm at (%.2f, %.2f, %.2f)\r\n",
+           profile_percentile(all, 0.5f), profile_percentile(all, 0.99f), total->worst_error,
+           total->worst.x, total->worst.y, total->worst.z);
+
+    printf("%-16s %8s %12s %12s %12s %12s\r\n", "Region", "Kernel", "Samples", "p50 (mm)", "p99 (mm)", "Max (mm)");
+    for (int r = 0; r < REGION_COUNT; r++) {
+        for (int p = 0; p < paths; p++) {
+            uint64_t count = 0;
+            for (int b = 0; b < PROFILE_HIST_BINS; b++) {
+                count += total->histogram[p][r][b];
+            }
+            printf("%-16s %8s %12llu %12.3g %12.3g %12.3g\r\n", region_names[r],
+                   profile_kernel_name(p == PATH_EXACT ? PROFILE_KERNEL_EXACT : kernel),
+                   (unsigned long long)count, profile_percentile(total->histogram[p][r], 0.5f),
+                   profile_percentile(total->histogram[p][r], 0.99f), total->max_error[p][r]);
+        }
+    }
+
+    // Heatmap bin with the largest mean error
+    size_t worst = 0;
+    double worst_mean = -1.0;
+    for (size_t b = 0; b < (size_t)n * n * n; b++) {
+        struct profile_bin_s* bin = &total->bins[b];
+        if (bin->samples > 0 && bin->total_error / bin->samples > worst_mean) {
+            worst_mean = bin->total_error / bin->samples;
+            worst = b;
+        }
+    }
+    if (worst_mean >= 0.0) {
+        int bx = worst % n, by = (worst / n) % n, bz = worst / n / n;
+        printf("Worst bin: (%.1f, %.1f, %.1f), mean %.3g mm, max %.3g mm over %u samples\r\n",
+               extent[0] * (2.0f * (bx + 0.5f) / n - 1.0f), extent[1] * (2.0f * (by + 0.5f) / n - 1.0f),
+               extent[2] * (2.0f * (bz + 0.5f) / n - 1.0f), worst_mean, total->bins[worst].max_error,
+               total->bins[worst].samples);
+    }
+
+    res = profile_write(config, total->bins, extent);
+    if (res < 0) {
+        printf("ERROR: could not write heatmap to %s\r\n", config->filename);
+    }
+
+    free(total->bins);
+
+    return res;
+}
@@ -0,0 +1,403 @@
+/**
+ * Libhexapod
+ * Hexapod Utility parameter sweep
+ * Evaluates the cartesian product of movement, body pose and gait parameter ranges over a
+ * pool of worker threads, each writing a column file shard of per candidate results.
+ *
+ * https://github.com/ryankurte/libhexapod
+ * Copyright 2017 Ryan Kurte
+ */
+
+#include "sweep.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "hexapod/hexapod.h"
+#include "hexapod/body_pose.h"
+#include "hexapod/gait_pattern.h"
+
+#include "util.h"
+#include "colfile.h"
+
+// Candidates computed per shard write
+#define SWEEP_CHUNK_ROWS    256
+
+enum sweep_column_e {
+    COL_IK_FAILURES = SWEEP_PARAMS,
+    COL_MAX_FK_ERROR,
+    COL_MIN_REACH_MARGIN,
+    COL_COUNT
+};
+
+const char* const sweep_param_names[SWEEP_PARAMS] = {
+    "movement-x", "movement-y", "movement-z", "roll", "pitch", "yaw", "height",
+    "offset-x", "offset-z", "stride-x", "stride-y", "lift", "duty"
+};
+
+static const char* const column_names[COL_COUNT] = {
+    "Movement X (left/right)", "Movement Y (forward/back)", "Movement Z (rotation)",
+    "Body Roll", "Body Pitch", "Body Yaw", "Body Height",
+    "Gait Offset X", "Gait Offset Z", "Gait Stride X", "Gait Stride Y", "Gait Lift", "Gait Duty",
+    "IK Failures", "Max FK Error", "Min Reach Margin"
+};
+
+/**
+ * Sweep results, for a single worker or the whole sweep
+ */
+struct sweep_stats_s {
+    uint64_t candidates;        //!< Candidates evaluated
+    uint64_t failed;            //!< Candidates with at least one IK failure
+    uint64_t positions;         //!< Leg positions evaluated
+    uint64_t ik_failures;       //!< Leg positions that could not be solved
+    float max_fk_error;         //!< Maximum IK to FK round trip error (mm)
+    uint64_t max_fk_index;      //!< Candidate with the maximum round trip error
+    float min_reach_margin;     //!< Minimum distance inside the leg reach envelope (mm)
+    uint64_t min_reach_index;   //!< Candidate with the minimum reach margin
+};
+
+/**
+ * Sweep worker, evaluates candidates from begin to end (exclusive) into its own shard
+ */
+struct sweep_worker_s {
+    pthread_t thread;
+    struct config_s* config;
+    struct hexapod_s* hexapod;
+    uint64_t begin;
+    uint64_t end;
+    int id;
+    int res;
+    struct sweep_stats_s stats;
+};
+
+/**
+ * @brief Access a swept parameter by index
+ */
+static float* sweep_param(struct hpod_gait_s* gait, struct hpod_vector3_s* movement,
+                          struct hpod_body_pose_s* pose, int i)
+{
+    switch (i) {
+    case SWEEP_MOVEMENT_X: return &movement->x;
+    case SWEEP_MOVEMENT_Y: return &movement->y;
+    case SWEEP_MOVEMENT_Z: return &movement->z;
+    case SWEEP_ROLL: return &pose->roll;
+    case SWEEP_PITCH: return &pose->pitch;
+    case SWEEP_YAW: return &pose->yaw;
+    case SWEEP_HEIGHT: return &pose->position.z;
+    case SWEEP_OFFSET_X: return &gait->offset.x;
+    case SWEEP_OFFSET_Z: return &gait->offset.z;
+    case SWEEP_STRIDE_X: return &gait->movement.x;
+    case SWEEP_STRIDE_Y: return &gait->movement.y;
+    case SWEEP_LIFT: return &gait->movement.z;
+    default: return &gait->pattern.duty;
+    }
+}
+
+/**
+ * @brief Fetch a sweep candidate by index
+ * Parameters that are not swept keep the values from the utility configuration (or the
+ * neutral body pose), values receives every parameter of the candidate.
+ */
+static void sweep_get(struct config_s* config, uint64_t index, struct hpod_gait_s* gait,
+                      struct hpod_vector3_s* movement, struct hpod_body_pose_s* pose, float values[])
+{
+    struct hpod_body_pose_s neutral = HPOD_DEFAULT_BODY_POSE;
+
+    *gait = config->gait;
+    *movement = config->movement;
+    *pose = neutral;
+
+    for (int i = 0; i < SWEEP_PARAMS; i++) {
+        struct sweep_range_s* range = &config->sweep[i];
+        float* param = sweep_param(gait, movement, pose, i);
+
+        if (range->steps == 1) {
+            *param = range->min;
+        } else if (range->steps > 1) {
+            int step = index % range->steps;
+            index /= range->steps;
+            *param = range->min + (range->max - range->min) * step / (range->steps - 1);
+        }
+
+        values[i] = *param;
+    }
+}
+
+/**
+ * @brief Check whether any parameter is swept
+ */
+int sweep_enabled(struct config_s* config)
+{
+    for (int i = 0; i < SWEEP_PARAMS; i++) {
+        if (config->sweep[i].steps > 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Fetch the number of candidates in a sweep
+ * Returns 0 if the count does not fit in 64 bits.
+ */
+uint64_t sweep_size(struct config_s* config)
+{
+    uint64_t size = 1;
+
+    for (int i = 0; i < SWEEP_PARAMS; i++) {
+        uint64_t steps = (config->sweep[i].steps > 1) ? config->sweep[i].steps : 1;
+        if (size > UINT64_MAX / steps) {
+            return 0;
+        }
+        size *= steps;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Evaluate every leg of a candidate over one walking period
+ * Foot targets from the gait pattern are moved by the body pose, then each is solved with IK and
+ * solved positions are checked against FK, both with the links of that leg.
+ */
+static void sweep_candidate(struct hexapod_s* hexapod, int slices, struct hpod_gait_s* gait,
+                            struct hpod_vector3_s* movement, struct hpod_body_pose_s* pose,
+                            uint32_t* ik_failures, float* max_fk_error, float* min_reach_margin)
+{
+    struct hpod_body_transform_s transform;
+    struct hpod_vector3_s feet[HPOD_MAX_LEGS];
+    struct hpod_vector3_s joints[HPOD_MAX_LEGS];
+
+    *ik_failures = 0;
+    *max_fk_error = 0.0f;
+    *min_reach_margin = INFINITY;
+
+    HPOD_body_pose_init(&transform, pose);
+
+    for (int s = 0; s < slices; s++) {
+        float phase = 2.0f * s / slices - 1.0f;
+
+        // Leg phases from the gait pattern, so the swept duty shapes each leg's stance
+        for (int leg = 0; leg < hexapod->legs; leg++) {
+            float leg_phase = HPOD_gait_pattern_phase(&gait->pattern, phase, leg);
+            HPOD_gait_calc_leg(hexapod, gait, movement, leg_phase, leg, &feet[leg]);
+        }
+
+        HPOD_body_pose_apply(hexapod, &transform, feet, joints);
+
+        for (int leg = 0; leg < hexapod->legs; leg++) {
+            const struct hpod_leg_s *l = &hexapod->leg[leg];
+            struct hpod_vector3_s* target = &joints[leg];
+
+            // Distance inside the reach envelope, as in HPOD_gait_check
+            float d = sqrtf(target->x * target->x + target->y * target->y) - l->offset_a;
+            float len_ac = sqrtf(d * d + target->z * target->z);
+            float margin = fminf(len_ac - l->kinematics.reach_min, l->kinematics.reach_max - len_ac);
+            *min_reach_margin = fminf(*min_reach_margin, margin);
+
+            float alpha, beta, theta;
+            if (HPOD_leg_ik3_n(hexapod, leg, target, &alpha, &beta, &theta) < 0) {
+                (*ik_failures)++;
+                continue;
+            }
+
+            struct hpod_vector3_s actual;
+            HPOD_leg_fk3_n(hexapod, leg, alpha, beta, theta, &actual);
+
+            float dx = actual.x - target->x, dy = actual.y - target->y, dz = actual.z - target->z;
+            *max_fk_error = fmaxf(*max_fk_error, sqrtf(dx * dx + dy * dy + dz * dz));
+        }
+    }
+}
+
+/**
+ * @brief Sweep worker thread
+ * Results are accumulated in a local chunk and stats, and written to the worker's own shard,
+ * so workers share nothing but the (read only) configuration and hexapod.
+ */
+static void* sweep_worker(void* arg)
+{
+    struct sweep_worker_s* w = (struct sweep_worker_s*)arg;
+    struct config_s* config = w->config;
+    struct sweep_stats_s stats = {0, 0, 0, 0, 0.0f, 0, INFINITY, 0};
+    float chunk[COL_COUNT][SWEEP_CHUNK_ROWS];
+    char name[FILE_NAME_MAX + 16];
+    struct colfile_s file;
+
+    snprintf(name, sizeof(name), "%s.%d", config->filename, w->id);
+
+    w->res = colfile_create(&file, name, COL_COUNT, column_names, w->end - w->begin);
+    if (w->res < 0) {
+        printf("ERROR: could not create output shard %s\r\n", name);
+        return NULL;
+    }
+
+    for (uint64_t start = w->begin; start < w->end; start += SWEEP_CHUNK_ROWS) {
+        uint32_t count = (w->end - start < SWEEP_CHUNK_ROWS) ? w->end - start : SWEEP_CHUNK_ROWS;
+
+        for (uint32_t i = 0; i < count; i++) {
+            struct hpod_gait_s gait;
+            struct hpod_vector3_s movement;
+            struct hpod_body_pose_s pose;
+            float values[SWEEP_PARAMS];
+            uint32_t ik_failures;
+            float max_fk_error, min_reach_margin;
+
+            sweep_get(config, start + i, &gait, &movement, &pose, values);
+            sweep_candidate(w->hexapod, config->slices, &gait, &movement, &pose,
+                            &ik_failures, &max_fk_error, &min_reach_margin);
+
+            for (int p = 0; p < SWEEP_PARAMS; p++) {
+                chunk[p][i] = values[p];
+            }
+            chunk[COL_IK_FAILURES][i] = ik_failures;
+            chunk[COL_MAX_FK_ERROR][i] = max_fk_error;
+            chunk[COL_MIN_REACH_MARGIN][i] = min_reach_margin;
+
+            stats.failed += (ik_failures > 0);
+            stats.ik_failures += ik_failures;
+            if (max_fk_error > stats.max_fk_error) {
+                stats.max_fk_error = max_fk_error;
+                stats.max_fk_index = start + i;
+            }
+            if (min_reach_margin < stats.min_reach_margin) {
+                stats.min_reach_margin = min_reach_margin;
+                stats.min_reach_index = start + i;
+            }
+        }
+
+        w->res = colfile_write(&file, start - w->begin, count, SWEEP_CHUNK_ROWS, &chunk[0][0]);
+        if (w->res < 0) {
+            printf("ERROR: could not write to output shard %s\r\n", name);
+            break;
+        }
+
+        stats.candidates += count;
+    }
+
+    stats.positions = stats.candidates * config->slices * w->hexapod->legs;
+    w->stats = stats;
+
+    colfile_close(&file);
+
+    return NULL;
+}
+
+/**
+ * @brief Print the parameters of a candidate
+ * Only swept parameters are shown.
+ */
+static void sweep_print_candidate(struct config_s* config, uint64_t index)
+{
+    struct hpod_gait_s gait;
+    struct hpod_vector3_s movement;
+    struct hpod_body_pose_s pose;
+    float values[SWEEP_PARAMS];
+
+    sweep_get(config, index, &gait, &movement, &pose, values);
+
+    printf("  candidate %llu:", (unsigned long long)index);
+    for (int i = 0; i < SWEEP_PARAMS; i++) {
+        if (config->sweep[i].steps > 0) {
+            printf(" %s=%.4g", sweep_param_names[i], values[i]);
+        }
+    }
+    printf("\r\n");
+}
+
+/**
+ * @brief Run a parameter sweep
+ * The candidates are split into one contiguous range per worker. Every candidate evaluates
+ * the same number of leg positions, so an even split balances the workers without any
+ * shared state, and each shard's row count is known up front. Worker w writes its results to
+ * <filename>.<w>, and the aggregate stats are printed once all workers complete.
+ * Returns 0 on success.
+ */
+int sweep_run(struct config_s* config)
+{
+    static struct sweep_worker_s workers[SWEEP_MAX_THREADS];
+    struct hexapod_s hexy;
+    struct timespec start, end;
+
+    HPOD_init(&hexy, &config->hexapod);
+
+    uint64_t size = sweep_size(config);
+    if (size == 0) {
+        printf("ERROR: sweep has too many candidates\r\n");
+        return -1;
+    }
+
+    uint64_t threads = (config->threads > 0) ? config->threads : sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (threads < 1) ? 1 : threads;
+    threads = (threads > SWEEP_MAX_THREADS) ? SWEEP_MAX_THREADS : threads;
+    threads = (threads > size) ? size : threads;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int res = 0;
+    int created = 0;
+
+    for (uint64_t i = 0; i < threads; i++) {
+        struct sweep_worker_s* w = &workers[i];
+        w->config = config;
+        w->hexapod = &hexy;
+        w->begin = size / threads * i + ((i < size % threads) ? i : size % threads);
+        w->end = w->begin + size / threads + ((i < size % threads) ? 1 : 0);
+        w->id = i;
+        w->res = 0;
+
+        if (pthread_create(&w->thread, NULL, sweep_worker, w) != 0) {
+            printf("ERROR: could not start sweep worker %d\r\n", (int)i);
+            res = -1;
+            break;
+        }
+        created++;
+    }
+
+    struct sweep_stats_s total = {0, 0, 0, 0, 0.0f, 0, INFINITY, 0};
+
+    for (int i = 0; i < created; i++) {
+        struct sweep_worker_s* w = &workers[i];
+        pthread_join(w->thread, NULL);
+
+        res |= w->res;
+        total.candidates += w->stats.candidates;
+        total.failed += w->stats.failed;
+        total.positions += w->stats.positions;
+        total.ik_failures += w->stats.ik_failures;
+        if (w->stats.max_fk_error > total.max_fk_error) {
+            total.max_fk_error = w->stats.max_fk_error;
+            total.max_fk_index = w->stats.max_fk_index;
+        }
+        if (w->stats.min_reach_margin < total.min_reach_margin) {
+            total.min_reach_margin = w->stats.min_reach_margin;
+            total.min_reach_index = w->stats.min_reach_index;
+        }
+    }
+
+    if (res < 0) {
+        return res;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    printf("Sweep of %llu candidates on %d threads in %.3f s, shards %s.0 to %s.%d\r\n",
+           (unsigned long long)total.candidates, (int)threads, elapsed,
+           config->filename, config->filename, (int)threads - 1);
+    printf("Candidates with IK failures: %llu of %llu\r\n",
+           (unsigned long long)total.failed, (unsigned long long)total.candidates);
+    printf("IK failures: %llu of %llu leg positions\r\n",
+           (unsigned long long)total.ik_failures, (unsigned long long)total.positions);
+    printf("Max FK round trip error: %.6f mm\r\n", total.max_fk_error);
+    sweep_print_candidate(config, total.max_fk_index);
+    printf("Min reach margin: %.3f mm\r\n", total.min_reach_margin);
+    sweep_print_candidate(config, total.min_reach_index);
+
+    return res;
+}
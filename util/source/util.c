@@ -12,20 +12,67 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "hexapod/gait_pattern.h"
+
+// Option values for sweep ranges, SWEEP_OPTION + sweep_param_e
+#define SWEEP_OPTION        256
+#define BASE_OPTIONS        12
+
 void print_help()
 {
     struct config_s config = DEFAULT_CONFIG;
 
     printf("\r\nLibhexapod Simulation Utility");
     printf("\r\n");
-    printf("\r\nThis runs hexapod algorithms and outputs data as a CSV for analysis\r\n");
+    printf("\r\nThis runs hexapod algorithms and outputs data as a column file (see hexfile.py) for analysis\r\n");
     printf("Arguments:\r\n");
-    printf("--file filename, file to write output to (default: %s)\r\n", config.filename);
+    printf("--file filename, column file to write output to (default: %s)\r\n", config.filename);
+    printf("--csv filename, also export the output as CSV (default: none)\r\n");
     printf("--slices N, number of slices for computation (default: %d)\r\n", config.slices);
     printf("--movement-x N, X (left/right) movement (default: %.2f)\r\n", config.movement.x);
     printf("--movement-y N, Y (forward/reverse) movement (default: %.2f)\r\n", config.movement.y);
     printf("--movement-z N, Z rotational movement (default: %.2f)\r\n", config.movement.z);
     printf("\r\n");
+    printf("Sweep mode runs every combination of the given ranges and writes per candidate results to one\r\n");
+    printf("column file shard per thread (filename.N), then prints aggregate stats\r\n");
+    printf("--threads N, sweep and profile worker threads (default: one per CPU)\r\n");
+    for (int i = 0; i < SWEEP_PARAMS; i++) {
+        printf("--sweep-%s min:max:steps, sweep range (or a single fixed value)\r\n", sweep_param_names[i]);
+    }
+    printf("\r\n");
+    printf("Profile mode samples the leg workspace, writes a heatmap of the IK / FK round trip error\r\n");
+    printf("to the output file (see heatmap.py) and prints error percentiles by workspace region\r\n");
+    printf("--profile, run the accuracy profiler\r\n");
+    printf("--profile-samples N, samples per axis (default: %d)\r\n", config.profile_samples);
+    printf("--profile-bins N, heatmap bins per axis (default: %d, max: %d)\r\n", config.profile_bins, PROFILE_MAX_BINS);
+    printf("--profile-kernel K, exact (libm IK3 / FK3) or an IK2 / FK2 kernel set, scalar (libm), x4 or x8\r\n");
+    printf("  (fast math) or auto, compared by region against exact, the heatmap is of the kernel (default: exact)\r\n");
+    printf("\r\n");
+}
+
+/**
+ * @brief Parse a sweep range, either min:max:steps or a single value
+ */
+static int parse_range(const char* arg, struct sweep_range_s* range)
+{
+    int n = sscanf(arg, "%f:%f:%d", &range->min, &range->max, &range->steps);
+
+    if (n == 1) {
+        range->max = range->min;
+        range->steps = 1;
+        return 0;
+    }
+
+    return (n == 3 && range->steps > 0) ? 0 : -1;
+}
+
+/**
+ * @brief Check a duty range lies within the gait pattern duty limits
+ */
+static int duty_valid(struct sweep_range_s* range)
+{
+    return range->min >= HPOD_GAIT_DUTY_MIN && range->min <= HPOD_GAIT_DUTY_MAX &&
+           range->max >= HPOD_GAIT_DUTY_MIN && range->max <= HPOD_GAIT_DUTY_MAX;
 }
 
 void parse_config(int argc, char** argv, struct config_s* config)
@@ -34,17 +81,28 @@ void parse_config(int argc, char** argv, struct config_s* config)
     int c;
     int option_index = 0;
 
-    // Setup options
-    static struct option long_options[] = {
+    // Setup options, sweep ranges are appended from the parameter names
+    static char sweep_options[SWEEP_PARAMS][32];
+    static struct option long_options[BASE_OPTIONS + SWEEP_PARAMS + 1] = {
         {"help", no_argument,               0, 'h'},
         {"file", required_argument,         0, 'f'},
+        {"csv", required_argument,          0, 'c'},
         {"slices", required_argument,       0, 's'},
         {"movement-x", required_argument,   0, 'x'},
         {"movement-y", required_argument,   0, 'y'},
         {"movement-z", required_argument,   0, 'z'},
-        {0, 0, 0, 0}
+        {"threads", required_argument,      0, 't'},
+        {"profile", no_argument,            0, 'p'},
+        {"profile-samples", required_argument, 0, 'n'},
+        {"profile-bins", required_argument, 0, 'b'},
+        {"profile-kernel", required_argument, 0, 'k'},
     };
 
+    for (int i = 0; i < SWEEP_PARAMS; i++) {
+        snprintf(sweep_options[i], sizeof(sweep_options[i]), "sweep-%s", sweep_param_names[i]);
+        long_options[BASE_OPTIONS + i] = (struct option) {sweep_options[i], required_argument, 0, SWEEP_OPTION + i};
+    }
+
     while (1) {
         c = getopt_long (argc, argv, "h", long_options, &option_index);
         if (c == -1) {
@@ -57,19 +115,54 @@ void parse_config(int argc, char** argv, struct config_s* config)
             exit(0);
             break;
         case 'f':
-            strncpy(config->filename, optarg, FILE_NAME_MAX);
+            strncpy(config->filename, optarg, FILE_NAME_MAX - 1);
+            break;
+        case 'c':
+            strncpy(config->csv_filename, optarg, FILE_NAME_MAX - 1);
             break;
         case 's':
             config->slices = atof(optarg);
             break;
         case 'x':
             config->movement.x = atof(optarg);
+            break;
         case 'y':
             config->movement.y = atof(optarg);
+            break;
         case 'z':
             config->movement.z = atof(optarg);
             break;
+        case 't':
+            config->threads = atoi(optarg);
+            break;
+        case 'p':
+            config->profile = 1;
+            break;
+        case 'n':
+            config->profile_samples = atoi(optarg);
+            break;
+        case 'b':
+            config->profile_bins = atoi(optarg);
+            break;
+        case 'k':
+            if (profile_kernel_parse(optarg, &config->profile_kernel) < 0) {
+                printf("Invalid kernel %s for --profile-kernel, expected exact, scalar, x4, x8 or auto\r\n", optarg);
+                exit(-1);
+            }
+            break;
         default:
+            if (c >= SWEEP_OPTION && c < SWEEP_OPTION + SWEEP_PARAMS) {
+                if (parse_range(optarg, &config->sweep[c - SWEEP_OPTION]) < 0) {
+                    printf("Invalid range %s for --%s, expected min:max:steps\r\n", optarg, sweep_options[c - SWEEP_OPTION]);
+                    exit(-1);
+                }
+                if (c == SWEEP_OPTION + SWEEP_DUTY && !duty_valid(&config->sweep[SWEEP_DUTY])) {
+                    printf("Invalid range %s for --%s, duty must be within %.2f:%.2f\r\n", optarg,
+                           sweep_options[c - SWEEP_OPTION], HPOD_GAIT_DUTY_MIN, HPOD_GAIT_DUTY_MAX);
+                    exit(-1);
+                }
+                break;
+            }
             printf("Unrecognized option %s\r\n", long_options[option_index].name);
             break;
         }